@@ -0,0 +1,665 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file moviesearch_bench.cpp
+ * @date 2025-09-23
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "generator/synthetic_dataset.h"
+#include "hyperloglog.h"
+#include "id_row_map.h"
+#include "memory_usage.h"
+#include "movie_parser.h"
+#include "rating_parser.h"
+#include "simd.h"
+#include "sort_by_member.h"
+#include "string_utils.h"
+#include "text_fold.h"
+#include "tags_parser.h"
+#include "storage/compressed_ratings.h"
+#include "Services/catalog_service.h"
+#include "Services/command_service.h"
+#include "Services/search_service.h"
+#include "indexes/facet_index.h"
+#include "indexes/rank_index.h"
+#include "indexes/tag_cooccurrence.h"
+#include "indexes/token_index.h"
+#include "indexes/user_index.h"
+
+namespace {
+
+    constexpr std::uint64_t dataset_seed = 20250923;
+    constexpr std::int64_t scales[] = { 1, 10, 100 };
+
+    // Query mixes as a user would type them after "moviesearch".
+    struct QueryMix {
+        const char* name;
+        const char* arguments;
+        std::int64_t max_scale; // largest scale the linear scan runs at
+    };
+
+    constexpr QueryMix query_mixes[] = {
+        { "title", "--title Story", 100 },
+        { "title_phrase", "--title Las Vegas", 100 },
+        { "title_quoted", "--title \"Las Vegas\"", 100 },
+        { "title_near", "--title \"Night Day\"~3", 100 },
+        { "year_genre", "--year 1995 --genre Drama", 100 },
+        { "genre_multi", "--genre Comedy Romance", 100 },
+        { "title_tag", "--title Night --tag funny", 100 },
+        { "tag", "--tag atmospheric", 100 },
+    };
+
+    std::string dataset_directory(std::int64_t scale) {
+        return "bench_data/scale_" + std::to_string(scale);
+    }
+
+    // Generated once per process so a changed generator never benchmarks stale files.
+    const std::string& dataset_for(std::int64_t scale) {
+        static std::map<std::int64_t, std::string> generated;
+        auto it = generated.find(scale);
+        if (it == generated.end()) {
+            const auto directory = dataset_directory(scale);
+            dataset_tools::generator::write_dataset(directory,
+                dataset_tools::generator::shape_for_scale(static_cast<std::size_t>(scale)), dataset_seed);
+            it = generated.emplace(scale, directory).first;
+        }
+        return it->second;
+    }
+
+    struct LoadedCatalog {
+        std::vector<movie_parser::models::Movie> movies;
+        std::vector<movie_parser::models::MovieTag> tags;   // grouped by movie row
+        shared::utils::IdRowMap row_of_movie;
+        std::vector<std::uint32_t> tag_offsets;
+        movie_search::indexes::SearchIndex index;
+    };
+
+    const LoadedCatalog& catalog_for(std::int64_t scale) {
+        static std::map<std::int64_t, LoadedCatalog> catalogs;
+        auto it = catalogs.find(scale);
+        if (it == catalogs.end()) {
+            const auto& directory = dataset_for(scale);
+            LoadedCatalog catalog;
+            catalog.movies = movie_parser::parsers::load_movies(directory + "/movies.dat");
+            catalog.tags = movie_parser::parsers::load_tags(directory + "/tags.dat");
+            catalog.row_of_movie = shared::utils::IdRowMap(catalog.movies, &movie_parser::models::Movie::movie_id);
+            catalog.tag_offsets = shared::utils::group_by_row(catalog.tags, &movie_parser::models::MovieTag::movie_id,
+                catalog.row_of_movie, catalog.movies.size());
+            catalog.index = movie_search::indexes::build_search_index(catalog.movies, catalog.tags, catalog.row_of_movie);
+            it = catalogs.emplace(scale, std::move(catalog)).first;
+        }
+        return it->second;
+    }
+
+    // Shard indexes of a catalog, built once per (scale, shard count).
+    const std::vector<movie_search::indexes::SearchIndex>& shards_for(std::int64_t scale, std::int64_t shard_count) {
+        static std::map<std::pair<std::int64_t, std::int64_t>, std::vector<movie_search::indexes::SearchIndex>> shards;
+        auto it = shards.find({ scale, shard_count });
+        if (it == shards.end()) {
+            const auto& catalog = catalog_for(scale);
+            it = shards.emplace(std::make_pair(scale, shard_count), movie_search::indexes::build_search_shards(catalog.movies,
+                catalog.tags, catalog.row_of_movie, static_cast<std::size_t>(shard_count))).first;
+        }
+        return it->second;
+    }
+
+    struct LoadedRatings {
+        std::vector<movie_parser::models::MovieRating> plain;
+        movie_parser::storage::CompressedRatings compressed;
+    };
+
+    const LoadedRatings& ratings_for(std::int64_t scale) {
+        static std::map<std::int64_t, LoadedRatings> loaded;
+        auto it = loaded.find(scale);
+        if (it == loaded.end()) {
+            LoadedRatings ratings;
+            ratings.plain = movie_parser::parsers::load_ratings(dataset_for(scale) + "/ratings.dat");
+            ratings.compressed = movie_parser::storage::CompressedRatings::build(ratings.plain);
+            it = loaded.emplace(scale, std::move(ratings)).first;
+        }
+        return it->second;
+    }
+
+    // BM25 postings of a catalog, popularity from the generated ratings.
+    const movie_search::indexes::RankIndex& ranking_for(std::int64_t scale) {
+        static std::map<std::int64_t, movie_search::indexes::RankIndex> rankings;
+        auto it = rankings.find(scale);
+        if (it == rankings.end()) {
+            const auto& catalog = catalog_for(scale);
+            const auto& ratings = ratings_for(scale).compressed;
+            std::vector<std::uint32_t> rating_counts(catalog.movies.size(), 0);
+            for (std::size_t row = 0; row < catalog.movies.size(); ++row) {
+                if (const auto block = ratings.find_movie(catalog.movies[row].movie_id)) rating_counts[row] = static_cast<std::uint32_t>(ratings.count(*block));
+            }
+            it = rankings.emplace(scale, movie_search::indexes::RankIndex(catalog.movies, catalog.tags, catalog.row_of_movie, rating_counts)).first;
+        }
+        return it->second;
+    }
+
+    movie_search::models::Query make_query(const std::string& arguments) {
+        auto tokens = moviesearch::services::tokenize_command_line(arguments);
+        return moviesearch::services::parse_moviesearch_line(tokens).query;
+    }
+
+    template <typename Loader>
+    void run_loader(benchmark::State& state, const char* file_name, Loader loader) {
+        const auto path = dataset_for(state.range(0)) + "/" + file_name;
+        std::size_t rows = 0;
+        for (auto _ : state) {
+            auto loaded = loader(path);
+            rows = loaded.size();
+            benchmark::DoNotOptimize(loaded.data());
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows));
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+    }
+
+    void BM_LoadMovies(benchmark::State& state) {
+        run_loader(state, "movies.dat", [](const std::string& path) { return movie_parser::parsers::load_movies(path); });
+    }
+
+    void BM_LoadTags(benchmark::State& state) {
+        run_loader(state, "tags.dat", [](const std::string& path) { return movie_parser::parsers::load_tags(path); });
+    }
+
+    // Same loaders with the strings in a monotonic arena sized from the file, dropped as a whole every iteration.
+    template <typename Loader>
+    void run_arena_loader(benchmark::State& state, const char* file_name, Loader loader) {
+        const auto path = dataset_for(state.range(0)) + "/" + file_name;
+        const auto file_size = std::filesystem::file_size(path);
+        std::size_t rows = 0;
+        for (auto _ : state) {
+            std::pmr::monotonic_buffer_resource arena(static_cast<std::size_t>(file_size));
+            auto loaded = loader(path, &arena);
+            rows = loaded.size();
+            benchmark::DoNotOptimize(loaded.data());
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows));
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * file_size));
+    }
+
+    void BM_LoadMoviesArena(benchmark::State& state) {
+        run_arena_loader(state, "movies.dat", [](const std::string& path, std::pmr::memory_resource* arena) {
+            return movie_parser::parsers::load_movies(path, arena);
+        });
+    }
+
+    void BM_LoadTagsArena(benchmark::State& state) {
+        run_arena_loader(state, "tags.dat", [](const std::string& path, std::pmr::memory_resource* arena) {
+            return movie_parser::parsers::load_tags(path, arena);
+        });
+    }
+
+    void BM_LoadRatings(benchmark::State& state) {
+        run_loader(state, "ratings.dat", [](const std::string& path) { return movie_parser::parsers::load_ratings(path); });
+    }
+
+    // Catalog startup up to search shards and compressed ratings: one file and index after the other, or
+    // start_loading's stages on the loader pool.
+    void BM_CatalogStartup(benchmark::State& state) {
+        const auto& directory = dataset_for(state.range(0));
+        const bool concurrent = state.range(1) != 0;
+        for (auto _ : state) {
+            movie_search::models::Catalog catalog;
+            if (concurrent) {
+                movie_search::services::start_loading(catalog, directory + "/movies.dat", directory + "/tags.dat", directory + "/ratings.dat");
+            } else {
+                movie_search::services::ensure_movies(catalog, directory + "/movies.dat");
+                movie_search::services::ensure_tags(catalog, directory + "/tags.dat");
+                movie_search::services::ensure_ratings(catalog, directory + "/ratings.dat");
+            }
+            benchmark::DoNotOptimize(movie_search::services::ensure_search_shards(catalog).data());
+            benchmark::DoNotOptimize(movie_search::services::ensure_compressed_ratings(catalog).size());
+            movie_search::services::finish_loading(catalog);
+        }
+    }
+
+    void BM_SplitMovieLine(benchmark::State& state) {
+        const std::string line = "29::City of Lost Children, The (Cite des enfants perdus, La) (1995)::Adventure|Drama|Fantasy|Mystery|Sci-Fi";
+        for (auto _ : state) {
+            auto tokens = shared::utils::split(line, "::");
+            benchmark::DoNotOptimize(tokens.data());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * line.size()));
+    }
+
+    void BM_SplitRatingLine(benchmark::State& state) {
+        const std::string line = "71567::2107::1::912580553";
+        for (auto _ : state) {
+            auto tokens = shared::utils::split(line, "::");
+            benchmark::DoNotOptimize(tokens.data());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * line.size()));
+    }
+
+    // Kernel selected by the benchmark argument (0 scalar, 1 SSE2, 2 AVX2); false when the CPU lacks it.
+    bool simd_level_arg(benchmark::State& state, shared::utils::SimdLevel& level) {
+        level = static_cast<shared::utils::SimdLevel>(state.range(0));
+        if (level > shared::utils::detected_simd_level()) {
+            state.SkipWithError("instruction set not supported by this CPU");
+            return false;
+        }
+        state.SetLabel(shared::utils::simd_level_name(level));
+        return true;
+    }
+
+    void BM_SplitFieldsMovieLine(benchmark::State& state) {
+        shared::utils::SimdLevel level;
+        if (!simd_level_arg(state, level)) return;
+        const std::string line = "29::City of Lost Children, The (Cite des enfants perdus, La) (1995)::Adventure|Drama|Fantasy|Mystery|Sci-Fi";
+        std::array<std::string_view, 3> fields;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(shared::utils::scan_fields(line, "::", fields, level));
+            benchmark::DoNotOptimize(fields.data());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * line.size()));
+    }
+
+    // Every "::" in a block of movies.dat lines.
+    void BM_FindDelimiter(benchmark::State& state) {
+        shared::utils::SimdLevel level;
+        if (!simd_level_arg(state, level)) return;
+        std::string text;
+        while (text.size() < 64 * 1024) {
+            text += std::to_string(text.size()) + "::City of Lost Children, The (Cite des enfants perdus, La) (1995)::Adventure|Drama|Fantasy\n";
+        }
+        std::size_t found = 0;
+        for (auto _ : state) {
+            found = 0;
+            for (auto pos = shared::utils::find_delimiter(text, "::", 0, level); pos != std::string_view::npos;
+                pos = shared::utils::find_delimiter(text, "::", pos + 2, level)) {
+                ++found;
+            }
+            benchmark::DoNotOptimize(found);
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+    }
+
+    void BM_CaseInsensitiveContainsWord(benchmark::State& state) {
+        const std::string title = "City of Lost Children, The (Cite des enfants perdus, La) (1995)";
+        const std::string word = state.range(0) ? "children," : "vegas";
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(shared::utils::case_insensitive_contains_word(title, word));
+        }
+    }
+
+    void BM_SearchMovies(benchmark::State& state, const QueryMix& mix) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto query = make_query(mix.arguments);
+        std::size_t matches = 0;
+        for (auto _ : state) {
+            auto results = movie_search::services::search_movies(query, catalog.movies, catalog.tags, catalog.tag_offsets);
+            matches = results.size();
+            benchmark::DoNotOptimize(results.data());
+        }
+        state.counters["matches"] = static_cast<double>(matches);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * catalog.movies.size()));
+    }
+
+    // The same queries through the resident word indexes.
+    void BM_SearchMovieRows(benchmark::State& state, const QueryMix& mix) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto query = make_query(mix.arguments);
+        std::size_t matches = 0;
+        for (auto _ : state) {
+            auto rows = movie_search::services::search_movie_rows(query, catalog.movies, catalog.index);
+            matches = rows.size();
+            benchmark::DoNotOptimize(rows.data());
+        }
+        state.counters["matches"] = static_cast<double>(matches);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * catalog.movies.size()));
+    }
+
+    // Scatter-gather over hash shards, results merged in title order.
+    void BM_SearchSharded(benchmark::State& state, const QueryMix& mix) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto& shards = shards_for(state.range(0), state.range(1));
+        auto query = make_query(mix.arguments);
+        query.sort = movie_search::models::SortOrder::title;
+        // Started outside the timed loop, like Catalog::shard_pool, which lives as long as the shards
+        std::unique_ptr<shared::utils::ThreadPool> pool;
+        if (shards.size() > 1) pool = std::make_unique<shared::utils::ThreadPool>(shards.size() - 1);
+        std::size_t matches = 0;
+        for (auto _ : state) {
+            auto rows = movie_search::services::search_movie_rows(query, catalog.movies, shards, nullptr, nullptr, pool.get());
+            matches = rows.size();
+            benchmark::DoNotOptimize(rows.data());
+        }
+        state.counters["matches"] = static_cast<double>(matches);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * catalog.movies.size()));
+    }
+
+    // Top 10 by BM25 with WAND (k = 10) against scoring every posting (k = all movies).
+    void BM_RankMovies(benchmark::State& state, const QueryMix& mix) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto& ranking = ranking_for(state.range(0));
+        auto query = make_query(mix.arguments);
+        query.rank = true;
+        query.rank_limit = state.range(1) ? 10 : catalog.movies.size();
+        const std::vector<movie_search::indexes::SearchIndex> shards{ catalog.index };
+        shared::utils::QueryCounters counters;
+        for (auto _ : state) {
+            auto results = movie_search::services::rank_movie_rows(query, catalog.movies, shards, ranking, &counters);
+            benchmark::DoNotOptimize(results.data());
+        }
+        state.counters["postings"] = benchmark::Counter(static_cast<double>(counters.rows_scanned), benchmark::Counter::kAvgIterations);
+    }
+
+    // Genre and decade counts of a result set: string genres per movie (bitmap:0) against the
+    // popcounts of the facet bitmaps (bitmap:1, which also counts the top tags).
+    void BM_FacetCounts(benchmark::State& state) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto rows = movie_search::services::search_movie_rows(make_query("--genre Comedy"), catalog.movies, catalog.index);
+        const movie_search::indexes::FacetIndex facets(catalog.movies, catalog.tags, catalog.row_of_movie);
+        for (auto _ : state) {
+            if (state.range(1)) {
+                auto counts = facets.count(rows);
+                benchmark::DoNotOptimize(counts.genres.data());
+            }
+            else {
+                std::map<std::string, std::uint32_t> genres;
+                std::map<int, std::uint32_t> decades;
+                for (const auto row : rows) {
+                    const auto& movie = catalog.movies[row];
+                    for (const auto& genre : movie.genres) ++genres[std::string(genre)];
+                    if (movie.year) ++decades[*movie.year / 10 * 10];
+                }
+                benchmark::DoNotOptimize(genres.size());
+            }
+        }
+        state.counters["results"] = static_cast<double>(rows.size());
+    }
+
+    // Movie row of every rating: hash map (dense:0) against the direct-address table (dense:1).
+    void BM_MovieRowLookup(benchmark::State& state) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto& ratings = ratings_for(state.range(0)).plain;
+        std::unordered_map<int, std::uint32_t> hashed;
+        for (std::size_t row = 0; row < catalog.movies.size(); ++row) hashed.emplace(catalog.movies[row].movie_id, static_cast<std::uint32_t>(row));
+        for (auto _ : state) {
+            std::uint64_t checksum = 0;
+            if (state.range(1)) {
+                for (const auto& rating : ratings) checksum += catalog.row_of_movie.find(rating.movie_id);
+            }
+            else {
+                for (const auto& rating : ratings) {
+                    const auto it = hashed.find(rating.movie_id);
+                    checksum += it == hashed.end() ? shared::utils::IdRowMap::npos : it->second;
+                }
+            }
+            benchmark::DoNotOptimize(checksum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ratings.size()));
+        state.counters["table_bytes"] = static_cast<double>(catalog.row_of_movie.memory_bytes());
+    }
+
+    // Movies rated by 100 users: full scan of the ratings (index:0) against the user-major CSR (index:1).
+    void BM_UserMovies(benchmark::State& state) {
+        const auto& catalog = catalog_for(state.range(0));
+        auto ratings = ratings_for(state.range(0)).plain;
+        const auto offsets = shared::utils::group_by_row(ratings, &movie_parser::models::MovieRating::movie_id,
+            catalog.row_of_movie, catalog.movies.size());
+        std::vector<int> users(ratings.size());
+        std::vector<std::uint32_t> codes(ratings.size());
+        for (std::size_t i = 0; i < ratings.size(); ++i) {
+            users[i] = ratings[i].user_id;
+            codes[i] = static_cast<std::uint32_t>(ratings[i].rating * 2.0);
+        }
+        const movie_search::indexes::UserAdjacency adjacency(users, codes, offsets);
+
+        std::size_t found = 0;
+        for (auto _ : state) {
+            found = 0;
+            for (int user = 1; user <= 100; ++user) {
+                if (state.range(1)) {
+                    const auto row = adjacency.user_row(user);
+                    if (row != shared::utils::IdRowMap::npos) found += adjacency.movie_rows(row).size();
+                }
+                else {
+                    for (const auto& rating : ratings) found += rating.user_id == user;
+                }
+            }
+            benchmark::DoNotOptimize(found);
+        }
+        state.counters["ratings_found"] = static_cast<double>(found);
+    }
+
+    // Distinct raters of every movie: a hash set per movie (sketch:0) against a HyperLogLog per movie (sketch:1).
+    void BM_DistinctRaters(benchmark::State& state) {
+        const auto& catalog = catalog_for(state.range(0));
+        auto ratings = ratings_for(state.range(0)).plain;
+        const auto offsets = shared::utils::group_by_row(ratings, &movie_parser::models::MovieRating::movie_id,
+            catalog.row_of_movie, catalog.movies.size());
+
+        double distinct = 0.0;
+        std::size_t bytes = 0;
+        for (auto _ : state) {
+            distinct = 0.0;
+            bytes = 0;
+            for (std::size_t row = 0; row < catalog.movies.size(); ++row) {
+                if (state.range(1)) {
+                    shared::utils::HyperLogLog sketch;
+                    for (auto i = offsets[row]; i < offsets[row + 1]; ++i) sketch.add(static_cast<std::uint32_t>(ratings[i].user_id));
+                    distinct += sketch.estimate();
+                    bytes += sizeof(sketch) + sketch.memory_bytes();
+                }
+                else {
+                    std::unordered_set<int> users;
+                    for (auto i = offsets[row]; i < offsets[row + 1]; ++i) users.insert(ratings[i].user_id);
+                    distinct += static_cast<double>(users.size());
+                    bytes += shared::utils::hash_map_bytes(users);
+                }
+            }
+            benchmark::DoNotOptimize(distinct);
+        }
+        state.counters["distinct_raters"] = distinct;
+        state.counters["bytes_per_movie"] = static_cast<double>(bytes) / static_cast<double>(std::max<std::size_t>(catalog.movies.size(), 1));
+    }
+
+    // Co-applied tags of 20 tags: two scans of the tag vector per tag (index:0) against rows of the
+    // tag x movie product over the incidence matrix, into a fresh cache (index:1).
+    void BM_RelatedTags(benchmark::State& state) {
+        const auto& catalog = catalog_for(state.range(0));
+        const auto matrix = movie_search::indexes::build_tag_movie_matrix(catalog.tags, catalog.tag_offsets, catalog.movies.size());
+        const auto targets = std::min<std::size_t>(20, matrix.tag_count());
+
+        std::size_t pairs = 0;
+        for (auto _ : state) {
+            pairs = 0;
+            if (state.range(1)) {
+                movie_search::indexes::TagCooccurrenceIndex index(matrix, {});
+                for (std::uint32_t tag = 0; tag < targets; ++tag) pairs += index.related(tag).size();
+            }
+            else {
+                for (std::uint32_t tag = 0; tag < targets; ++tag) {
+                    const auto target = shared::utils::fold_text(matrix.names[tag]);
+                    std::unordered_set<int> movies;
+                    for (const auto& movie_tag : catalog.tags) {
+                        if (shared::utils::folded_equal(movie_tag.tag, target)) movies.insert(movie_tag.movie_id);
+                    }
+                    std::unordered_map<std::string, std::unordered_set<int>> common;
+                    for (const auto& movie_tag : catalog.tags) {
+                        if (movies.contains(movie_tag.movie_id)) common[shared::utils::fold_text(movie_tag.tag)].insert(movie_tag.movie_id);
+                    }
+                    pairs += common.size();
+                }
+            }
+            benchmark::DoNotOptimize(pairs);
+        }
+        state.counters["pairs"] = static_cast<double>(pairs);
+    }
+
+    // Rating rows ordered by (rating desc, user, time): std::sort with a comparator (impl:0), sort_by
+    // radix passes over the integer keys (impl:1), and the threaded merge sort over the same keys (impl:2).
+    void BM_SortRatings(benchmark::State& state) {
+        const auto& ratings = ratings_for(state.range(0)).plain;
+        const auto rating = [&](std::uint32_t row) { return static_cast<int>(ratings[row].rating * 2.0f); };
+        const auto user = [&](std::uint32_t row) { return ratings[row].user_id; };
+        const auto time = [&](std::uint32_t row) { return ratings[row].timestamp; };
+
+        std::vector<std::uint32_t> rows(ratings.size());
+        for (auto _ : state) {
+            state.PauseTiming();
+            for (std::size_t i = 0; i < rows.size(); ++i) rows[i] = static_cast<std::uint32_t>(i);
+            state.ResumeTiming();
+            switch (state.range(1)) {
+            case 0:
+                std::sort(rows.begin(), rows.end(), [&](std::uint32_t a, std::uint32_t b) {
+                    if (rating(a) != rating(b)) return rating(a) > rating(b);
+                    return user(a) != user(b) ? user(a) < user(b) : time(a) < time(b);
+                });
+                break;
+            case 1:
+                shared::utils::sort_by(rows, shared::utils::descending(rating), shared::utils::ascending(user), shared::utils::ascending(time));
+                break;
+            default:
+                shared::utils::parallel_stable_sort(rows.begin(), rows.end(),
+                    shared::utils::key_order(shared::utils::descending(rating), shared::utils::ascending(user), shared::utils::ascending(time)));
+                break;
+            }
+            benchmark::DoNotOptimize(rows.data());
+        }
+        state.counters["rows"] = static_cast<double>(rows.size());
+    }
+
+    // Count and mean rating of every movie from the plain vector (hash map per row).
+    void BM_MovieAggregatesVector(benchmark::State& state) {
+        const auto& ratings = ratings_for(state.range(0));
+        for (auto _ : state) {
+            std::unordered_map<int, std::pair<std::uint32_t, double>> totals;
+            for (const auto& rating : ratings.plain) {
+                auto& [count, sum] = totals[rating.movie_id];
+                ++count;
+                sum += rating.rating;
+            }
+            benchmark::DoNotOptimize(totals.size());
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ratings.plain.size()));
+        state.counters["bytes_per_rating"] = static_cast<double>(sizeof(movie_parser::models::MovieRating));
+    }
+
+    // The same aggregates from the 4-bit rating codes of the compressed store.
+    void BM_MovieAggregatesCompressed(benchmark::State& state) {
+        const auto& ratings = ratings_for(state.range(0));
+        const auto& store = ratings.compressed;
+        for (auto _ : state) {
+            std::vector<double> means(store.movie_count());
+            for (std::size_t block = 0; block < store.movie_count(); ++block) {
+                means[block] = store.rating_sum(block) / static_cast<double>(store.count(block));
+            }
+            benchmark::DoNotOptimize(means.data());
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * store.size()));
+        state.counters["bytes_per_rating"] = static_cast<double>(store.memory_bytes()) / static_cast<double>(store.size());
+    }
+
+    // Full decode of every (user, rating, timestamp) through the block iterators.
+    void BM_CompressedDecode(benchmark::State& state) {
+        const auto& store = ratings_for(state.range(0)).compressed;
+        for (auto _ : state) {
+            long checksum = 0;
+            for (std::size_t block = 0; block < store.movie_count(); ++block) {
+                for (const auto& rating : store.movie(block)) checksum += rating.user_id + rating.timestamp;
+            }
+            benchmark::DoNotOptimize(checksum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * store.size()));
+    }
+
+    void register_benchmarks() {
+        for (auto* bench : {
+                benchmark::RegisterBenchmark("BM_LoadMovies", BM_LoadMovies),
+                benchmark::RegisterBenchmark("BM_LoadTags", BM_LoadTags),
+                benchmark::RegisterBenchmark("BM_LoadMoviesArena", BM_LoadMoviesArena),
+                benchmark::RegisterBenchmark("BM_LoadTagsArena", BM_LoadTagsArena),
+                benchmark::RegisterBenchmark("BM_LoadRatings", BM_LoadRatings) }) {
+            bench->ArgName("scale")->Unit(benchmark::kMillisecond);
+            for (auto scale : scales) bench->Arg(scale);
+        }
+
+        for (auto* bench : {
+                benchmark::RegisterBenchmark("BM_MovieAggregatesVector", BM_MovieAggregatesVector),
+                benchmark::RegisterBenchmark("BM_MovieAggregatesCompressed", BM_MovieAggregatesCompressed),
+                benchmark::RegisterBenchmark("BM_CompressedDecode", BM_CompressedDecode) }) {
+            bench->ArgName("scale")->Unit(benchmark::kMillisecond);
+            for (auto scale : scales) bench->Arg(scale);
+        }
+
+        benchmark::RegisterBenchmark("BM_CatalogStartup", BM_CatalogStartup)->ArgNames({ "scale", "concurrent" })
+            ->ArgsProduct({ { 1, 10 }, { 0, 1 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+        benchmark::RegisterBenchmark("BM_SplitMovieLine", BM_SplitMovieLine);
+        benchmark::RegisterBenchmark("BM_SplitRatingLine", BM_SplitRatingLine);
+        benchmark::RegisterBenchmark("BM_SplitFieldsMovieLine", BM_SplitFieldsMovieLine)->ArgName("simd")->DenseRange(0, 2);
+        benchmark::RegisterBenchmark("BM_FindDelimiter", BM_FindDelimiter)->ArgName("simd")->DenseRange(0, 2);
+        benchmark::RegisterBenchmark("BM_CaseInsensitiveContainsWord", BM_CaseInsensitiveContainsWord)
+            ->ArgName("hit")->Arg(0)->Arg(1);
+
+        for (const auto& mix : query_mixes) {
+            auto* bench = benchmark::RegisterBenchmark(("BM_SearchMovies/" + std::string(mix.name)).c_str(),
+                [&mix](benchmark::State& state) { BM_SearchMovies(state, mix); });
+            bench->ArgName("scale")->Unit(benchmark::kMicrosecond);
+            for (auto scale : scales) {
+                if (scale <= mix.max_scale) bench->Arg(scale);
+            }
+        }
+        for (const auto& mix : query_mixes) {
+            auto* bench = benchmark::RegisterBenchmark(("BM_SearchMovieRows/" + std::string(mix.name)).c_str(),
+                [&mix](benchmark::State& state) { BM_SearchMovieRows(state, mix); });
+            bench->ArgName("scale")->Unit(benchmark::kMicrosecond);
+            for (auto scale : scales) bench->Arg(scale);
+        }
+        benchmark::RegisterBenchmark("BM_MovieRowLookup", BM_MovieRowLookup)->ArgNames({ "scale", "dense" })
+            ->ArgsProduct({ { 1, 10, 100 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark("BM_UserMovies", BM_UserMovies)->ArgNames({ "scale", "index" })
+            ->ArgsProduct({ { 1, 10 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark("BM_DistinctRaters", BM_DistinctRaters)->ArgNames({ "scale", "sketch" })
+            ->ArgsProduct({ { 1, 10 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("BM_RelatedTags", BM_RelatedTags)->ArgNames({ "scale", "index" })
+            ->ArgsProduct({ { 1, 10 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("BM_SortRatings", BM_SortRatings)->ArgNames({ "scale", "impl" })
+            ->ArgsProduct({ { 1, 10 }, { 0, 1, 2 } })->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("BM_FacetCounts", BM_FacetCounts)->ArgNames({ "scale", "bitmap" })
+            ->ArgsProduct({ { 10, 100 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+        for (const auto& mix : query_mixes) {
+            if (std::string(mix.name) == "year_genre" || std::string(mix.name) == "genre_multi") continue; // no keywords to rank
+            auto* bench = benchmark::RegisterBenchmark(("BM_RankMovies/" + std::string(mix.name)).c_str(),
+                [&mix](benchmark::State& state) { BM_RankMovies(state, mix); });
+            bench->ArgNames({ "scale", "wand" })->Unit(benchmark::kMicrosecond);
+            for (const std::int64_t wand : { 0, 1 }) bench->Args({ 10, wand });
+        }
+        for (const auto& mix : query_mixes) {
+            auto* bench = benchmark::RegisterBenchmark(("BM_SearchSharded/" + std::string(mix.name)).c_str(),
+                [&mix](benchmark::State& state) { BM_SearchSharded(state, mix); });
+            bench->ArgNames({ "scale", "shards" })->Unit(benchmark::kMicrosecond)->UseRealTime();
+            for (const std::int64_t shards : { 1, 2, 4, 8 }) bench->Args({ 100, shards });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    benchmark::AddCustomContext("dataset_seed", std::to_string(dataset_seed));
+    benchmark::AddCustomContext("dataset_unit", "1x = 1000 movies, 1000 users, 10000 tags, 100000 ratings");
+    benchmark::AddCustomContext("dataset_distribution", "zipf popularity 1.0, activity 0.8, tags 1.1, genres 0.9");
+
+    register_benchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
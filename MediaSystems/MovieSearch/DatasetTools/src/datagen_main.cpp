@@ -0,0 +1,140 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file datagen_main.cpp
+ * @date 2025-09-24
+ */
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "cmdline_utils.h"
+#include "generator/synthetic_dataset.h"
+
+namespace {
+
+    // Movie and user ids are ints in the MovieLens files, and MovieSearch numbers rows with 32 bits.
+    constexpr std::uint64_t max_ids = std::numeric_limits<std::int32_t>::max();
+    constexpr std::uint64_t max_rows = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::uint64_t max_scale = max_rows / 100000; // ratings grow fastest: 100000 per unit
+
+    // Reads a whole unsigned number in [min, max]; signs, blanks and trailing text are rejected.
+    template <typename Count>
+    bool read_count(const std::string& option, const std::string& value, std::uint64_t min, std::uint64_t max, Count& count) {
+        std::uint64_t parsed = 0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+        if (error != std::errc() || end != value.data() + value.size() || parsed < min || parsed > max) {
+            std::cerr << "Error: " << option << " expects a whole number from " << min << " to " << max << ", got '" << value << "'\n";
+            return false;
+        }
+        count = static_cast<Count>(parsed);
+        return true;
+    }
+
+    // Reads a Zipf exponent, which must be a finite number above zero.
+    bool read_skew(const std::string& option, const std::string& value, double& skew) {
+        double parsed = 0.0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+        if (error != std::errc() || end != value.data() + value.size() || !std::isfinite(parsed) || parsed <= 0.0) {
+            std::cerr << "Error: " << option << " expects a number greater than 0, got '" << value << "'\n";
+            return false;
+        }
+        skew = parsed;
+        return true;
+    }
+
+    void show_help(std::ostream& out) {
+        out << "Usage: datagen [options]\n"
+            << "Writes a synthetic movies.dat, tags.dat and ratings.dat in MovieLens '::' format.\n"
+            << "Options:\n"
+            << "  -h, --help                  Show this help message and exit\n"
+            << "  -o, --output <dir>          Output directory (default: .)\n"
+            << "  --scale <n>                 Multiple of 1000 movies/1000 users/10000 tags/100000 ratings (default: 1)\n"
+            << "  --movies <n>                Override the number of movies\n"
+            << "  --users <n>                 Override the number of users\n"
+            << "  --tags <n>                  Override the number of tag rows\n"
+            << "  --ratings <n>               Override the number of rating rows\n"
+            << "  --seed <n>                  Seed, equal seeds give identical files (default: 1)\n"
+            << "  --popularity-skew <s>       Zipf exponent of movie popularity (default: 1.0)\n"
+            << "  --activity-skew <s>         Zipf exponent of user activity (default: 0.8)\n"
+            << "  --tag-skew <s>              Zipf exponent over the tag vocabulary (default: 1.1)\n"
+            << "  --genre-skew <s>            Zipf exponent over genres (default: 0.9)\n"
+            << "  --tag-vocabulary <n>        Number of distinct tags (default: tags / 6)\n"
+            << "\n"
+            << "Example:\n"
+            << "  datagen --output data_10x --scale 10 --seed 42\n";
+    }
+
+}
+
+/**
+ * Entry point of the dataset generator.
+ *
+ * Parses the options, applies explicit row counts on top of the scale and writes the
+ * three files. Returns 1 on invalid arguments or I/O errors.
+ */
+int main(int argc, char** argv) {
+    std::string output = ".";
+    std::size_t scale = 1;
+    dataset_tools::generator::GeneratorOptions options;
+    std::size_t movies = 0, users = 0, tags = 0, ratings = 0;
+    bool movies_set = false, users_set = false, tags_set = false, ratings_set = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            show_help(std::cout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return 1;
+        }
+        const std::string value = argv[++i];
+
+        bool ok = true;
+        if (arg == "-o" || shared::utils::matches_option(arg, "output")) output = value;
+        else if (shared::utils::matches_option(arg, "scale")) ok = read_count(arg, value, 1, max_scale, scale);
+        else if (shared::utils::matches_option(arg, "movies")) { ok = read_count(arg, value, 1, max_ids, movies); movies_set = true; }
+        else if (shared::utils::matches_option(arg, "users")) { ok = read_count(arg, value, 1, max_ids, users); users_set = true; }
+        else if (shared::utils::matches_option(arg, "tags")) { ok = read_count(arg, value, 1, max_rows, tags); tags_set = true; }
+        else if (shared::utils::matches_option(arg, "ratings")) { ok = read_count(arg, value, 1, max_rows, ratings); ratings_set = true; }
+        else if (shared::utils::matches_option(arg, "seed")) ok = read_count(arg, value, 0, std::numeric_limits<std::uint64_t>::max(), options.seed);
+        else if (shared::utils::matches_option(arg, "popularity-skew")) ok = read_skew(arg, value, options.popularity_skew);
+        else if (shared::utils::matches_option(arg, "activity-skew")) ok = read_skew(arg, value, options.activity_skew);
+        else if (shared::utils::matches_option(arg, "tag-skew")) ok = read_skew(arg, value, options.tag_skew);
+        else if (shared::utils::matches_option(arg, "genre-skew")) ok = read_skew(arg, value, options.genre_skew);
+        else if (shared::utils::matches_option(arg, "tag-vocabulary")) ok = read_count(arg, value, 1, max_rows, options.tag_vocabulary);
+        else {
+            std::cerr << "Error: Unknown option '" << arg << "'\n";
+            return 1;
+        }
+        if (!ok) return 1;
+    }
+
+    options.shape = dataset_tools::generator::shape_for_scale(scale);
+    if (movies_set) options.shape.movies = movies;
+    if (users_set) options.shape.users = users;
+    if (tags_set) options.shape.tags = tags;
+    if (ratings_set) options.shape.ratings = ratings;
+
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        dataset_tools::generator::write_dataset(output, options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Wrote " << options.shape.movies << " movies, " << options.shape.tags << " tags and "
+        << options.shape.ratings << " ratings (" << options.shape.users << " users, seed " << options.seed
+        << ") to " << output << " in " << elapsed << "s\n";
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file random.h
+ * @date 2025-09-23
+ */
+
+#include <cstdint>
+
+#include "hash_utils.h"
+
+namespace dataset_tools::generator {
+
+    /**
+     * @brief Small deterministic PRNG (SplitMix64).
+     *
+     * Used instead of the <random> distributions because those are allowed to differ
+     * between standard library implementations; generated datasets must be identical
+     * for the same seed on every platform.
+     */
+    class SplitMix64 {
+    public:
+        explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+        std::uint64_t next() {
+            return shared::utils::mix64(state_ += shared::utils::splitmix64_increment);
+        }
+
+        // Uniform value in [0, bound); bound must be > 0.
+        std::uint64_t uniform(std::uint64_t bound) {
+            return next() % bound;
+        }
+
+        // Uniform value in [low, high].
+        std::int64_t between(std::int64_t low, std::int64_t high) {
+            return low + static_cast<std::int64_t>(uniform(static_cast<std::uint64_t>(high - low + 1)));
+        }
+
+        // Uniform double in [0, 1).
+        double unit() {
+            return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+    private:
+        std::uint64_t state_;
+    };
+
+}
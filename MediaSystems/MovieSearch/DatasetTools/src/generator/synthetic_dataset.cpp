@@ -0,0 +1,273 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file synthetic_dataset.cpp
+ * @date 2025-09-23
+ */
+
+#include "synthetic_dataset.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include "random.h"
+#include "zipf_distribution.h"
+
+namespace dataset_tools::generator {
+
+    namespace
+    {
+        constexpr std::array<const char*, 19> genre_names = {
+            "Drama", "Comedy", "Thriller", "Romance", "Action", "Crime", "Adventure",
+            "Sci-Fi", "Horror", "Fantasy", "Children", "Mystery", "War", "Documentary",
+            "Musical", "Animation", "Western", "Film-Noir", "IMAX"
+        };
+
+        constexpr std::array<const char*, 48> title_words = {
+            "The", "Story", "Night", "Love", "Blood", "Las", "Vegas", "Man", "Woman", "City",
+            "Last", "Lost", "Dark", "King", "Return", "War", "Star", "Dead", "Life", "World",
+            "House", "Big", "Little", "American", "Secret", "Game", "Time", "Home", "Girl", "Boy",
+            "Death", "Dream", "Fire", "Ice", "River", "Road", "Sea", "Sky", "Summer", "Winter",
+            "Day", "Heart", "Toy", "Party", "Am\xC3\xA9lie", "Mis\xC3\xA9rables", "Caf\xC3\xA9", "No\xC3\xABl"
+        };
+
+        constexpr std::array<const char*, 32> tag_words = {
+            "funny", "atmospheric", "classic", "dark comedy", "based on a book", "twist ending",
+            "visually appealing", "sci-fi", "quirky", "surreal", "romance", "violence",
+            "politics", "satire", "hanks", "pixar", "disney", "nudity", "boring", "overrated",
+            "great soundtrack", "cult film", "stylized", "thought-provoking", "animation",
+            "action", "dystopia", "time travel", "space", "zombies", "upton", "excellent!"
+        };
+
+        // Share of each half-star value 0.5 .. 5.0 in MovieLens 10M, in percent.
+        constexpr std::array<int, 10> half_star_weights = { 1, 4, 1, 8, 4, 24, 9, 29, 8, 12 };
+
+        // MovieLens timestamps span roughly 1995-2009; a user is active for up to two years.
+        constexpr std::int64_t first_timestamp = 789652009;
+        constexpr std::int64_t last_timestamp = 1231131736;
+        constexpr std::int64_t activity_window = 2 * 365 * 24 * 3600;
+
+        std::ofstream open_output(const std::filesystem::path& path) {
+            std::ofstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("could not open " + path.string() + " for writing");
+            }
+            return file;
+        }
+
+        std::vector<std::size_t> shuffled_indices(std::size_t n, SplitMix64& rng) {
+            std::vector<std::size_t> indices(n);
+            std::iota(indices.begin(), indices.end(), std::size_t{ 0 });
+            for (std::size_t i = n; i > 1; --i) {
+                std::swap(indices[i - 1], indices[rng.uniform(i)]);
+            }
+            return indices;
+        }
+
+        std::vector<std::string> build_tag_vocabulary(std::size_t size) {
+            std::vector<std::string> vocabulary;
+            vocabulary.reserve(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                std::string tag = tag_words[i % tag_words.size()];
+                if (i >= tag_words.size()) {
+                    std::string word = title_words[(i / tag_words.size() - 1) % title_words.size()];
+                    for (auto& c : word) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                    tag += " " + word;
+                }
+                if (i >= tag_words.size() * (title_words.size() + 1)) {
+                    tag += " " + std::to_string(i);
+                }
+                vocabulary.push_back(std::move(tag));
+            }
+            return vocabulary;
+        }
+
+        // Spread total rows over users following the activity distribution, at most cap per user.
+        std::vector<std::size_t> rows_per_user(std::size_t total, std::size_t cap,
+            const ZipfDistribution& activity) {
+            const std::size_t users = activity.size();
+            if (total > users * cap) {
+                throw std::invalid_argument("more rows requested than distinct (user, movie) pairs");
+            }
+
+            std::vector<std::size_t> counts(users);
+            std::size_t assigned = 0;
+            for (std::size_t rank = 0; rank < users; ++rank) {
+                counts[rank] = std::min(cap, static_cast<std::size_t>(activity.weight(rank) * static_cast<double>(total)));
+                assigned += counts[rank];
+            }
+            for (std::size_t rank = 0; assigned < total; rank = (rank + 1) % users) {
+                if (counts[rank] < cap) {
+                    ++counts[rank];
+                    ++assigned;
+                }
+            }
+            return counts;
+        }
+
+        struct Population {
+            std::vector<int> movie_ids;                 // by movie index
+            std::vector<std::size_t> movie_by_rank;     // popularity rank -> movie index
+            std::vector<int> movie_bias;                // half-star offset per movie index
+            std::vector<std::size_t> user_by_rank;      // activity rank -> user index
+        };
+
+        Population write_movies(const std::filesystem::path& path, const GeneratorOptions& options, SplitMix64& rng) {
+            auto file = open_output(path);
+            const ZipfDistribution genre_choice(genre_names.size(), options.genre_skew);
+
+            Population population;
+            population.movie_ids.reserve(options.shape.movies);
+            population.movie_bias.reserve(options.shape.movies);
+
+            int movie_id = 0;
+            for (std::size_t i = 0; i < options.shape.movies; ++i) {
+                movie_id += 1 + static_cast<int>(rng.uniform(9));
+                population.movie_ids.push_back(movie_id);
+                population.movie_bias.push_back(static_cast<int>(rng.between(-2, 2)));
+
+                file << movie_id << "::";
+                const auto word_count = rng.between(1, 4);
+                for (std::int64_t w = 0; w < word_count; ++w) {
+                    if (w) file << ' ';
+                    file << title_words[rng.uniform(title_words.size())];
+                }
+                file << " (" << rng.between(1920, 2009) << ")::";
+
+                std::array<bool, genre_names.size()> used{};
+                const auto genre_count = rng.between(1, 3);
+                for (std::int64_t g = 0; g < genre_count; ++g) {
+                    const auto genre = genre_choice(rng);
+                    if (used[genre]) continue;
+                    if (g) file << '|';
+                    file << genre_names[genre];
+                    used[genre] = true;
+                }
+                file << '\n';
+            }
+
+            population.movie_by_rank = shuffled_indices(options.shape.movies, rng);
+            population.user_by_rank = shuffled_indices(options.shape.users, rng);
+            return population;
+        }
+
+        void write_tags(const std::filesystem::path& path, const GeneratorOptions& options,
+            const Population& population, SplitMix64& rng) {
+            auto file = open_output(path);
+            if (options.shape.tags == 0) return;
+
+            const auto vocabulary_size = options.tag_vocabulary
+                ? options.tag_vocabulary
+                : std::max<std::size_t>(tag_words.size(), options.shape.tags / 6);
+            const auto vocabulary = build_tag_vocabulary(vocabulary_size);
+            const ZipfDistribution tag_choice(vocabulary.size(), options.tag_skew);
+            const ZipfDistribution popularity(options.shape.movies, options.popularity_skew);
+            const ZipfDistribution activity(options.shape.users, options.activity_skew);
+
+            // Users may tag a movie several times, so there is no per-user cap beyond the total.
+            const auto counts = rows_per_user(options.shape.tags, options.shape.tags, activity);
+            std::vector<std::size_t> user_counts(options.shape.users);
+            for (std::size_t rank = 0; rank < counts.size(); ++rank) {
+                user_counts[population.user_by_rank[rank]] = counts[rank];
+            }
+
+            for (std::size_t user = 0; user < user_counts.size(); ++user) {
+                if (user_counts[user] == 0) continue;
+                const auto start = rng.between(first_timestamp, last_timestamp - activity_window);
+                for (std::size_t i = 0; i < user_counts[user]; ++i) {
+                    const auto movie = population.movie_by_rank[popularity(rng)];
+                    file << user + 1 << "::"
+                        << population.movie_ids[movie] << "::"
+                        << vocabulary[tag_choice(rng)] << "::"
+                        << start + rng.between(0, activity_window) << '\n';
+                }
+            }
+        }
+
+        void write_ratings(const std::filesystem::path& path, const GeneratorOptions& options,
+            const Population& population, SplitMix64& rng) {
+            auto file = open_output(path);
+            if (options.shape.ratings == 0) return;
+
+            const ZipfDistribution popularity(options.shape.movies, options.popularity_skew);
+            const ZipfDistribution activity(options.shape.users, options.activity_skew);
+
+            std::array<int, half_star_weights.size()> cumulative{};
+            std::partial_sum(half_star_weights.begin(), half_star_weights.end(), cumulative.begin());
+
+            const auto counts = rows_per_user(options.shape.ratings, options.shape.movies, activity);
+            std::vector<std::size_t> user_counts(options.shape.users);
+            for (std::size_t rank = 0; rank < counts.size(); ++rank) {
+                user_counts[population.user_by_rank[rank]] = counts[rank];
+            }
+
+            std::unordered_set<std::size_t> picked;
+            std::vector<std::size_t> movies;
+            for (std::size_t user = 0; user < user_counts.size(); ++user) {
+                const auto count = user_counts[user];
+                if (count == 0) continue;
+
+                // Distinct movies by popularity; fall back to rank order when rejection stalls.
+                picked.clear();
+                std::size_t attempts = 0;
+                while (picked.size() < count && attempts++ < 8 * count) {
+                    picked.insert(population.movie_by_rank[popularity(rng)]);
+                }
+                for (std::size_t rank = 0; picked.size() < count; ++rank) {
+                    picked.insert(population.movie_by_rank[rank]);
+                }
+                movies.assign(picked.begin(), picked.end());
+                std::sort(movies.begin(), movies.end());
+
+                const auto user_bias = rng.between(-1, 1);
+                const auto start = rng.between(first_timestamp, last_timestamp - activity_window);
+                for (const auto movie : movies) {
+                    const auto roll = static_cast<int>(rng.uniform(static_cast<std::uint64_t>(cumulative.back())));
+                    const auto base = static_cast<int>(std::upper_bound(cumulative.begin(), cumulative.end(), roll) - cumulative.begin()) + 1;
+                    const auto half_stars = std::clamp(base + population.movie_bias[movie] + static_cast<int>(user_bias), 1, 10);
+
+                    file << user + 1 << "::" << population.movie_ids[movie] << "::" << half_stars / 2;
+                    if (half_stars % 2) file << ".5";
+                    file << "::" << start + rng.between(0, activity_window) << '\n';
+                }
+            }
+        }
+    }
+
+    DatasetShape shape_for_scale(std::size_t scale) {
+        return DatasetShape{
+            1000 * scale,
+            1000 * scale,
+            10000 * scale,
+            100000 * scale
+        };
+    }
+
+    void write_dataset(const std::string& directory, const GeneratorOptions& options) {
+        if (options.shape.movies == 0 || options.shape.users == 0) {
+            throw std::invalid_argument("a dataset needs at least one movie and one user");
+        }
+
+        const std::filesystem::path root(directory);
+        std::filesystem::create_directories(root);
+
+        SplitMix64 rng(options.seed);
+        const auto population = write_movies(root / "movies.dat", options, rng);
+        write_tags(root / "tags.dat", options, population, rng);
+        write_ratings(root / "ratings.dat", options, population, rng);
+    }
+
+    void write_dataset(const std::string& directory, const DatasetShape& shape, std::uint64_t seed) {
+        GeneratorOptions options;
+        options.shape = shape;
+        options.seed = seed;
+        write_dataset(directory, options);
+    }
+
+}
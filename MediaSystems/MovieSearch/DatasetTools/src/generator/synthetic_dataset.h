@@ -0,0 +1,62 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file synthetic_dataset.h
+ * @date 2025-09-23
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dataset_tools::generator {
+
+    // Row counts of a generated dataset.
+    struct DatasetShape {
+        std::size_t movies = 0;
+        std::size_t users = 0;
+        std::size_t tags = 0;
+        std::size_t ratings = 0;
+    };
+
+    // Everything that determines the generated files; equal options give byte-identical output.
+    struct GeneratorOptions {
+        DatasetShape shape;
+        std::uint64_t seed = 1;
+        double popularity_skew = 1.0;   // Zipf exponent of how often a movie is rated/tagged
+        double activity_skew = 0.8;     // Zipf exponent of how many ratings/tags a user contributes
+        double tag_skew = 1.1;          // Zipf exponent over the tag vocabulary
+        double genre_skew = 0.9;        // Zipf exponent over the 19 MovieLens genres
+        std::size_t tag_vocabulary = 0; // distinct tag strings, 0 = derive from the tag count
+    };
+
+    /**
+     * @brief Shape of a MovieLens-like dataset at a multiple of the base unit
+     *
+     * 1x is 1,000 movies, 1,000 users, 10,000 tags and 100,000 ratings, which keeps
+     * the movie:tag:rating ratios of the MovieLens 10M files at a tenth of the size.
+     * @param scale Multiplier (1, 10, 100, ...)
+     * @return Row counts for that scale
+     */
+    DatasetShape shape_for_scale(std::size_t scale);
+
+    /**
+     * @brief Write movies.dat, tags.dat and ratings.dat in MovieLens '::' format
+     *
+     * Movie popularity, user activity, tag choice and genre choice follow Zipf
+     * distributions. Like the real files, tags.dat and ratings.dat are grouped by
+     * user and a user rates a movie at most once.
+     * @param directory Target directory (created if it does not exist)
+     * @param options Row counts, seed and distribution parameters
+     */
+    void write_dataset(const std::string& directory, const GeneratorOptions& options);
+
+    /**
+     * @brief Write a dataset with the default distribution parameters
+     * @param directory Target directory (created if it does not exist)
+     * @param shape Number of rows per file
+     * @param seed Seed; the same seed and shape always produce identical files
+     */
+    void write_dataset(const std::string& directory, const DatasetShape& shape, std::uint64_t seed);
+
+}
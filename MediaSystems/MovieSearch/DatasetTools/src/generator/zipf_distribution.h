@@ -0,0 +1,56 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file zipf_distribution.h
+ * @date 2025-09-24
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "random.h"
+
+namespace dataset_tools::generator {
+
+    /**
+     * @brief Zipf distribution over ranks [0, n): P(rank k) is proportional to 1 / (k + 1)^exponent.
+     *
+     * The cumulative weights are precomputed once, so sampling is a binary search.
+     * An exponent of 0 degenerates to a uniform distribution.
+     */
+    class ZipfDistribution {
+    public:
+        ZipfDistribution(std::size_t n, double exponent) : cumulative_(n) {
+            if (n == 0) {
+                throw std::invalid_argument("ZipfDistribution needs at least one rank");
+            }
+            double total = 0.0;
+            for (std::size_t k = 0; k < n; ++k) {
+                total += 1.0 / std::pow(static_cast<double>(k + 1), exponent);
+                cumulative_[k] = total;
+            }
+            for (auto& value : cumulative_) value /= total;
+            cumulative_.back() = 1.0;
+        }
+
+        std::size_t operator()(SplitMix64& rng) const {
+            const double u = rng.unit();
+            const auto it = std::upper_bound(cumulative_.begin(), cumulative_.end(), u);
+            return std::min(static_cast<std::size_t>(it - cumulative_.begin()), cumulative_.size() - 1);
+        }
+
+        // Probability mass of a single rank.
+        double weight(std::size_t rank) const {
+            return rank == 0 ? cumulative_[0] : cumulative_[rank] - cumulative_[rank - 1];
+        }
+
+        std::size_t size() const { return cumulative_.size(); }
+
+    private:
+        std::vector<double> cumulative_;
+    };
+
+}
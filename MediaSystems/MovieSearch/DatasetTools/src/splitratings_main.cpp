@@ -0,0 +1,167 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file splitratings_main.cpp
+ * @date 2025-09-25
+ */
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "cmdline_utils.h"
+#include "rating_parser.h"
+#include "splits/rating_folds.h"
+#include "splitting/rating_splitter.h"
+
+namespace {
+
+    // Every fold keeps a test and a train file (and their writers) open at once.
+    constexpr std::uint64_t max_folds = 100;
+    // MovieSearch numbers rating rows with 32 bits.
+    constexpr std::uint64_t max_rows = std::numeric_limits<std::uint32_t>::max();
+
+    // Reads a whole unsigned number in [min, max]; signs, blanks and trailing text are rejected.
+    std::size_t read_count(const std::string& option, const std::string& value, std::uint64_t min, std::uint64_t max) {
+        std::uint64_t parsed = 0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+        if (error != std::errc() || end != value.data() + value.size() || parsed < min || parsed > max) {
+            throw std::invalid_argument(option + " expects a whole number from " + std::to_string(min) + " to "
+                + std::to_string(max) + ", got '" + value + "'");
+        }
+        return static_cast<std::size_t>(parsed);
+    }
+
+    void show_help(std::ostream& out) {
+        out << "Usage: splitratings [options] [ratings.dat]\n"
+            << "Creates k-fold and all-but-N train/test splits in one pass (replaces split_ratings.sh).\n"
+            << "Options:\n"
+            << "  -h, --help                          Show this help message and exit\n"
+            << "  -o, --output <dir>                  Output directory (default: .)\n"
+            << "  --folds <k>                         Number of folds (0-100), 0 disables k-fold (default: 5)\n"
+            << "  --assign <position|hash>            Fold by blocks of rows or by hash of (user, movie) (default: position)\n"
+            << "  --base <name>                       Base name of the fold files (default: r)\n"
+            << "  --allbut <name> <start> <stop> <max_test>\n"
+            << "                                      allbut.pl split, may be repeated (default: ra 1 10 0, rb 11 20 0);\n"
+            << "                                      1 <= start <= stop, max_test 0 = unlimited\n"
+            << "  --no-allbut                         Skip the all-but-N splits\n"
+            << "  --dry-run                           Only report fold sizes from in-memory views, write nothing\n";
+    }
+
+    void print_dry_run(std::ostream& out, const std::string& input, const dataset_tools::splitting::SplitSpec& spec) {
+        movie_parser::parsers::ParseErrorSink errors;
+        const auto ratings = movie_parser::parsers::load_ratings(input, &errors);
+        out << "Loaded " << ratings.size() << " ratings (" << errors.count() << " skipped)\n";
+        for (const auto& error : errors.errors()) {
+            out << "  " << error.file << ":" << error.line << ": " << error.reason << "\n";
+        }
+
+        if (spec.k_fold) {
+            const auto folds = movie_parser::splits::FoldIndex::k_fold(ratings, spec.k_fold->folds, spec.k_fold->assignment);
+            for (std::size_t fold = 0; fold < folds.folds(); ++fold) {
+                out << spec.k_fold->base_name << fold + 1 << ": test " << folds.test_size(fold)
+                    << ", train " << folds.train_size(fold) << "\n";
+            }
+        }
+        for (const auto& all_but : spec.all_but) {
+            const auto split = movie_parser::splits::FoldIndex::all_but(ratings, all_but.start, all_but.stop, all_but.max_test);
+            out << all_but.base_name << ": test " << split.test_size(0) << ", train " << split.train_size(0) << "\n";
+        }
+    }
+
+}
+
+/**
+ * Entry point of the ratings splitter.
+ *
+ * Without options it produces the splits of Dataset/split_ratings.sh: r1..r5 (.test/.train) as
+ * five blocks of rows / 5 with the remainder in r5.test, and ra and rb. The files are identical,
+ * except that when rows % 5 != 0 the script's r1..r4.train repeat the remainder instead of
+ * holding the rows right after their test block. Returns 1 on invalid arguments or I/O errors.
+ */
+int main(int argc, char** argv) {
+    std::string input = "ratings.dat";
+    std::string output = ".";
+    bool dry_run = false;
+    bool default_all_but = true;
+
+    dataset_tools::splitting::SplitSpec spec;
+    dataset_tools::splitting::KFoldSpec k_fold;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto next = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                show_help(std::cout);
+                return 0;
+            }
+            else if (arg == "-o" || shared::utils::matches_option(arg, "output")) output = next();
+            else if (shared::utils::matches_option(arg, "folds")) k_fold.folds = read_count(arg, next(), 0, max_folds);
+            else if (shared::utils::matches_option(arg, "base")) k_fold.base_name = next();
+            else if (shared::utils::matches_option(arg, "assign")) {
+                const auto value = next();
+                if (value == "position") k_fold.assignment = movie_parser::splits::FoldAssignment::position;
+                else if (value == "hash") k_fold.assignment = movie_parser::splits::FoldAssignment::hash;
+                else throw std::invalid_argument("Invalid --assign value '" + value + "'");
+            }
+            else if (shared::utils::matches_option(arg, "allbut")) {
+                dataset_tools::splitting::AllButSpec all_but;
+                all_but.base_name = next();
+                all_but.start = read_count(arg + " <start>", next(), 1, max_rows);
+                all_but.stop = read_count(arg + " <stop>", next(), 1, max_rows);
+                all_but.max_test = read_count(arg + " <max_test>", next(), 0, max_rows);
+                if (all_but.start > all_but.stop) {
+                    throw std::invalid_argument(arg + " " + all_but.base_name + ": start " + std::to_string(all_but.start)
+                        + " is after stop " + std::to_string(all_but.stop));
+                }
+                spec.all_but.push_back(all_but);
+                default_all_but = false;
+            }
+            else if (shared::utils::matches_option(arg, "no-allbut")) default_all_but = false;
+            else if (shared::utils::matches_option(arg, "dry-run")) dry_run = true;
+            else if (!shared::utils::token_is_option(arg)) input = arg;
+            else throw std::invalid_argument("Unknown option '" + arg + "'");
+        }
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (k_fold.folds > 0) spec.k_fold = k_fold;
+    if (default_all_but) {
+        spec.all_but.push_back({ "ra", 1, 10, 0 });
+        spec.all_but.push_back({ "rb", 11, 20, 0 });
+    }
+
+    try {
+        if (dry_run) {
+            print_dry_run(std::cout, input, spec);
+            return 0;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto report = dataset_tools::splitting::split_ratings_file(input, output, spec);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "ratings count: " << report.rows << " (" << report.skipped << " skipped)\n";
+        for (const auto& summary : report.outputs) {
+            std::cout << summary.path << " created.  " << summary.lines << " lines.\n";
+        }
+        std::cout << "Done in " << elapsed << "s\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file async_line_writer.cpp
+ * @date 2025-09-25
+ */
+
+#include "async_line_writer.h"
+
+#include <stdexcept>
+
+namespace dataset_tools::splitting {
+
+    AsyncLineWriter::AsyncLineWriter(const std::string& path, std::size_t chunk_size, std::size_t max_pending)
+        : path_(path), file_(path, std::ios::binary), chunk_size_(chunk_size), max_pending_(max_pending) {
+        if (!file_) {
+            throw std::runtime_error("could not open " + path + " for writing");
+        }
+        buffer_.reserve(chunk_size_ + 256);
+        thread_ = std::thread(&AsyncLineWriter::run, this);
+    }
+
+    AsyncLineWriter::~AsyncLineWriter() {
+        try {
+            close();
+        }
+        catch (...) {
+            // errors are reported by an explicit close()
+        }
+    }
+
+    void AsyncLineWriter::write_line(std::string_view line) {
+        buffer_.append(line);
+        buffer_.push_back('\n');
+        ++lines_;
+        if (buffer_.size() >= chunk_size_) {
+            hand_off();
+        }
+    }
+
+    void AsyncLineWriter::hand_off() {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [this] { return pending_.size() < max_pending_; });
+        pending_.push_back(std::move(buffer_));
+        lock.unlock();
+        not_empty_.notify_one();
+
+        buffer_ = std::string();
+        buffer_.reserve(chunk_size_ + 256);
+    }
+
+    void AsyncLineWriter::run() {
+        while (true) {
+            std::string chunk;
+            {
+                std::unique_lock lock(mutex_);
+                not_empty_.wait(lock, [this] { return !pending_.empty() || closing_; });
+                if (pending_.empty()) return;
+                chunk = std::move(pending_.front());
+                pending_.pop_front();
+            }
+            not_full_.notify_one();
+
+            if (!error_) {
+                file_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                if (!file_) {
+                    error_ = std::make_exception_ptr(std::runtime_error("write to " + path_ + " failed"));
+                }
+            }
+        }
+    }
+
+    void AsyncLineWriter::close() {
+        if (closed_) return;
+        closed_ = true;
+
+        if (!buffer_.empty()) hand_off();
+        {
+            std::lock_guard lock(mutex_);
+            closing_ = true;
+        }
+        not_empty_.notify_one();
+        thread_.join();
+        file_.close();
+
+        if (error_) std::rethrow_exception(error_);
+    }
+
+}
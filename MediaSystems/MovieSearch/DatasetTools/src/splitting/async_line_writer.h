@@ -0,0 +1,70 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file async_line_writer.h
+ * @date 2025-09-25
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace dataset_tools::splitting {
+
+    /**
+     * @brief Output file with its own writer thread.
+     *
+     * Lines are collected into chunks on the calling thread; full chunks are handed to the
+     * writer thread through a small bounded queue, so the reader never waits on disk I/O
+     * unless that queue is full. Many writers together let one input pass feed all outputs.
+     */
+    class AsyncLineWriter {
+    public:
+        /**
+         * @param path File to create (truncated if it exists)
+         * @param chunk_size Bytes collected before a chunk is handed to the writer thread
+         * @param max_pending Maximum number of chunks waiting to be written
+         */
+        explicit AsyncLineWriter(const std::string& path, std::size_t chunk_size = 1 << 16, std::size_t max_pending = 8);
+        ~AsyncLineWriter();
+
+        AsyncLineWriter(const AsyncLineWriter&) = delete;
+        AsyncLineWriter& operator=(const AsyncLineWriter&) = delete;
+
+        // Append a line; a '\n' is added.
+        void write_line(std::string_view line);
+
+        // Flush the last chunk and wait for the writer thread; rethrows write errors.
+        void close();
+
+        const std::string& path() const { return path_; }
+        std::size_t lines() const { return lines_; }
+
+    private:
+        void hand_off();
+        void run();
+
+        std::string path_;
+        std::ofstream file_;
+        std::size_t chunk_size_;
+        std::size_t max_pending_;
+        std::string buffer_;
+        std::size_t lines_ = 0;
+
+        std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::deque<std::string> pending_;
+        bool closing_ = false;
+        bool closed_ = false;
+        std::exception_ptr error_;
+        std::thread thread_;
+    };
+
+}
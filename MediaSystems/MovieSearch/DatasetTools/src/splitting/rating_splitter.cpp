@@ -0,0 +1,125 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_splitter.cpp
+ * @date 2025-09-25
+ */
+
+#include "rating_splitter.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#include "rating_parser.h"
+#include "async_line_writer.h"
+
+namespace dataset_tools::splitting {
+
+    namespace
+    {
+        struct AllButOutputs {
+            movie_parser::splits::AllButSelector selector;
+            std::unique_ptr<AsyncLineWriter> test;
+            std::unique_ptr<AsyncLineWriter> train;
+        };
+
+        std::unique_ptr<AsyncLineWriter> open_writer(const std::filesystem::path& directory, const std::string& name) {
+            return std::make_unique<AsyncLineWriter>((directory / name).string());
+        }
+
+        void close_and_report(AsyncLineWriter& writer, SplitReport& report) {
+            writer.close();
+            report.outputs.push_back({ writer.path(), writer.lines() });
+        }
+
+        // Lines in a file as getline reads them (like wc -l, plus a last line without newline).
+        std::size_t count_lines(const std::string& input) {
+            std::ifstream file(input, std::ios::binary);
+            std::vector<char> buffer(1 << 20);
+            std::size_t lines = 0;
+            char last = '\n';
+            while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+                const auto end = buffer.begin() + file.gcount();
+                lines += static_cast<std::size_t>(std::count(buffer.begin(), end, '\n'));
+                last = *(end - 1);
+            }
+            return last == '\n' ? lines : lines + 1;
+        }
+    }
+
+    SplitReport split_ratings_file(const std::string& input, const std::string& output_directory, const SplitSpec& spec) {
+        std::ifstream file(input);
+        if (!file) {
+            throw std::runtime_error("could not open " + input);
+        }
+        if (spec.k_fold && spec.k_fold->folds == 0) {
+            throw std::invalid_argument("k-fold split needs at least one fold");
+        }
+
+        const std::filesystem::path directory(output_directory);
+        std::filesystem::create_directories(directory);
+
+        std::vector<std::unique_ptr<AsyncLineWriter>> fold_tests;
+        std::vector<std::unique_ptr<AsyncLineWriter>> fold_trains;
+        if (spec.k_fold) {
+            for (std::size_t fold = 1; fold <= spec.k_fold->folds; ++fold) {
+                const auto name = spec.k_fold->base_name + std::to_string(fold);
+                fold_tests.push_back(open_writer(directory, name + ".test"));
+                fold_trains.push_back(open_writer(directory, name + ".train"));
+            }
+        }
+
+        std::vector<AllButOutputs> all_but;
+        all_but.reserve(spec.all_but.size());
+        for (const auto& all_but_spec : spec.all_but) {
+            all_but.push_back({
+                movie_parser::splits::AllButSelector(all_but_spec.start, all_but_spec.stop, all_but_spec.max_test),
+                open_writer(directory, all_but_spec.base_name + ".test"),
+                open_writer(directory, all_but_spec.base_name + ".train")
+            });
+        }
+
+        // Position folds are blocks of lines / k, so the line count is needed before the first line is placed
+        const bool by_position = spec.k_fold && spec.k_fold->assignment == movie_parser::splits::FoldAssignment::position;
+        const std::size_t line_count = by_position ? count_lines(input) : 0;
+
+        SplitReport report;
+        std::string line;
+        while (std::getline(file, line)) {
+            const auto line_number = report.rows + report.skipped;
+            const auto rating = movie_parser::parsers::parse_rating_line(line);
+            if (!rating) {
+                ++report.skipped;
+                continue;
+            }
+
+            if (spec.k_fold) {
+                const auto test_fold = movie_parser::splits::assign_fold(*rating, line_number, line_count, spec.k_fold->folds,
+                    spec.k_fold->assignment);
+                for (std::size_t fold = 0; fold < fold_tests.size(); ++fold) {
+                    if (fold == test_fold) fold_tests[fold]->write_line(line);
+                    else fold_trains[fold]->write_line(line);
+                }
+            }
+            for (auto& outputs : all_but) {
+                if (outputs.selector.is_test(rating->user_id)) outputs.test->write_line(line);
+                else outputs.train->write_line(line);
+            }
+            ++report.rows;
+        }
+
+        for (std::size_t fold = 0; fold < fold_tests.size(); ++fold) {
+            close_and_report(*fold_tests[fold], report);
+            close_and_report(*fold_trains[fold], report);
+        }
+        for (auto& outputs : all_but) {
+            close_and_report(*outputs.test, report);
+            close_and_report(*outputs.train, report);
+        }
+        return report;
+    }
+
+}
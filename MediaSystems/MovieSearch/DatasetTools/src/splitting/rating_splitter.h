@@ -0,0 +1,62 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_splitter.h
+ * @date 2025-09-25
+ */
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "splits/rating_folds.h"
+
+namespace dataset_tools::splitting {
+
+    // k-fold cross-validation files <base><i>.test / <base><i>.train for i = 1..folds.
+    struct KFoldSpec {
+        std::string base_name = "r";
+        std::size_t folds = 5;
+        movie_parser::splits::FoldAssignment assignment = movie_parser::splits::FoldAssignment::position;
+    };
+
+    // allbut.pl style files <base>.test / <base>.train.
+    struct AllButSpec {
+        std::string base_name;
+        std::size_t start = 1;
+        std::size_t stop = 10;
+        std::size_t max_test = 0;
+    };
+
+    struct SplitSpec {
+        std::optional<KFoldSpec> k_fold;
+        std::vector<AllButSpec> all_but;
+    };
+
+    struct OutputSummary {
+        std::string path;
+        std::size_t lines = 0;
+    };
+
+    struct SplitReport {
+        std::size_t rows = 0;
+        std::size_t skipped = 0;
+        std::vector<OutputSummary> outputs;
+    };
+
+    /**
+     * @brief Produce every requested split from a single streaming pass over ratings.dat
+     *
+     * Each line is parsed once with the ratings parser, then copied verbatim to the
+     * outputs it belongs to. Every output file has its own writer thread. Lines that do
+     * not parse are skipped and counted. Position k-folds are blocks of lines / k, so
+     * they count the lines of the file first.
+     * @param input Path to ratings.dat
+     * @param output_directory Directory for the .test/.train files (created if needed)
+     * @param spec Which splits to produce
+     * @return Row counts per output file
+     */
+    SplitReport split_ratings_file(const std::string& input, const std::string& output_directory, const SplitSpec& spec);
+
+}
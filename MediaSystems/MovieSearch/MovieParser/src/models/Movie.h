@@ -0,0 +1,30 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file Movie.h
+ * @date 2025-09-17
+ */
+
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "memory_usage.h"
+
+namespace movie_parser::models {
+    // Title and genre strings live in the memory resource passed at construction (the catalog arena
+    // when loaded by load_movies); copies fall back to the default resource.
+    struct Movie {
+        int movie_id;
+        std::pmr::string title;
+        std::pmr::vector<std::pmr::string> genres;
+        std::optional<int> year;
+
+        Movie() = default;
+        explicit Movie(std::pmr::memory_resource* resource) : movie_id(0), title(resource), genres(resource) {}
+
+        // Bytes of the title and genre storage outside the struct (in its memory resource).
+        std::size_t memory_bytes() const { return shared::utils::string_bytes(title) + shared::utils::vector_bytes(genres); }
+    };
+}
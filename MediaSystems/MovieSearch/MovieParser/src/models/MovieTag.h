@@ -6,13 +6,22 @@
  */
 
 
+#include <memory_resource>
 #include <string>
 
+#include "memory_usage.h"
+
 namespace movie_parser::models {
 	struct MovieTag {
 	    int user_id;
 	    int movie_id;
-	    std::string tag;
+	    std::pmr::string tag;
 	    long timestamp;
+
+	    MovieTag() = default;
+	    explicit MovieTag(std::pmr::memory_resource* resource) : user_id(0), movie_id(0), tag(resource), timestamp(0) {}
+
+	    // Bytes of the tag string outside the struct (in its memory resource).
+	    std::size_t memory_bytes() const { return shared::utils::string_bytes(tag); }
 	};
 }
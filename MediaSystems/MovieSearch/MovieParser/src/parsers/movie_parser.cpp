@@ -1,9 +1,12 @@
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 
-#include "../models/Movie.h"
+#include "movie_parser.h"
 #include "string_utils.h"
 #include <ranges>
 
@@ -11,15 +14,15 @@ namespace movie_parser::parsers
 {
     namespace
     {
-        std::optional<int> extract_year(const std::string& title) {
+        std::optional<int> extract_year(std::string_view title) {
             const auto last_left_parentheses = title.find_last_of('(');
             const auto last_right_parentheses = title.find_last_of(')');
 
-            if (last_left_parentheses == std::string::npos || last_right_parentheses == std::string::npos || last_right_parentheses <= last_left_parentheses + 1) {
+            if (last_left_parentheses == std::string_view::npos || last_right_parentheses == std::string_view::npos || last_right_parentheses <= last_left_parentheses + 1) {
                 return std::nullopt; // no valid parentheses
             }
 
-            auto year_str = title.substr(last_left_parentheses + 1, last_right_parentheses - last_left_parentheses - 1);
+            const auto year_str = title.substr(last_left_parentheses + 1, last_right_parentheses - last_left_parentheses - 1);
 
             // Early return if not all digits
             if (std::ranges::any_of(year_str, [](const unsigned char c) { return !std::isdigit(c); }))
@@ -27,34 +30,43 @@ namespace movie_parser::parsers
                 return std::nullopt;
             }        
 
-            try {
-                return std::stoi(year_str);
-            }
-            catch (const std::out_of_range&) {
-                return std::nullopt; // number too large
-            }
+            int year = 0;
+            const auto [end, error] = std::from_chars(year_str.data(), year_str.data() + year_str.size(), year);
+            if (error != std::errc{}) return std::nullopt; // number too large
+            return year;
         }
     }
 
 
-    std::vector<models::Movie> load_movies(const std::string& filename) {
+    std::vector<models::Movie> load_movies(const std::string& filename, std::pmr::memory_resource* resource, ParseErrorSink* errors) {
         std::vector<models::Movie> movies;
         std::ifstream file(filename);
         std::string line;
+        std::size_t line_number = 0;
+        // Reused between lines: the fields are views into line, only title and genres are copied (into resource).
+        std::array<std::string_view, 3> fields;
+        std::vector<std::string_view> genres;
 
         while (std::getline(file, line)) {
-            auto tokens = shared::utils::split(line, "::");
-            if (tokens.size() == 3) {
-                movie_parser::models::Movie movie;
-                movie.movie_id = std::stoi(tokens[0]);
-                movie.title = tokens[1];
-                movie.genres = shared::utils::split(tokens[2], "|");
-                movie.year = extract_year(movie.title);
-                movies.push_back(movie);
+            ++line_number;
+            if (is_blank_line(line)) continue;
+            if (shared::utils::split_fields(line, "::", fields) != fields.size()) {
+                report_line(errors, filename, line_number, "expected 3 fields (id::title::genres)");
+                continue;
             }
+            movie_parser::models::Movie movie(resource);
+            if (!parse_number(fields[0], movie.movie_id)) {
+                report_line(errors, filename, line_number, "invalid movie id");
+                continue;
+            }
+            movie.title.assign(fields[1]);
+            shared::utils::split_view(fields[2], "|", genres);
+            movie.genres.reserve(genres.size());
+            for (const auto genre : genres) movie.genres.emplace_back(genre);
+            movie.year = extract_year(fields[1]);
+            movies.push_back(std::move(movie));
         }
         return movies;
     }
 
 }
-
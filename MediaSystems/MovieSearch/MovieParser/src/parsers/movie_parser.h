@@ -7,17 +7,23 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include "../models/Movie.h"
+#include "parse_errors.h"
 
 namespace movie_parser::parsers {
 
     /**
      * @brief Load movies from a MovieLens movies.dat file.
      * @param filename Path to movies.dat
+     * @param resource Memory resource for titles and genres (e.g. a monotonic arena owned by the caller,
+     *        which must outlive the returned movies)
+     * @param errors Receives malformed lines, which are skipped (null: skip silently)
      * @return Vector of Movie structs
      */
-    std::vector<movie_parser::models::Movie> load_movies(const std::string& filename);
+    std::vector<movie_parser::models::Movie> load_movies(const std::string& filename,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(), ParseErrorSink* errors = nullptr);
 
 }
\ No newline at end of file
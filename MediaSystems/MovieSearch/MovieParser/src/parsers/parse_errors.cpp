@@ -0,0 +1,31 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file parse_errors.cpp
+ * @date 2025-10-04
+ */
+
+#include "parse_errors.h"
+
+#include <utility>
+
+namespace movie_parser::parsers {
+
+    ParseFailure::ParseFailure(const ParseError& error)
+        : std::runtime_error(error.file + ":" + std::to_string(error.line) + ": " + error.reason), error_(error) {}
+
+    void ParseErrorSink::report(std::string_view file, std::size_t line, std::string_view reason) {
+        ParseError error{ std::string(file), line, std::string(reason) };
+        if (mode_ == ParseMode::strict) throw ParseFailure(error);
+        ++count_;
+        if (errors_.size() < kept_) errors_.push_back(std::move(error));
+    }
+
+    void ParseErrorSink::merge(const ParseErrorSink& other) {
+        count_ += other.count_;
+        for (const auto& error : other.errors_) {
+            if (errors_.size() >= kept_) break;
+            errors_.push_back(error);
+        }
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file parse_errors.h
+ * @date 2025-10-04
+ */
+
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace movie_parser::parsers {
+
+    enum class ParseMode {
+        skip,       // drop malformed lines and count them
+        strict      // stop at the first malformed line (ParseFailure)
+    };
+
+    // A rejected line of a dataset file.
+    struct ParseError {
+        std::string file;
+        std::size_t line;       // 1-based line number
+        std::string reason;
+    };
+
+    // Thrown by a strict sink on the first malformed line.
+    class ParseFailure : public std::runtime_error {
+    public:
+        explicit ParseFailure(const ParseError& error);
+        const ParseError& error() const { return error_; }
+
+    private:
+        ParseError error_;
+    };
+
+    /**
+     * @brief Collects malformed lines reported by the loaders.
+     *
+     * Loaders never throw on bad input themselves: they report the line here and continue. Every
+     * rejected line is counted; the first few are kept with their line number for diagnostics.
+     */
+    class ParseErrorSink {
+    public:
+        ParseErrorSink() = default;
+        explicit ParseErrorSink(ParseMode mode, std::size_t kept = 5) : mode_(mode), kept_(kept) {}
+
+        /**
+         * @brief Record a malformed line
+         * @throws ParseFailure in strict mode
+         */
+        void report(std::string_view file, std::size_t line, std::string_view reason);
+
+        /**
+         * @brief Add the lines collected by another sink (e.g. of a loader that ran on another thread)
+         */
+        void merge(const ParseErrorSink& other);
+
+        ParseMode mode() const { return mode_; }
+        std::size_t count() const { return count_; }
+        const std::vector<ParseError>& errors() const { return errors_; }
+        void clear() { count_ = 0; errors_.clear(); }
+
+    private:
+        ParseMode mode_ = ParseMode::skip;
+        std::size_t kept_ = 5;
+        std::size_t count_ = 0;
+        std::vector<ParseError> errors_;
+    };
+
+    /**
+     * @brief Parse a complete numeric field with std::from_chars (trailing '\r' and spaces allowed)
+     * @param field Field text
+     * @param value Receives the number
+     * @return False if the field is empty, not a number, out of range or has trailing characters
+     */
+    template <typename T>
+    bool parse_number(std::string_view field, T& value) {
+        while (!field.empty() && (field.back() == '\r' || field.back() == ' ')) field.remove_suffix(1);
+        const auto* last = field.data() + field.size();
+        const auto [end, error] = std::from_chars(field.data(), last, value);
+        return !field.empty() && error == std::errc{} && end == last;
+    }
+
+    // Report a line through the sink when there is one (loaders accept a null sink).
+    inline void report_line(ParseErrorSink* errors, std::string_view file, std::size_t line, std::string_view reason) {
+        if (errors) errors->report(file, line, reason);
+    }
+
+    // True for lines that carry no record (empty, or only the '\r' of a CRLF file).
+    inline bool is_blank_line(std::string_view line) {
+        return line.empty() || line == "\r";
+    }
+
+}
@@ -1,28 +1,47 @@
+#include <array>
 #include <fstream>
 #include <iostream>
 
-#include "../models/MovieRating.h"
+#include "rating_parser.h"
 #include "string_utils.h"
 
 namespace movie_parser::parsers
 {
-    std::vector<models::MovieRating> load_ratings(const std::string& filename) {
+    std::optional<models::MovieRating> parse_rating_line(std::string_view line, std::string_view* reason) {
+        const auto reject = [&](std::string_view why) -> std::optional<models::MovieRating> {
+            if (reason) *reason = why;
+            return std::nullopt;
+        };
+
+        std::array<std::string_view, 4> fields;
+        if (shared::utils::split_fields(line, "::", fields) != fields.size()) {
+            return reject("expected 4 fields (user::movie::rating::timestamp)");
+        }
+        models::MovieRating movie_rating;
+        if (!parse_number(fields[0], movie_rating.user_id)) return reject("invalid user id");
+        if (!parse_number(fields[1], movie_rating.movie_id)) return reject("invalid movie id");
+        if (!parse_number(fields[2], movie_rating.rating)) return reject("invalid rating");
+        if (!parse_number(fields[3], movie_rating.timestamp)) return reject("invalid timestamp");
+        return movie_rating;
+    }
+
+    std::vector<models::MovieRating> load_ratings(const std::string& filename, ParseErrorSink* errors) {
         std::vector<models::MovieRating> ratings;
         std::ifstream file(filename);
         std::string line;
+        std::size_t line_number = 0;
+        std::string_view reason;
 
         while (std::getline(file, line)) {
-            auto tokens = shared::utils::split(line, "::");
-            if (tokens.size() == 4) {
-                models::MovieRating movie_rating;
-                movie_rating.user_id = std::stoi(tokens[0]);
-                movie_rating.movie_id = std::stoi(tokens[1]);
-                movie_rating.rating = std::stod(tokens[2]);
-                movie_rating.timestamp = std::stol(tokens[3]);
-                ratings.push_back(movie_rating);
+            ++line_number;
+            if (is_blank_line(line)) continue;
+            if (auto movie_rating = parse_rating_line(line, &reason)) {
+                ratings.push_back(*movie_rating);
+            }
+            else {
+                report_line(errors, filename, line_number, reason);
             }
         }
         return ratings;
     }
 }
-
@@ -5,17 +5,29 @@
  * @date 2025-09-17
  */
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "../models/MovieRating.h"
+#include "parse_errors.h"
 
 namespace movie_parser::parsers {
 
+    /**
+     * @brief Parse a single line of a MovieLens ratings.dat file (never throws).
+     * @param line Line in "user::movie::rating::timestamp" format
+     * @param reason Set to why the line was rejected (optional)
+     * @return The rating, or std::nullopt if the line is malformed
+     */
+    std::optional<movie_parser::models::MovieRating> parse_rating_line(std::string_view line, std::string_view* reason = nullptr);
+
     /**
      * @brief Load ratings from a MovieLens ratings.dat file.
      * @param filename Path to ratings.dat
+     * @param errors Receives malformed lines, which are skipped (null: skip silently)
      * @return Vector of Rating structs
      */
-    std::vector<movie_parser::models::MovieRating> load_ratings(const std::string& filename);
+    std::vector<movie_parser::models::MovieRating> load_ratings(const std::string& filename, ParseErrorSink* errors = nullptr);
 
 }
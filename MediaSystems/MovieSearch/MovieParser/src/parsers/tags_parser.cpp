@@ -1,31 +1,46 @@
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 
+#include "tags_parser.h"
 #include "string_utils.h"
-#include "../models/MovieTag.h"
 
 namespace movie_parser::parsers
 {
-    std::vector<models::MovieTag> load_tags(const std::string& filename) {
+    std::vector<models::MovieTag> load_tags(const std::string& filename, std::pmr::memory_resource* resource, ParseErrorSink* errors) {
         std::vector<models::MovieTag> tags;
         std::ifstream file(filename);
         std::string line;
+        std::size_t line_number = 0;
+        std::array<std::string_view, 4> fields;
 
         while (std::getline(file, line)) {
-            auto tokens = shared::utils::split(line, "::");
-            if (tokens.size() == 4) {
-                models::MovieTag movie_tag;
-                movie_tag.user_id = std::stoi(tokens[0]);
-                movie_tag.movie_id = std::stoi(tokens[1]);
-                movie_tag.tag = tokens[2];
-                movie_tag.timestamp = std::stol(tokens[3]);
-                tags.push_back(movie_tag);
+            ++line_number;
+            if (is_blank_line(line)) continue;
+            if (shared::utils::split_fields(line, "::", fields) != fields.size()) {
+                report_line(errors, filename, line_number, "expected 4 fields (user::movie::tag::timestamp)");
+                continue;
             }
+            models::MovieTag movie_tag(resource);
+            if (!parse_number(fields[0], movie_tag.user_id)) {
+                report_line(errors, filename, line_number, "invalid user id");
+                continue;
+            }
+            if (!parse_number(fields[1], movie_tag.movie_id)) {
+                report_line(errors, filename, line_number, "invalid movie id");
+                continue;
+            }
+            if (!parse_number(fields[3], movie_tag.timestamp)) {
+                report_line(errors, filename, line_number, "invalid timestamp");
+                continue;
+            }
+            movie_tag.tag.assign(fields[2]);
+            tags.push_back(std::move(movie_tag));
         }
         return tags;
     }
 
 
 }
-
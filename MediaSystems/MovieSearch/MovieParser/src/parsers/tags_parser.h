@@ -5,17 +5,22 @@
  * @date 2025-09-17
  */
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include "../models/MovieTag.h"
+#include "parse_errors.h"
 
 namespace movie_parser::parsers {
 
     /**
      * @brief Load tags from a MovieLens tags.dat file.
      * @param filename Path to tags.dat
+     * @param resource Memory resource for the tag strings (must outlive the returned tags)
+     * @param errors Receives malformed lines, which are skipped (null: skip silently)
      * @return Vector of Tag structs
      */
-    std::vector<movie_parser::models::MovieTag> load_tags(const std::string& filename);
+    std::vector<movie_parser::models::MovieTag> load_tags(const std::string& filename,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(), ParseErrorSink* errors = nullptr);
 
 }
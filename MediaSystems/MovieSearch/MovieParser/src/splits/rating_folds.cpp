@@ -0,0 +1,91 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_folds.cpp
+ * @date 2025-09-25
+ */
+
+#include "rating_folds.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "hash_utils.h"
+
+namespace movie_parser::splits {
+
+    std::size_t assign_fold(const models::MovieRating& rating, std::size_t row, std::size_t rows, std::size_t folds,
+        FoldAssignment assignment) {
+        if (assignment == FoldAssignment::position) {
+            const auto set_size = rows / folds;
+            return set_size == 0 ? folds - 1 : std::min(row / set_size, folds - 1);
+        }
+        const auto key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(rating.user_id)) << 32)
+            | static_cast<std::uint32_t>(rating.movie_id);
+        return static_cast<std::size_t>(shared::utils::mix64(key) % folds);
+    }
+
+    AllButSelector::AllButSelector(std::size_t start, std::size_t stop, std::size_t max_test)
+        : start_(start), stop_(stop), max_test_(max_test) {
+    }
+
+    bool AllButSelector::is_test(int user_id) {
+        const auto count = ++ratings_per_user_[user_id];
+        if ((test_count_ < max_test_ || max_test_ == 0) && count >= start_ && count <= stop_) {
+            ++test_count_;
+            return true;
+        }
+        return false;
+    }
+
+    FoldIndex::FoldIndex(std::size_t folds, const std::vector<std::uint32_t>& group_of_row, std::size_t groups)
+        : folds_(folds), rows_(group_of_row.size()), offsets_(groups + 1, 0) {
+        for (const auto group : group_of_row) {
+            ++offsets_[group + 1];
+        }
+        for (std::size_t g = 0; g < groups; ++g) {
+            offsets_[g + 1] += offsets_[g];
+        }
+        auto next = offsets_;
+        for (std::size_t row = 0; row < group_of_row.size(); ++row) {
+            rows_[next[group_of_row[row]]++] = static_cast<std::uint32_t>(row);
+        }
+    }
+
+    FoldIndex FoldIndex::k_fold(const std::vector<models::MovieRating>& ratings, std::size_t folds, FoldAssignment assignment) {
+        if (folds == 0) {
+            throw std::invalid_argument("k-fold split needs at least one fold");
+        }
+        std::vector<std::uint32_t> group_of_row(ratings.size());
+        for (std::size_t row = 0; row < ratings.size(); ++row) {
+            group_of_row[row] = static_cast<std::uint32_t>(assign_fold(ratings[row], row, ratings.size(), folds, assignment));
+        }
+        return FoldIndex(folds, group_of_row, folds);
+    }
+
+    FoldIndex FoldIndex::all_but(const std::vector<models::MovieRating>& ratings, std::size_t start, std::size_t stop, std::size_t max_test) {
+        AllButSelector selector(start, stop, max_test);
+        std::vector<std::uint32_t> group_of_row(ratings.size());
+        for (std::size_t row = 0; row < ratings.size(); ++row) {
+            group_of_row[row] = selector.is_test(ratings[row].user_id) ? 0 : 1;
+        }
+        // Group 1 holds the rows that are never tested, so it only ever shows up as training data.
+        return FoldIndex(1, group_of_row, 2);
+    }
+
+    std::span<const std::uint32_t> FoldIndex::test_rows(std::size_t fold) const {
+        if (fold >= folds_) {
+            throw std::out_of_range("fold index out of range");
+        }
+        return std::span<const std::uint32_t>(rows_).subspan(offsets_[fold], offsets_[fold + 1] - offsets_[fold]);
+    }
+
+    std::array<std::span<const std::uint32_t>, 2> FoldIndex::train_rows(std::size_t fold) const {
+        const auto test = test_rows(fold);
+        const std::span<const std::uint32_t> all(rows_);
+        return {
+            all.first(offsets_[fold]),
+            all.subspan(offsets_[fold] + test.size())
+        };
+    }
+
+}
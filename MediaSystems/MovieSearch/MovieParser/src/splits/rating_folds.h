@@ -0,0 +1,103 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_folds.h
+ * @date 2025-09-25
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../models/MovieRating.h"
+
+namespace movie_parser::splits {
+
+    // How a rating row is mapped onto one of k folds.
+    enum class FoldAssignment {
+        position, // contiguous blocks of rows / k rows in file order, the remainder in the last fold
+        hash      // hash of (user, movie), independent of the file order
+    };
+
+    /**
+     * @brief Fold of a single rating row
+     *
+     * Position assignment cuts the file into blocks like Dataset/split_ratings.sh: fold i holds
+     * rows [i * (rows / k), (i + 1) * (rows / k)) and the last fold also takes the rows % k left over.
+     * @param rating The rating (used for hash assignment)
+     * @param row Zero-based row number in the ratings file (used for position assignment)
+     * @param rows Number of rows in the ratings file (used for position assignment)
+     * @param folds Number of folds (k > 0)
+     * @param assignment Assignment strategy
+     * @return Fold in [0, folds)
+     */
+    std::size_t assign_fold(const models::MovieRating& rating, std::size_t row, std::size_t rows, std::size_t folds,
+        FoldAssignment assignment);
+
+    /**
+     * @brief Streaming version of the allbut.pl rule.
+     *
+     * A row is a test row when it is the start-th up to the stop-th rating of its user
+     * (1-based, in file order) and fewer than max_test test rows were selected so far
+     * (max_test == 0 means unlimited). Call is_test exactly once per row, in file order.
+     */
+    class AllButSelector {
+    public:
+        AllButSelector(std::size_t start, std::size_t stop, std::size_t max_test);
+
+        bool is_test(int user_id);
+
+    private:
+        std::size_t start_;
+        std::size_t stop_;
+        std::size_t max_test_;
+        std::size_t test_count_ = 0;
+        std::unordered_map<int, std::size_t> ratings_per_user_;
+    };
+
+    /**
+     * @brief In-memory fold assignment over a loaded ratings vector.
+     *
+     * Row numbers are grouped per fold with a counting sort, so the test rows of a fold
+     * are one contiguous span and its training rows are the two spans around it.
+     * Nothing is copied or written to disk.
+     */
+    class FoldIndex {
+    public:
+        /**
+         * @brief Assign every row to one of k folds
+         * @param ratings Loaded ratings (row numbers refer to this vector)
+         * @param folds Number of folds (k > 0)
+         * @param assignment Assignment strategy
+         */
+        static FoldIndex k_fold(const std::vector<models::MovieRating>& ratings, std::size_t folds, FoldAssignment assignment);
+
+        /**
+         * @brief Single train/test split using the allbut.pl rule (fold 0 is the test set)
+         */
+        static FoldIndex all_but(const std::vector<models::MovieRating>& ratings, std::size_t start, std::size_t stop, std::size_t max_test);
+
+        std::size_t folds() const { return folds_; }
+        std::size_t rows() const { return rows_.size(); }
+
+        // Row numbers of the test set of a fold.
+        std::span<const std::uint32_t> test_rows(std::size_t fold) const;
+
+        // Row numbers of the training set of a fold, as the spans before and after its test rows.
+        std::array<std::span<const std::uint32_t>, 2> train_rows(std::size_t fold) const;
+
+        std::size_t test_size(std::size_t fold) const { return test_rows(fold).size(); }
+        std::size_t train_size(std::size_t fold) const { return rows_.size() - test_size(fold); }
+
+    private:
+        FoldIndex(std::size_t folds, const std::vector<std::uint32_t>& group_of_row, std::size_t groups);
+
+        std::size_t folds_ = 0;
+        std::vector<std::uint32_t> rows_;     // row numbers grouped by fold
+        std::vector<std::size_t> offsets_;    // start of every group in rows_, plus the end
+    };
+
+}
@@ -0,0 +1,177 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file compressed_ratings.cpp
+ * @date 2025-10-03
+ */
+
+#include "compressed_ratings.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <ranges>
+
+#include "sort_by_member.h"
+
+namespace movie_parser::storage {
+
+    namespace
+    {
+        std::uint64_t read_bits(const std::vector<std::uint64_t>& words, std::uint64_t bit, std::uint8_t width) {
+            if (width == 0) return 0;
+            const auto word = bit >> 6;
+            const auto shift = bit & 63;
+            auto value = words[word] >> shift;
+            if (shift + width > 64) value |= words[word + 1] << (64 - shift);
+            return width == 64 ? value : value & ((std::uint64_t{ 1 } << width) - 1);
+        }
+
+        // Appends fixed-width values to a word stream.
+        struct BitWriter {
+            std::vector<std::uint64_t>& words;
+            std::uint64_t bit = 0;
+
+            void write(std::uint64_t value, std::uint8_t width) {
+                if (width == 0) return;
+                const auto word = bit >> 6;
+                const auto shift = bit & 63;
+                if (words.size() < word + 2) words.resize(word + 2, 0);
+                words[word] |= value << shift;
+                if (shift + width > 64) words[word + 1] |= value >> (64 - shift);
+                bit += width;
+            }
+        };
+    }
+
+    CompressedRatings::Iterator::Iterator(const CompressedRatings* store, std::size_t block, std::size_t row)
+        : store_(store), row_(row), end_(store->offsets_[block + 1]),
+          user_bit_(store->user_starts_[block]), time_bit_(store->time_starts_[block]),
+          user_width_(store->user_widths_[block]), time_width_(store->time_widths_[block]),
+          time_base_(store->time_bases_[block]) {
+        decode();
+    }
+
+    void CompressedRatings::Iterator::decode() {
+        if (row_ >= end_) return;
+        const auto delta = static_cast<std::uint32_t>(read_bits(store_->user_bits_, user_bit_, user_width_));
+        user_bit_ += user_width_;
+        current_.user_id = static_cast<int>(static_cast<std::uint32_t>(current_.user_id) + delta);
+        current_.timestamp = time_base_ + static_cast<long>(read_bits(store_->time_bits_, time_bit_, time_width_));
+        time_bit_ += time_width_;
+        current_.rating = static_cast<float>(store_->code(row_)) * 0.5f;
+    }
+
+    CompressedRatings CompressedRatings::build(const std::vector<models::MovieRating>& ratings) {
+        CompressedRatings store;
+        store.rating_count_ = ratings.size();
+
+        store.movie_ids_.reserve(ratings.size() / 64 + 1);
+        for (const auto& rating : ratings) store.movie_ids_.push_back(rating.movie_id);
+        std::sort(store.movie_ids_.begin(), store.movie_ids_.end());
+        store.movie_ids_.erase(std::unique(store.movie_ids_.begin(), store.movie_ids_.end()), store.movie_ids_.end());
+        store.movie_ids_.shrink_to_fit();
+        const auto blocks = store.movie_ids_.size();
+
+        // Counting sort by movie block, then by (user, timestamp) within every block.
+        std::vector<std::uint32_t> block_of_row(ratings.size());
+        store.offsets_.assign(blocks + 1, 0);
+        for (std::size_t row = 0; row < ratings.size(); ++row) {
+            const auto block = std::lower_bound(store.movie_ids_.begin(), store.movie_ids_.end(), ratings[row].movie_id) - store.movie_ids_.begin();
+            block_of_row[row] = static_cast<std::uint32_t>(block);
+            ++store.offsets_[block + 1];
+        }
+        std::partial_sum(store.offsets_.begin(), store.offsets_.end(), store.offsets_.begin());
+
+        std::vector<std::uint32_t> order(ratings.size());
+        auto next = store.offsets_;
+        for (std::size_t row = 0; row < ratings.size(); ++row) order[next[block_of_row[row]]++] = static_cast<std::uint32_t>(row);
+
+        store.user_starts_.resize(blocks);
+        store.user_widths_.resize(blocks);
+        store.time_starts_.resize(blocks);
+        store.time_widths_.resize(blocks);
+        store.time_bases_.resize(blocks);
+        store.rating_codes_.assign((ratings.size() + 1) / 2, 0);
+        BitWriter users{ store.user_bits_ };
+        BitWriter times{ store.time_bits_ };
+
+        for (std::size_t block = 0; block < blocks; ++block) {
+            const auto first = order.begin() + store.offsets_[block];
+            const auto last = order.begin() + store.offsets_[block + 1];
+            shared::utils::sort_by(std::ranges::subrange(first, last),
+                shared::utils::ascending([&](std::uint32_t row) { return ratings[row].user_id; }),
+                shared::utils::ascending([&](std::uint32_t row) { return ratings[row].timestamp; }));
+
+            std::uint32_t previous_user = 0;
+            std::uint32_t max_delta = 0;
+            long min_time = ratings[*first].timestamp;
+            long max_time = min_time;
+            for (auto it = first; it != last; ++it) {
+                const auto user = static_cast<std::uint32_t>(ratings[*it].user_id);
+                max_delta = std::max(max_delta, user - previous_user);
+                previous_user = user;
+                min_time = std::min(min_time, ratings[*it].timestamp);
+                max_time = std::max(max_time, ratings[*it].timestamp);
+            }
+
+            store.user_widths_[block] = static_cast<std::uint8_t>(std::bit_width(max_delta));
+            store.time_widths_[block] = static_cast<std::uint8_t>(std::bit_width(static_cast<std::uint64_t>(max_time - min_time)));
+            store.time_bases_[block] = min_time;
+            store.user_starts_[block] = users.bit;
+            store.time_starts_[block] = times.bit;
+
+            previous_user = 0;
+            auto row = static_cast<std::size_t>(store.offsets_[block]);
+            for (auto it = first; it != last; ++it, ++row) {
+                const auto& rating = ratings[*it];
+                const auto user = static_cast<std::uint32_t>(rating.user_id);
+                users.write(user - previous_user, store.user_widths_[block]);
+                previous_user = user;
+                times.write(static_cast<std::uint64_t>(rating.timestamp - min_time), store.time_widths_[block]);
+
+                const auto doubled = rating.rating * 2.0;
+                const auto code = static_cast<std::uint8_t>(std::clamp(std::lround(doubled), 0L, 15L));
+                if (static_cast<double>(code) != doubled) store.lossless_ = false;
+                store.rating_codes_[row >> 1] |= static_cast<std::uint8_t>(code << ((row & 1) * 4));
+            }
+        }
+
+        // One spare word so a read that straddles the last word never runs past the end.
+        store.user_bits_.resize((users.bit >> 6) + 2, 0);
+        store.time_bits_.resize((times.bit >> 6) + 2, 0);
+        store.user_bits_.shrink_to_fit();
+        store.time_bits_.shrink_to_fit();
+        return store;
+    }
+
+    std::optional<std::size_t> CompressedRatings::find_movie(int movie_id) const {
+        const auto it = std::lower_bound(movie_ids_.begin(), movie_ids_.end(), movie_id);
+        if (it == movie_ids_.end() || *it != movie_id) return std::nullopt;
+        return static_cast<std::size_t>(it - movie_ids_.begin());
+    }
+
+    CompressedRatings::MovieView CompressedRatings::movie(std::size_t block) const {
+        return MovieView(Iterator(this, block, offsets_[block]), Iterator(this, block, offsets_[block + 1]), count(block));
+    }
+
+    double CompressedRatings::rating_sum(std::size_t block) const {
+        std::uint64_t doubled = 0;
+        for (auto row = static_cast<std::size_t>(offsets_[block]); row < offsets_[block + 1]; ++row) doubled += code(row);
+        return static_cast<double>(doubled) * 0.5;
+    }
+
+    std::array<std::uint32_t, 16> CompressedRatings::rating_histogram(std::size_t block) const {
+        std::array<std::uint32_t, 16> histogram{};
+        for (auto row = static_cast<std::size_t>(offsets_[block]); row < offsets_[block + 1]; ++row) ++histogram[code(row)];
+        return histogram;
+    }
+
+    std::size_t CompressedRatings::memory_bytes() const {
+        return movie_ids_.size() * sizeof(int) + offsets_.size() * sizeof(std::uint32_t)
+            + user_bits_.size() * sizeof(std::uint64_t) + user_starts_.size() * sizeof(std::uint64_t) + user_widths_.size()
+            + time_bits_.size() * sizeof(std::uint64_t) + time_starts_.size() * sizeof(std::uint64_t) + time_widths_.size()
+            + time_bases_.size() * sizeof(long) + rating_codes_.size();
+    }
+
+}
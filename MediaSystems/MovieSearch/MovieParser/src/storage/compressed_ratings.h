@@ -0,0 +1,140 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file compressed_ratings.h
+ * @date 2025-10-03
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+#include "../models/MovieRating.h"
+
+namespace movie_parser::storage {
+
+    // A rating decoded from the compressed store (the movie is implied by the block).
+    struct DecodedRating {
+        int user_id;
+        float rating;
+        long timestamp;
+    };
+
+    /**
+     * @brief Columnar, compressed copy of a ratings vector.
+     *
+     * Rows are sorted by (movie, user) and grouped in one block per movie. Per block:
+     *  - user ids are delta-encoded and bit-packed with the width of the largest delta;
+     *  - timestamps are stored as bit-packed offsets from the block minimum (frame of reference);
+     *  - ratings are 4-bit codes (rating * 2), two per byte, so half stars 0.0 .. 7.5 are exact.
+     * Blocks are decoded on the fly by MovieView iterators; count/sum/histogram aggregates only
+     * touch the rating codes.
+     */
+    class CompressedRatings {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = DecodedRating;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const DecodedRating*;
+            using reference = const DecodedRating&;
+
+            Iterator() = default;
+
+            reference operator*() const { return current_; }
+            pointer operator->() const { return &current_; }
+            Iterator& operator++() { ++row_; decode(); return *this; }
+            Iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+            bool operator==(const Iterator& other) const { return row_ == other.row_; }
+
+        private:
+            friend class CompressedRatings;
+            Iterator(const CompressedRatings* store, std::size_t block, std::size_t row);
+            void decode();
+
+            const CompressedRatings* store_ = nullptr;
+            std::size_t row_ = 0;
+            std::size_t end_ = 0;
+            std::uint64_t user_bit_ = 0;
+            std::uint64_t time_bit_ = 0;
+            std::uint8_t user_width_ = 0;
+            std::uint8_t time_width_ = 0;
+            long time_base_ = 0;
+            DecodedRating current_{};
+        };
+
+        // The ratings of one movie, decoded while iterating.
+        class MovieView {
+        public:
+            Iterator begin() const { return begin_; }
+            Iterator end() const { return end_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            friend class CompressedRatings;
+            MovieView(Iterator begin, Iterator end, std::size_t size) : begin_(begin), end_(end), size_(size) {}
+            Iterator begin_;
+            Iterator end_;
+            std::size_t size_;
+        };
+
+        /**
+         * @brief Sort and compress ratings
+         * @param ratings Parsed ratings in any order
+         * @return The compressed store
+         */
+        static CompressedRatings build(const std::vector<models::MovieRating>& ratings);
+
+        std::size_t size() const { return rating_count_; }
+        std::size_t movie_count() const { return movie_ids_.size(); }
+        int movie_id(std::size_t block) const { return movie_ids_[block]; }
+        std::size_t count(std::size_t block) const { return offsets_[block + 1] - offsets_[block]; }
+
+        /**
+         * @brief Block of a movie id (binary search over the sorted movie ids)
+         */
+        std::optional<std::size_t> find_movie(int movie_id) const;
+
+        MovieView movie(std::size_t block) const;
+
+        /**
+         * @brief Sum of the ratings of a block, computed from the 4-bit codes only
+         */
+        double rating_sum(std::size_t block) const;
+
+        /**
+         * @brief Number of ratings per code (code / 2 is the rating) in a block
+         */
+        std::array<std::uint32_t, 16> rating_histogram(std::size_t block) const;
+
+        // Bytes held by the compressed columns.
+        std::size_t memory_bytes() const;
+
+        // False when a rating was not a multiple of 0.5 in [0, 7.5] and had to be rounded.
+        bool lossless() const { return lossless_; }
+
+    private:
+        std::uint8_t code(std::size_t row) const { return (rating_codes_[row >> 1] >> ((row & 1) * 4)) & 0x0F; }
+
+        std::size_t rating_count_ = 0;
+        bool lossless_ = true;
+        std::vector<int> movie_ids_;                // sorted, one per block
+        std::vector<std::uint32_t> offsets_;        // first row of every block, plus the end
+
+        std::vector<std::uint64_t> user_bits_;      // delta-encoded user ids
+        std::vector<std::uint64_t> user_starts_;    // first bit of every block
+        std::vector<std::uint8_t> user_widths_;
+
+        std::vector<std::uint64_t> time_bits_;      // timestamp - block minimum
+        std::vector<std::uint64_t> time_starts_;
+        std::vector<std::uint8_t> time_widths_;
+        std::vector<long> time_bases_;
+
+        std::vector<std::uint8_t> rating_codes_;    // two 4-bit codes per byte
+    };
+
+}
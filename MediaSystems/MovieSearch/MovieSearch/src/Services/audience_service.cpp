@@ -0,0 +1,75 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file audience_service.cpp
+ * @date 2025-10-04
+ */
+
+#include "audience_service.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "catalog_service.h"
+#include "sort_by_member.h"
+#include "text_fold.h"
+
+namespace movie_search::services {
+
+    namespace
+    {
+        std::uint64_t rounded(double estimate) {
+            return static_cast<std::uint64_t>(std::llround(estimate));
+        }
+    }
+
+    void run_audience_stats(std::ostream& out, models::Catalog& catalog, const std::vector<std::string>& arguments) {
+        if (arguments.size() != 1) {
+            out << "Error: stats expects at most one movie id\n";
+            return;
+        }
+
+        int movie_id = 0;
+        try {
+            movie_id = std::stoi(arguments.front());
+        }
+        catch (...) {
+            out << "Error: Invalid movie id: '" << arguments.front() << "'\n";
+            return;
+        }
+
+        ensure_tags(catalog);
+        ensure_ratings(catalog);
+        const auto row = catalog.row_of_movie.find(movie_id);
+        if (row == shared::utils::IdRowMap::npos) {
+            out << "No movie with id " << movie_id << "\n";
+            return;
+        }
+
+        const auto distinct_users = ensure_distinct_users(catalog);
+        const auto& movie = catalog.movies[row];
+        out << movie.movie_id << "::" << movie.title << ": ~" << distinct_users[row] << " distinct users ("
+            << rounded(catalog.movie_raters[row].estimate()) << " raters, "
+            << rounded(catalog.movie_taggers[row].estimate()) << " taggers)\n";
+
+        // Each tag once (by folded text), most widely used first
+        struct TagAudience {
+            std::string_view tag;
+            std::uint64_t taggers;
+        };
+        std::vector<std::string> seen;
+        std::vector<TagAudience> tags;
+        for (const auto& tag : movie_tags(catalog, row)) {
+            auto folded = shared::utils::fold_text(tag.tag);
+            if (std::find(seen.begin(), seen.end(), folded) != seen.end()) continue;
+            const auto sketch = catalog.tag_taggers.find(folded);
+            tags.push_back({ tag.tag, sketch == catalog.tag_taggers.end() ? 0 : rounded(sketch->second.estimate()) });
+            seen.push_back(std::move(folded));
+        }
+        shared::utils::sort_by(tags, shared::utils::descending(&TagAudience::taggers), shared::utils::ascending(&TagAudience::tag));
+        for (const auto& tag : tags) {
+            out << "  " << tag.tag << ": ~" << tag.taggers << " distinct taggers\n";
+        }
+    }
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file audience_service.h
+ * @date 2025-10-04
+ */
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    /**
+     * @brief Handle "stats <movie_id>"
+     *
+     * Prints the estimated number of distinct users who rated the movie, who tagged it, and who
+     * did either, then every tag of the movie with the estimated distinct taggers of that tag over
+     * all movies. The counts come from the HyperLogLog sketches built at load (about 6.5% error).
+     *
+     * @param out Output stream
+     * @param catalog The resident catalog (tags and ratings are loaded if needed)
+     * @param arguments Tokens after the leading "stats" token
+     */
+    void run_audience_stats(std::ostream& out, models::Catalog& catalog, const std::vector<std::string>& arguments);
+
+}
@@ -0,0 +1,360 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file catalog_service.cpp
+ * @date 2025-09-29
+ */
+
+#include "catalog_service.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+#include "date_utils.h"
+#include "movie_parser.h"
+#include "rating_parser.h"
+#include "tags_parser.h"
+#include "text_fold.h"
+
+namespace movie_search::services {
+
+    namespace
+    {
+        // One sketch of the users of each movie row; records are grouped by row (see group_by_row).
+        std::vector<shared::utils::HyperLogLog> sketch_users(const std::vector<int>& users,
+            const std::vector<std::uint32_t>& offsets, std::size_t rows) {
+            std::vector<shared::utils::HyperLogLog> sketches(rows);
+            for (std::size_t row = 0; row < rows; ++row) {
+                for (auto record = offsets[row]; record < offsets[row + 1]; ++record) {
+                    sketches[row].add(static_cast<std::uint32_t>(users[record]));
+                }
+            }
+            return sketches;
+        }
+
+        // The strings of a dataset take roughly its file size, so the first arena block covers most of it.
+        std::unique_ptr<shared::utils::CountedArena> make_arena(const std::string& filename) {
+            std::error_code error;
+            const auto size = std::filesystem::file_size(filename, error);
+            const auto initial = error ? std::size_t{ 64 * 1024 } : std::max<std::size_t>(static_cast<std::size_t>(size), 1024);
+            return std::make_unique<shared::utils::CountedArena>(initial);
+        }
+
+        // The load steps below run on the calling thread (ensure_*) or as startup stages (start_loading).
+
+        void read_movies(models::Catalog& catalog, const std::string& filename, movie_parser::parsers::ParseErrorSink* errors) {
+            catalog.movies.clear();
+            catalog.movie_arena = make_arena(filename);
+            catalog.movies = movie_parser::parsers::load_movies(filename, catalog.movie_arena->resource(), errors);
+            catalog.row_of_movie = shared::utils::IdRowMap(catalog.movies, &movie_parser::models::Movie::movie_id);
+            catalog.movies_loaded = true;
+        }
+
+        void read_tags(models::Catalog& catalog, const std::string& filename, movie_parser::parsers::ParseErrorSink* errors) {
+            catalog.tags.clear();
+            catalog.tag_arena = make_arena(filename);
+            catalog.tags = movie_parser::parsers::load_tags(filename, catalog.tag_arena->resource(), errors);
+        }
+
+        // Needs the movies.
+        void group_tags(models::Catalog& catalog) {
+            catalog.tag_offsets = shared::utils::group_by_row(catalog.tags, &movie_parser::models::MovieTag::movie_id,
+                catalog.row_of_movie, catalog.movies.size());
+
+            std::vector<int> users(catalog.tags.size());
+            std::vector<std::uint32_t> tag_ids(catalog.tags.size());
+            for (std::size_t tag = 0; tag < catalog.tags.size(); ++tag) {
+                users[tag] = catalog.tags[tag].user_id;
+                tag_ids[tag] = static_cast<std::uint32_t>(tag);
+            }
+            catalog.user_tags = indexes::UserAdjacency(users, tag_ids, catalog.tag_offsets);
+
+            catalog.movie_taggers = sketch_users(users, catalog.tag_offsets, catalog.movies.size());
+            catalog.tag_taggers.clear();
+            for (const auto& tag : catalog.tags) {
+                catalog.tag_taggers[shared::utils::fold_text(tag.tag)].add(static_cast<std::uint32_t>(tag.user_id));
+            }
+            catalog.tag_movies = indexes::build_tag_movie_matrix(catalog.tags, catalog.tag_offsets, catalog.movies.size());
+            catalog.tags_loaded = true;
+        }
+
+        void read_ratings(models::Catalog& catalog, const std::string& filename, movie_parser::parsers::ParseErrorSink* errors) {
+            catalog.ratings = movie_parser::parsers::load_ratings(filename, errors);
+        }
+
+        // Needs the movies.
+        void group_ratings(models::Catalog& catalog) {
+            catalog.rating_offsets = shared::utils::group_by_row(catalog.ratings, &movie_parser::models::MovieRating::movie_id,
+                catalog.row_of_movie, catalog.movies.size());
+
+            std::vector<int> users(catalog.ratings.size());
+            std::vector<std::uint32_t> codes(catalog.ratings.size());
+            for (std::size_t rating = 0; rating < catalog.ratings.size(); ++rating) {
+                users[rating] = catalog.ratings[rating].user_id;
+                codes[rating] = static_cast<std::uint32_t>(std::clamp(std::lround(catalog.ratings[rating].rating * 2.0), 0L, 255L));
+            }
+            catalog.user_ratings = indexes::UserAdjacency(users, codes, catalog.rating_offsets);
+            catalog.movie_raters = sketch_users(users, catalog.rating_offsets, catalog.movies.size());
+            catalog.ratings_loaded = true;
+        }
+
+        // Wait for a startup stage, if there is one; rethrows its failure (e.g. a strict parse error).
+        void await(const std::shared_future<void>& stage) {
+            if (!stage.valid()) return;
+            const auto copy = stage;    // every thread waits through its own copy
+            copy.get();
+        }
+
+        // Wait for the stage that loads a file and hand its malformed lines to the catalog sink.
+        void await(const std::shared_future<void>& stage, movie_parser::parsers::ParseErrorSink& stage_errors,
+            movie_parser::parsers::ParseErrorSink& errors) {
+            if (!stage.valid()) return;
+            await(stage);
+            errors.merge(stage_errors);
+            stage_errors.clear();
+        }
+    }
+
+    void start_loading(models::Catalog& catalog, const std::string& movies_file, const std::string& tags_file,
+        const std::string& ratings_file) {
+        finish_loading(catalog);
+        auto& stages = catalog.loading;
+        const auto mode = catalog.parse_errors.mode();
+        stages.movie_errors = movie_parser::parsers::ParseErrorSink(mode);
+        stages.tag_errors = movie_parser::parsers::ParseErrorSink(mode);
+        stages.rating_errors = movie_parser::parsers::ParseErrorSink(mode);
+
+        // At least one worker per file, so the three reads overlap even on a small machine
+        catalog.loader = std::make_unique<shared::utils::ThreadPool>(std::max(std::thread::hardware_concurrency(), 3u));
+        auto& pool = *catalog.loader;
+        auto* target = &catalog;
+
+        stages.movies = pool.submit([=] { read_movies(*target, movies_file, &target->loading.movie_errors); });
+        stages.tags_read = pool.submit([=] { read_tags(*target, tags_file, &target->loading.tag_errors); });
+        stages.ratings_read = pool.submit([=] { read_ratings(*target, ratings_file, &target->loading.rating_errors); });
+
+        stages.tags = pool.submit([=] { group_tags(*target); }, { stages.movies, stages.tags_read });
+        stages.ratings = pool.submit([=] { group_ratings(*target); }, { stages.movies, stages.ratings_read });
+
+        stages.search_shards = pool.submit([=] {
+            target->search_shards = indexes::build_search_shards(target->movies, target->tags, target->row_of_movie,
+                target->search_shard_count);
+        }, { stages.tags });
+        stages.compressed_ratings = pool.submit([=] {
+            target->compressed_ratings = movie_parser::storage::CompressedRatings::build(target->ratings);
+        }, { stages.ratings });
+    }
+
+    void finish_loading(models::Catalog& catalog) {
+        catalog.loader.reset();     // runs the remaining stages and joins the workers
+    }
+
+    void ensure_movies(models::Catalog& catalog, const std::string& filename) {
+        await(catalog.loading.movies, catalog.loading.movie_errors, catalog.parse_errors);
+        if (catalog.movies_loaded) return;
+        read_movies(catalog, filename, &catalog.parse_errors);
+    }
+
+    void ensure_tags(models::Catalog& catalog, const std::string& filename) {
+        ensure_movies(catalog);
+        await(catalog.loading.tags, catalog.loading.tag_errors, catalog.parse_errors);
+        if (catalog.tags_loaded) return;
+        read_tags(catalog, filename, &catalog.parse_errors);
+        group_tags(catalog);
+    }
+
+    void ensure_ratings(models::Catalog& catalog, const std::string& filename) {
+        ensure_movies(catalog);
+        await(catalog.loading.ratings, catalog.loading.rating_errors, catalog.parse_errors);
+        if (catalog.ratings_loaded) return;
+        read_ratings(catalog, filename, &catalog.parse_errors);
+        group_ratings(catalog);
+    }
+
+    std::span<const movie_parser::models::MovieTag> movie_tags(const models::Catalog& catalog, std::size_t row) {
+        if (catalog.tag_offsets.empty()) return {};
+        return std::span(catalog.tags).subspan(catalog.tag_offsets[row], catalog.tag_offsets[row + 1] - catalog.tag_offsets[row]);
+    }
+
+    std::span<const movie_parser::models::MovieRating> movie_ratings(const models::Catalog& catalog, std::size_t row) {
+        if (catalog.rating_offsets.empty()) return {};
+        return std::span(catalog.ratings).subspan(catalog.rating_offsets[row], catalog.rating_offsets[row + 1] - catalog.rating_offsets[row]);
+    }
+
+    std::span<const std::uint32_t> ensure_distinct_users(models::Catalog& catalog) {
+        if (catalog.distinct_users.empty()) {
+            ensure_tags(catalog);
+            ensure_ratings(catalog);
+            catalog.distinct_users.resize(catalog.movies.size());
+            for (std::size_t row = 0; row < catalog.movies.size(); ++row) {
+                auto users = catalog.movie_raters[row];
+                users.merge(catalog.movie_taggers[row]);
+                catalog.distinct_users[row] = static_cast<std::uint32_t>(std::lround(users.estimate()));
+            }
+        }
+        return catalog.distinct_users;
+    }
+
+    const std::vector<indexes::SearchIndex>& ensure_search_shards(models::Catalog& catalog) {
+        ensure_tags(catalog);
+        await(catalog.loading.search_shards);
+        if (catalog.search_shards.empty()) {
+            catalog.search_shards = indexes::build_search_shards(catalog.movies, catalog.tags, catalog.row_of_movie,
+                catalog.search_shard_count);
+        }
+        if (!catalog.shard_pool && catalog.search_shards.size() > 1) {
+            catalog.shard_pool = std::make_unique<shared::utils::ThreadPool>(catalog.search_shards.size() - 1);
+        }
+        return catalog.search_shards;
+    }
+
+    const indexes::RankIndex& ensure_rank_index(models::Catalog& catalog) {
+        if (!catalog.rank_index) {
+            ensure_movies(catalog);
+            ensure_tags(catalog);
+            const auto& ratings = ensure_compressed_ratings(catalog);
+            std::vector<std::uint32_t> rating_counts(catalog.movies.size(), 0);
+            for (std::size_t row = 0; row < catalog.movies.size(); ++row) {
+                if (const auto block = ratings.find_movie(catalog.movies[row].movie_id)) {
+                    rating_counts[row] = static_cast<std::uint32_t>(ratings.count(*block));
+                }
+            }
+            catalog.rank_index.emplace(catalog.movies, catalog.tags, catalog.row_of_movie, rating_counts);
+        }
+        return *catalog.rank_index;
+    }
+
+    const indexes::FacetIndex& ensure_facet_index(models::Catalog& catalog) {
+        if (!catalog.facet_index) {
+            ensure_movies(catalog);
+            ensure_tags(catalog);
+            catalog.facet_index.emplace(catalog.movies, catalog.tags, catalog.row_of_movie);
+        }
+        return *catalog.facet_index;
+    }
+
+    const movie_parser::storage::CompressedRatings& ensure_compressed_ratings(models::Catalog& catalog) {
+        ensure_ratings(catalog);
+        await(catalog.loading.compressed_ratings);
+        if (!catalog.compressed_ratings) {
+            catalog.compressed_ratings = movie_parser::storage::CompressedRatings::build(catalog.ratings);
+        }
+        return *catalog.compressed_ratings;
+    }
+
+    const indexes::RatingMatrix& ensure_rating_matrix(models::Catalog& catalog) {
+        if (!catalog.rating_matrix) {
+            ensure_movies(catalog);
+            ensure_ratings(catalog);
+            catalog.rating_matrix = indexes::build_rating_matrix(catalog.ratings, catalog.row_of_movie, catalog.movies.size());
+        }
+        return *catalog.rating_matrix;
+    }
+
+    indexes::ItemSimilarityIndex& similarity_index(models::Catalog& catalog, indexes::SimilarityMeasure measure) {
+        auto& index = catalog.similarity[static_cast<std::size_t>(measure)];
+        if (!index) {
+            indexes::SimilarityOptions options;
+            options.measure = measure;
+            index = std::make_unique<indexes::ItemSimilarityIndex>(ensure_rating_matrix(catalog), options);
+        }
+        return *index;
+    }
+
+    indexes::TagCooccurrenceIndex& related_tags_index(models::Catalog& catalog, indexes::TagAssociation measure) {
+        auto& index = catalog.related_tags[static_cast<std::size_t>(measure)];
+        if (!index) {
+            ensure_tags(catalog);
+            indexes::TagCooccurrenceOptions options;
+            options.measure = measure;
+            index = std::make_unique<indexes::TagCooccurrenceIndex>(catalog.tag_movies, options);
+        }
+        return *index;
+    }
+
+    const recommender::CandidatePool& ensure_candidate_pool(models::Catalog& catalog) {
+        if (!catalog.candidate_pool) {
+            const auto& matrix = ensure_rating_matrix(catalog);
+            catalog.candidate_pool = std::make_unique<recommender::CandidatePool>(catalog.movies, matrix);
+        }
+        return *catalog.candidate_pool;
+    }
+
+    const indexes::TimeBucketIndex& ensure_rating_times(models::Catalog& catalog) {
+        if (!catalog.rating_times) {
+            ensure_movies(catalog);
+            ensure_ratings(catalog);
+            std::vector<indexes::TimeEvent> events;
+            events.reserve(catalog.ratings.size());
+            for (std::size_t row = 0; row < catalog.movies.size(); ++row) {
+                for (const auto& rating : movie_ratings(catalog, row)) {
+                    events.push_back({ static_cast<std::uint32_t>(row), shared::utils::day_of_timestamp(rating.timestamp),
+                        static_cast<float>(rating.rating) });
+                }
+            }
+            catalog.rating_times.emplace(catalog.movies.size(), events);
+        }
+        return *catalog.rating_times;
+    }
+
+    const indexes::TimeBucketIndex& ensure_tag_times(models::Catalog& catalog) {
+        if (!catalog.tag_times) {
+            ensure_movies(catalog);
+            ensure_tags(catalog);
+            std::vector<indexes::TimeEvent> events;
+            events.reserve(catalog.tags.size());
+            for (std::size_t row = 0; row < catalog.movies.size(); ++row) {
+                for (const auto& tag : movie_tags(catalog, row)) {
+                    events.push_back({ static_cast<std::uint32_t>(row), shared::utils::day_of_timestamp(tag.timestamp), 0.0f });
+                }
+            }
+            catalog.tag_times.emplace(catalog.movies.size(), events);
+        }
+        return *catalog.tag_times;
+    }
+
+    void reload_catalog(models::Catalog& catalog) {
+        // Nothing may still be writing into the catalog.
+        const bool background = catalog.loader != nullptr;
+        finish_loading(catalog);
+        // Indexes refer to the datasets, so they go first.
+        catalog.candidate_pool.reset();
+        catalog.similarity = {};
+        catalog.related_tags = {};
+        catalog.rating_matrix.reset();
+        // Then the datasets, while their arenas are still alive.
+        catalog.movies = {};
+        catalog.tags = {};
+        const auto mode = catalog.parse_errors.mode();
+        const auto shard_count = catalog.search_shard_count;
+        catalog = models::Catalog{};
+        catalog.parse_errors = movie_parser::parsers::ParseErrorSink(mode);
+        catalog.search_shard_count = shard_count;
+        if (background) {
+            start_loading(catalog);
+            return;
+        }
+        ensure_movies(catalog);
+        ensure_tags(catalog);
+    }
+
+    void report_parse_errors(std::ostream& out, models::Catalog& catalog) {
+        // Only the parsing of the files is waited for; grouping and indexing stay in the background
+        auto& stages = catalog.loading;
+        await(stages.movies, stages.movie_errors, catalog.parse_errors);
+        await(stages.tags_read, stages.tag_errors, catalog.parse_errors);
+        await(stages.ratings_read, stages.rating_errors, catalog.parse_errors);
+
+        auto& sink = catalog.parse_errors;
+        if (sink.count() == 0) return;
+        out << "Warning: skipped " << sink.count() << " malformed line" << (sink.count() == 1 ? "" : "s") << "\n";
+        for (const auto& error : sink.errors()) {
+            out << "  " << error.file << ":" << error.line << ": " << error.reason << "\n";
+        }
+        if (sink.count() > sink.errors().size()) out << "  ...\n";
+        sink.clear();
+    }
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file catalog_service.h
+ * @date 2025-09-29
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <string>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    /**
+     * @brief Start loading the datasets and building the main indexes in the background
+     *
+     * The three files are parsed concurrently on a thread pool; grouping the tags and ratings by
+     * movie (and user), the search shards and the compressed ratings run as soon as their inputs
+     * are ready. Returns immediately: every ensure_* below waits only for the stage it needs.
+     * report_parse_errors waits for the parsing, so malformed lines (or a strict-mode failure)
+     * surface before the next command whichever files it uses.
+     *
+     * @param catalog The resident catalog (search_shard_count and the parse mode must be set)
+     */
+    void start_loading(models::Catalog& catalog, const std::string& movies_file = "movies.dat",
+        const std::string& tags_file = "tags.dat", const std::string& ratings_file = "ratings.dat");
+
+    /**
+     * @brief Wait until every startup stage has finished (failures are dropped) and stop the pool
+     */
+    void finish_loading(models::Catalog& catalog);
+
+    /**
+     * @brief Load movies.dat into the catalog unless it is loaded already
+     * @param catalog The resident catalog
+     * @param filename Path to movies.dat
+     */
+    void ensure_movies(models::Catalog& catalog, const std::string& filename = "movies.dat");
+
+    /**
+     * @brief Load tags.dat into the catalog unless it is loaded already, grouped by movie row,
+     *        indexed by user and as a tag x movie matrix (loads movies if needed)
+     */
+    void ensure_tags(models::Catalog& catalog, const std::string& filename = "tags.dat");
+
+    /**
+     * @brief Load ratings.dat into the catalog unless it is loaded already, grouped by movie row and
+     *        indexed by user (loads movies if needed)
+     */
+    void ensure_ratings(models::Catalog& catalog, const std::string& filename = "ratings.dat");
+
+    /**
+     * @brief Tags of a movie row (tags are grouped by movie at load; empty if they are not loaded)
+     */
+    std::span<const movie_parser::models::MovieTag> movie_tags(const models::Catalog& catalog, std::size_t row);
+
+    /**
+     * @brief Ratings of a movie row (ratings are grouped by movie at load; empty if they are not loaded)
+     */
+    std::span<const movie_parser::models::MovieRating> movie_ratings(const models::Catalog& catalog, std::size_t row);
+
+    /**
+     * @brief Estimated distinct users (raters or taggers) per movie row: the union of the movie's
+     *        rater and tagger sketches, computed once (loads tags and ratings if needed)
+     */
+    std::span<const std::uint32_t> ensure_distinct_users(models::Catalog& catalog);
+
+    /**
+     * @brief Word indexes over titles, genres and tags for moviesearch, one per shard of the movies
+     *        (catalog.search_shard_count; loads movies and tags if needed)
+     * @return The shard indexes
+     */
+    const std::vector<indexes::SearchIndex>& ensure_search_shards(models::Catalog& catalog);
+
+    /**
+     * @brief BM25 postings over title and tag words, weighted by rating counts (loads movies, tags and
+     *        ratings if needed)
+     * @return The rank index
+     */
+    const indexes::RankIndex& ensure_rank_index(models::Catalog& catalog);
+
+    /**
+     * @brief Genre, decade and top-tag bitmaps for result facets (loads movies and tags if needed)
+     * @return The facet index
+     */
+    const indexes::FacetIndex& ensure_facet_index(models::Catalog& catalog);
+
+    /**
+     * @brief Compressed columnar copy of the ratings (loads ratings if needed)
+     * @return The compressed store
+     */
+    const movie_parser::storage::CompressedRatings& ensure_compressed_ratings(models::Catalog& catalog);
+
+    /**
+     * @brief Pack the ratings into the CSR/CSC rating matrix (loads movies and ratings if needed)
+     * @return The rating matrix
+     */
+    const indexes::RatingMatrix& ensure_rating_matrix(models::Catalog& catalog);
+
+    /**
+     * @brief Similarity index for a measure, created on first use (lists are filled lazily)
+     * @return The similarity index
+     */
+    indexes::ItemSimilarityIndex& similarity_index(models::Catalog& catalog, indexes::SimilarityMeasure measure);
+
+    /**
+     * @brief Related-tag index for a measure, created on first use (lists are filled lazily; loads
+     *        tags if needed)
+     * @return The co-occurrence index
+     */
+    indexes::TagCooccurrenceIndex& related_tags_index(models::Catalog& catalog, indexes::TagAssociation measure);
+
+    /**
+     * @brief Seen sets and candidate buckets for recommend, built on first use
+     * @return The candidate pool
+     */
+    const recommender::CandidatePool& ensure_candidate_pool(models::Catalog& catalog);
+
+    /**
+     * @brief Day/month buckets of the ratings, built on first use
+     */
+    const indexes::TimeBucketIndex& ensure_rating_times(models::Catalog& catalog);
+
+    /**
+     * @brief Day/month buckets of the tags, built on first use
+     */
+    const indexes::TimeBucketIndex& ensure_tag_times(models::Catalog& catalog);
+
+    /**
+     * @brief Drop everything loaded so far and load movies and tags again (all datasets in the
+     *        background if start_loading was used)
+     */
+    void reload_catalog(models::Catalog& catalog);
+
+    /**
+     * @brief Wait until the startup stages have parsed every file, then print the malformed lines
+     *        skipped since the last report as warnings and forget them
+     * @param out Output stream
+     * @param catalog The resident catalog (its parse error sink)
+     * @throws movie_parser::parsers::ParseFailure if a file failed to parse in strict mode
+     */
+    void report_parse_errors(std::ostream& out, models::Catalog& catalog);
+
+}
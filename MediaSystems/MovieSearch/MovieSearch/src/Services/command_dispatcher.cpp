@@ -0,0 +1,81 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file command_dispatcher.cpp
+ * @date 2025-10-04
+ */
+
+#include "command_dispatcher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace movie_search::services {
+
+    namespace
+    {
+        bool finished(const std::shared_future<void>& done) {
+            return done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        std::shared_future<void> already_done() {
+            std::promise<void> promise;
+            promise.set_value();
+            return promise.get_future().share();
+        }
+    }
+
+    CommandDispatcher::CommandDispatcher(const DispatchLimits& limits) : limits_(limits) {
+        if (limits_.workers) pool_ = std::make_unique<shared::utils::ThreadPool>(limits_.workers);
+    }
+
+    CommandDispatcher::~CommandDispatcher() {
+        cancel_all();
+    }
+
+    bool CommandDispatcher::submit(std::shared_ptr<shared::utils::QueryDeadline> deadline, std::function<void()> work,
+        std::function<void()> finish) {
+        if (!pool_) {
+            work();
+            finish();
+            return true;
+        }
+        if (in_flight() >= limits_.workers + limits_.queue_capacity) return false;
+
+        pending_.push_back({ pool_->submit(std::move(work)), std::move(deadline), std::move(finish) });
+        return true;
+    }
+
+    void CommandDispatcher::post(std::function<void()> finish) {
+        if (pending_.empty()) {
+            finish();
+            return;
+        }
+        pending_.push_back({ already_done(), nullptr, std::move(finish) });
+    }
+
+    void CommandDispatcher::flush(bool wait) {
+        while (!pending_.empty() && (wait || finished(pending_.front().done))) {
+            // Pop first: a failed command rethrows from get() and must not be finished again
+            auto command = std::move(pending_.front());
+            pending_.pop_front();
+            command.done.get();
+            command.finish();
+        }
+    }
+
+    std::size_t CommandDispatcher::cancel_all() {
+        std::size_t cancelled = 0;
+        for (auto& command : pending_) {
+            if (!command.deadline || finished(command.done)) continue;
+            command.deadline->cancel();
+            ++cancelled;
+        }
+        return cancelled;
+    }
+
+    std::size_t CommandDispatcher::in_flight() const {
+        return static_cast<std::size_t>(std::count_if(pending_.begin(), pending_.end(),
+            [](const Pending& command) { return !finished(command.done); }));
+    }
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file command_dispatcher.h
+ * @date 2025-10-04
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "deadline.h"
+#include "thread_pool.h"
+
+namespace movie_search::services {
+
+    // Admission limits of the command loop (--workers, --queue, --timeout).
+    struct DispatchLimits {
+        std::size_t workers = 0;                // searches running at once; 0 runs them inline
+        std::size_t queue_capacity = 16;        // searches waiting for a worker before new ones are shed
+        std::chrono::milliseconds timeout{ 0 }; // per search, from admission (after loading); 0 = none
+    };
+
+    /**
+     * @brief Runs searches on a bounded set of workers and prints their output in command order.
+     *
+     * A command is split into work, which runs on a worker, and finish, which runs on the command
+     * thread once the work and every earlier command are done (so output never interleaves and
+     * finish may touch the catalog and instrumentation). At most workers + queue_capacity commands
+     * are in flight; submit sheds anything beyond that instead of queueing it. Without workers,
+     * submit runs work and finish right away.
+     */
+    class CommandDispatcher {
+    public:
+        explicit CommandDispatcher(const DispatchLimits& limits);
+
+        // Cancels what is still in flight; the output of unfinished commands is dropped.
+        ~CommandDispatcher();
+
+        CommandDispatcher(const CommandDispatcher&) = delete;
+        CommandDispatcher& operator=(const CommandDispatcher&) = delete;
+
+        /**
+         * @brief Admit a command
+         * @param deadline Deadline of the command, cancelled by cancel_all
+         * @param work Runs on a worker (reads the catalog only)
+         * @param finish Runs on the command thread, in submission order
+         * @return false when the command was shed (neither work nor finish runs)
+         */
+        bool submit(std::shared_ptr<shared::utils::QueryDeadline> deadline, std::function<void()> work,
+            std::function<void()> finish);
+
+        /**
+         * @brief Run finish in order after every earlier command, without any work (e.g. an error message)
+         */
+        void post(std::function<void()> finish);
+
+        /**
+         * @brief Run the finish step of finished commands, in submission order
+         * @param wait Wait for every admitted command instead of stopping at the first unfinished one
+         */
+        void flush(bool wait);
+
+        /**
+         * @brief Cancel the deadline of every command that has not finished yet
+         * @return Number of commands cancelled
+         */
+        std::size_t cancel_all();
+
+        // Commands running or waiting for a worker.
+        std::size_t in_flight() const;
+
+        const DispatchLimits& limits() const { return limits_; }
+
+    private:
+        struct Pending {
+            std::shared_future<void> done;
+            std::shared_ptr<shared::utils::QueryDeadline> deadline;
+            std::function<void()> finish;
+        };
+
+        DispatchLimits limits_;
+        std::deque<Pending> pending_;
+        std::unique_ptr<shared::utils::ThreadPool> pool_;
+    };
+
+}
@@ -30,9 +30,71 @@ namespace moviesearch::services {
                 parse_result.errors.push_back("Missing value for --" + command_name);
                 return;
             }
-            parsed_values.insert(parsed_values.end(), vals.begin(), vals.end());
+            for (auto& value : vals) {
+                if (value.find('"') == std::string::npos) {
+                    parsed_values.push_back(std::move(value));
+                    continue;
+                }
+                // Tags and genres match word by word, so "w1 w2" means the words w1 and w2
+                if (value.size() < 2 || value.front() != '"' || value.back() != '"' || value.find('"', 1) != value.size() - 1) {
+                    parse_result.errors.push_back("Invalid quoted value for --" + command_name + ": " + value);
+                    continue;
+                }
+                std::istringstream words(value.substr(1, value.size() - 2));
+                const auto before = parsed_values.size();
+                for (std::string word; words >> word;) parsed_values.push_back(word);
+                if (parsed_values.size() == before) parse_result.warnings.push_back("Ignoring empty value for --" + command_name + ": " + value);
+            }
         }
 
+	    // A quoted title value: "w1 w2 ..." or "w1 w2 ..."~N. One word without ~N is a plain keyword.
+	    void handle_title_phrase(movie_search::models::Query& query, const std::string& value, movie_search::models::ParseResult& parse_result) {
+	        const auto close = value.find('"', 1);
+	        if (close == std::string::npos) {
+	            parse_result.errors.push_back("Unterminated quote in --title value: " + value);
+	            return;
+	        }
+	        movie_search::models::Phrase phrase;
+	        const auto suffix = value.substr(close + 1);
+	        if (!suffix.empty()) {
+	            if (suffix.size() < 2 || suffix[0] != '~' || !std::all_of(suffix.begin() + 1, suffix.end(), [](unsigned char c) { return std::isdigit(c); })) {
+	                parse_result.errors.push_back("Invalid phrase suffix '" + suffix + "' (expected ~N)");
+	                return;
+	            }
+	            try {
+	                phrase.slop = static_cast<std::size_t>(std::stoul(suffix.substr(1)));
+	            }
+	            catch (...) {
+	                parse_result.errors.push_back("Invalid phrase distance: '" + suffix.substr(1) + "'");
+	                return;
+	            }
+	        }
+	        std::istringstream words(value.substr(1, close - 1));
+	        for (std::string word; words >> word;) phrase.words.push_back(word);
+
+	        if (phrase.words.empty()) {
+	            parse_result.warnings.push_back("Ignoring empty phrase: " + value);
+	        }
+	        else if (phrase.words.size() == 1) {
+	            query.titles.push_back(phrase.words.front());
+	        }
+	        else if (std::find(query.title_phrases.begin(), query.title_phrases.end(), phrase) == query.title_phrases.end()) {
+	            query.title_phrases.push_back(std::move(phrase));
+	        }
+	    }
+
+	    void handle_title_option(movie_search::models::Query& query, const std::vector<std::string>& args, std::size_t& i, movie_search::models::ParseResult& parse_result) {
+	        auto vals = shared::utils::collect_value_tokens(args, i);
+	        if (vals.empty()) {
+	            parse_result.errors.emplace_back("Missing value for --title");
+	            return;
+	        }
+	        for (auto& value : vals) {
+	            if (value.front() == '"') handle_title_phrase(query, value, parse_result);
+	            else query.titles.push_back(std::move(value));
+	        }
+	    }
+
 	    void handle_year_option(movie_search::models::Query& query, const std::vector<std::string>& args, std::size_t& i, movie_search::models::ParseResult& parse_result) {
 	        auto vals = shared::utils::collect_value_tokens(args, i);
 	        if (vals.empty()) {
@@ -52,6 +114,59 @@ namespace moviesearch::services {
 	        }
 	    }
 
+	    void handle_user_option(movie_search::models::Query& query, const std::vector<std::string>& args, std::size_t& i, movie_search::models::ParseResult& parse_result) {
+	        const auto value = shared::utils::collect_single_value(args, i, "user", parse_result.errors);
+	        if (!value) return;
+	        try {
+	            query.user_id = std::stoi(*value);
+	            query.has_user = true;
+	        }
+	        catch (...) {
+	            parse_result.errors.push_back("Invalid user id: '" + *value + "'");
+	        }
+	    }
+
+	    void handle_min_users_option(movie_search::models::Query& query, const std::vector<std::string>& args, std::size_t& i, movie_search::models::ParseResult& parse_result) {
+	        const auto value = shared::utils::collect_single_value(args, i, "min-users", parse_result.errors);
+	        if (!value) return;
+	        try {
+	            const auto min_users = std::stoi(*value);
+	            if (min_users < 0) throw std::out_of_range("min-users");
+	            query.min_users = static_cast<std::size_t>(min_users);
+	        }
+	        catch (...) {
+	            parse_result.errors.push_back("Invalid user count: '" + *value + "'");
+	        }
+	    }
+
+	    void handle_sort_option(movie_search::models::Query& query, const std::vector<std::string>& args, std::size_t& i, movie_search::models::ParseResult& parse_result) {
+	        const auto value = shared::utils::collect_single_value(args, i, "sort", parse_result.errors);
+	        if (!value) return;
+	        if (*value == "file") query.sort = movie_search::models::SortOrder::file;
+	        else if (*value == "id") query.sort = movie_search::models::SortOrder::id;
+	        else if (*value == "title") query.sort = movie_search::models::SortOrder::title;
+	        else if (*value == "year") query.sort = movie_search::models::SortOrder::year;
+	        else parse_result.errors.push_back("Invalid sort order: '" + *value + "' (expected file, id, title or year)");
+	    }
+
+	    void handle_rank_option(movie_search::models::Query& query, const std::vector<std::string>& args, std::size_t& i, movie_search::models::ParseResult& parse_result) {
+	        auto vals = shared::utils::collect_value_tokens(args, i);
+	        query.rank = true;
+	        if (vals.empty()) return; // default limit
+	        if (vals.size() > 1) {
+	            parse_result.errors.emplace_back("Too many values for --rank (expected at most one)");
+	            return;
+	        }
+	        try {
+	            const auto limit = std::stoi(vals.front());
+	            if (limit <= 0) throw std::out_of_range("rank limit");
+	            query.rank_limit = static_cast<std::size_t>(limit);
+	        }
+	        catch (...) {
+	            parse_result.errors.push_back("Invalid rank limit: '" + vals.front() + "'");
+	        }
+	    }
+
 	    void parse_tokenized_args_into_query(const std::vector<std::string>& tokenized_args, movie_search::models::Query& query, movie_search::models::ParseResult& parse_result) {
 	        std::size_t i = 0;
 	        while (i < tokenized_args.size()) {
@@ -63,7 +178,7 @@ namespace moviesearch::services {
 	            }
 
 	            if (shared::utils::matches_option(token, "title")) {
-	                process_moviesearch_param(query.titles, "title", tokenized_args, i, parse_result);
+	                handle_title_option(query, tokenized_args, i, parse_result);
 	            }
 	            else if (shared::utils::matches_option(token, "year")) {
 	                handle_year_option(query, tokenized_args, i, parse_result);
@@ -74,6 +189,24 @@ namespace moviesearch::services {
 	            else if (shared::utils::matches_option(token, "tag") || shared::utils::matches_option(token, "tags")) {
 	                process_moviesearch_param(query.tags, "tag", tokenized_args, i, parse_result);
 	            }
+	            else if (shared::utils::matches_option(token, "user")) {
+	                handle_user_option(query, tokenized_args, i, parse_result);
+	            }
+	            else if (shared::utils::matches_option(token, "min-users")) {
+	                handle_min_users_option(query, tokenized_args, i, parse_result);
+	            }
+	            else if (shared::utils::matches_option(token, "sort")) {
+	                handle_sort_option(query, tokenized_args, i, parse_result);
+	            }
+	            else if (shared::utils::matches_option(token, "rank")) {
+	                handle_rank_option(query, tokenized_args, i, parse_result);
+	            }
+	            else if (shared::utils::matches_option(token, "facets")) {
+	                query.facets = true;
+	                for (const auto& value : shared::utils::collect_value_tokens(tokenized_args, i)) {
+	                    parse_result.warnings.push_back("Ignoring unexpected token: '" + value + "'");
+	                }
+	            }
 	            else {
 	                parse_result.errors.push_back("Unknown option: '" + token + "'");
 	                while (i < tokenized_args.size() && !shared::utils::token_is_option(tokenized_args[i])) ++i; // skip
@@ -82,9 +215,14 @@ namespace moviesearch::services {
 	    }
 
 	    void finalize_result(movie_search::models::Query& query, movie_search::models::ParseResult& parse_result) {
+	        if (query.rank && query.sort != movie_search::models::SortOrder::file) {
+	            parse_result.warnings.emplace_back("--sort is ignored with --rank (results are ordered by score)");
+	        }
+
 	        // Require at least one filter
-	        if (query.titles.empty() && !query.has_year && query.genres.empty() && query.tags.empty()) {
-	            parse_result.errors.emplace_back("moviesearch requires at least one filter (--title/--year/--genre/--tag)");
+	        if (query.titles.empty() && query.title_phrases.empty() && !query.has_year && query.genres.empty() && query.tags.empty()
+	            && !query.has_user && !query.min_users) {
+	            parse_result.errors.emplace_back("moviesearch requires at least one filter (--title/--year/--genre/--tag/--user/--min-users)");
 	        }
 
 	        // Dedupe lists while preserving order
@@ -99,9 +237,14 @@ namespace moviesearch::services {
 	std::vector<std::string> tokenize_command_line(const std::string& terminal_input) {
 		std::vector<std::string> tokens;
 		std::string current_token;
+		bool quoted = false; // whitespace inside "..." stays in the token (quotes are kept for the parser)
 
 		for (char input_char : terminal_input) {
-			if (std::isspace(static_cast<unsigned char>(input_char))) {
+			if (input_char == '"') {
+				quoted = !quoted;
+				current_token.push_back(input_char);
+			}
+			else if (!quoted && std::isspace(static_cast<unsigned char>(input_char))) {
 				if (!current_token.empty()) {
 					tokens.emplace_back(std::move(current_token));
 					current_token.clear();
@@ -13,11 +13,11 @@
 
 namespace moviesearch::services {
 
-    // tokenizer for a single command line
+    // tokenizer for a single command line; "quoted text" stays one token, quotes included
     std::vector<std::string> tokenize_command_line(const std::string& line);
 
     // Parse tokens that appear after the leading "moviesearch" token.
-    // Recognized options: --title, --year, --genre, --tag 
+    // Recognized options: --title, --year, --genre, --tag, --sort, --rank, --facets
     std::vector<std::string> tokenize_command_line(const std::string& terminal_input);
 
     // parse a raw input line that starts with "moviesearch".
@@ -0,0 +1,178 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file memory_stats_service.cpp
+ * @date 2025-10-04
+ */
+
+#include "memory_stats_service.h"
+
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+#include "allocation_counter.h"
+#include "catalog_service.h"
+#include "memory_usage.h"
+
+namespace movie_search::services {
+
+    namespace
+    {
+        double to_mebibytes(std::uint64_t bytes) {
+            return static_cast<double>(bytes) / (1024.0 * 1024.0);
+        }
+
+        void print_row(std::ostream& out, const std::string& component, std::uint64_t bytes, const std::string& detail) {
+            out << "  " << std::left << std::setw(20) << component << std::right
+                << std::setw(14) << bytes << std::setw(10) << to_mebibytes(bytes) << "  " << detail << "\n";
+        }
+
+        void print_size(std::ostream& out, const std::string& label, std::uint64_t bytes) {
+            out << "  " << std::left << std::setw(22) << label << std::right << ": " << bytes << " (" << to_mebibytes(bytes) << " MiB)\n";
+        }
+
+        // A dataset vector plus the arena holding its strings.
+        template <typename Record>
+        std::uint64_t print_dataset(std::ostream& out, const std::string& component, const std::vector<Record>& records,
+            const shared::utils::CountedArena* arena) {
+            const auto vector = shared::utils::vector_bytes(records);
+            const auto strings = std::accumulate(records.begin(), records.end(), std::size_t{ 0 },
+                [](std::size_t sum, const Record& record) { return sum + record.memory_bytes(); });
+            const auto blocks = arena ? arena->blocks().bytes_in_use() : 0;
+
+            std::ostringstream detail;
+            detail << records.size() << " rows: " << vector << " vector (" << sizeof(Record) << " B/row), "
+                << blocks << " arena for " << strings << " string bytes";
+            print_row(out, component, vector + blocks, detail.str());
+            return vector + blocks;
+        }
+    }
+
+    void run_memstats(std::ostream& out, models::Catalog& catalog) {
+        // Startup stages may still be writing into the catalog; let them finish first
+        if (catalog.loader) {
+            ensure_search_shards(catalog);
+            ensure_compressed_ratings(catalog);
+            finish_loading(catalog);
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(1);
+
+        std::uint64_t total = 0;
+        const auto row = [&](const std::string& component, std::uint64_t bytes, const std::string& detail) {
+            print_row(out, component, bytes, detail);
+            total += bytes;
+        };
+        const auto not_built = [&](const std::string& component) { print_row(out, component, 0, "not built"); };
+
+        out << "Resident catalog:\n"
+            << "  " << std::left << std::setw(20) << "component" << std::right
+            << std::setw(14) << "bytes" << std::setw(10) << "MiB" << "  detail\n";
+
+        total += print_dataset(out, "movies", catalog.movies, catalog.movie_arena.get());
+        total += print_dataset(out, "tags", catalog.tags, catalog.tag_arena.get());
+        row("ratings", shared::utils::vector_bytes(catalog.ratings), std::to_string(catalog.ratings.size()) + " rows ("
+            + std::to_string(sizeof(movie_parser::models::MovieRating)) + " B/row)");
+        row("movie id map", catalog.row_of_movie.memory_bytes(), catalog.row_of_movie.dense() ? "direct-address table" : "hash map");
+        row("movie groups", shared::utils::vector_bytes(catalog.tag_offsets) + shared::utils::vector_bytes(catalog.rating_offsets),
+            "tag and rating offsets per movie row");
+        row("user index", catalog.user_tags.memory_bytes() + catalog.user_ratings.memory_bytes(),
+            std::to_string(catalog.user_ratings.user_count()) + " users with ratings, "
+            + std::to_string(catalog.user_tags.user_count()) + " with tags");
+        {
+            std::uint64_t bytes = shared::utils::vector_bytes(catalog.movie_taggers) + shared::utils::vector_bytes(catalog.movie_raters)
+                + shared::utils::hash_map_bytes(catalog.tag_taggers) + shared::utils::vector_bytes(catalog.distinct_users);
+            std::size_t dense = 0;
+            const auto count = [&](const shared::utils::HyperLogLog& sketch) {
+                bytes += sketch.memory_bytes();
+                dense += sketch.dense();
+            };
+            for (const auto& sketch : catalog.movie_taggers) count(sketch);
+            for (const auto& sketch : catalog.movie_raters) count(sketch);
+            for (const auto& [tag, sketch] : catalog.tag_taggers) count(sketch);
+            const auto sketches = catalog.movie_taggers.size() + catalog.movie_raters.size() + catalog.tag_taggers.size();
+            row("user sketches", bytes, std::to_string(sketches) + " HyperLogLog sketches, " + std::to_string(dense) + " dense");
+        }
+
+        if (catalog.search_shards.empty()) not_built("search index");
+        else {
+            std::uint64_t bytes = shared::utils::vector_bytes(catalog.search_shards);
+            std::size_t postings = 0;
+            for (const auto& shard : catalog.search_shards) {
+                bytes += shard.memory_bytes();
+                postings += shard.titles.postings() + shard.genres.postings() + shard.tags.postings();
+            }
+            row("search index", bytes, std::to_string(catalog.search_shards.size()) + " shards, "
+                + std::to_string(postings) + " word postings");
+        }
+        if (catalog.rank_index) row("rank index", catalog.rank_index->memory_bytes(), std::to_string(catalog.rank_index->postings()) + " postings");
+        else not_built("rank index");
+        if (catalog.facet_index) row("facet index", catalog.facet_index->memory_bytes(), std::to_string(catalog.facet_index->facet_count()) + " bitmaps");
+        else not_built("facet index");
+        if (catalog.compressed_ratings) {
+            const auto& store = *catalog.compressed_ratings;
+            std::ostringstream detail;
+            detail << std::setprecision(2) << (store.size() ? static_cast<double>(store.memory_bytes()) / static_cast<double>(store.size()) : 0.0)
+                << " B/rating";
+            row("compressed ratings", store.memory_bytes(), detail.str());
+        }
+        else not_built("compressed ratings");
+        if (catalog.rating_matrix) row("rating matrix", catalog.rating_matrix->memory_bytes(), std::to_string(catalog.rating_matrix->by_user.non_zeros()) + " entries, CSR + CSC");
+        else not_built("rating matrix");
+
+        std::uint64_t similarity_bytes = 0;
+        std::size_t similarity_items = 0;
+        for (const auto& index : catalog.similarity) {
+            if (!index) continue;
+            similarity_bytes += index->memory_bytes();
+            similarity_items += index->cached_items();
+        }
+        if (similarity_bytes) row("similarity lists", similarity_bytes, std::to_string(similarity_items) + " movies cached");
+        else not_built("similarity lists");
+        if (catalog.tag_movies.tag_count()) row("tag matrix", catalog.tag_movies.memory_bytes(), std::to_string(catalog.tag_movies.tag_count())
+            + " tags x " + std::to_string(catalog.tag_movies.tagged_movies) + " movies, " + std::to_string(catalog.tag_movies.by_tag.non_zeros()) + " entries");
+        else not_built("tag matrix");
+        std::uint64_t related_bytes = 0;
+        std::size_t related_tags = 0;
+        std::size_t related_pairs = 0;
+        for (const auto& index : catalog.related_tags) {
+            if (!index) continue;
+            related_bytes += index->memory_bytes();
+            related_tags += index->cached_tags();
+            related_pairs += index->pairs();
+        }
+        if (related_bytes) row("related tags", related_bytes, std::to_string(related_tags) + " tags cached, "
+            + std::to_string(related_pairs) + " pairs");
+        else not_built("related tags");
+        if (catalog.candidate_pool) row("candidate pool", catalog.candidate_pool->memory_bytes(), std::to_string(catalog.candidate_pool->genre_count()) + " genre buckets");
+        else not_built("candidate pool");
+        if (catalog.factor_model) row("factor model", catalog.factor_model->memory_bytes(), std::to_string(catalog.factor_model->users.factors()) + " factors");
+        else not_built("factor model");
+        if (catalog.rating_times) row("rating times", catalog.rating_times->memory_bytes(), std::to_string(catalog.rating_times->months()) + " months");
+        else not_built("rating times");
+        if (catalog.tag_times) row("tag times", catalog.tag_times->memory_bytes(), std::to_string(catalog.tag_times->months()) + " months");
+        else not_built("tag times");
+        print_row(out, "total", total, "all of the above");
+
+        out << "Heap (global operator new):\n";
+        print_size(out, "live", shared::utils::live_bytes());
+        print_size(out, "peak live", shared::utils::peak_live_bytes());
+        print_size(out, "allocated since start", shared::utils::allocated_bytes());
+
+        out << "Process:\n";
+        if (const auto process = shared::utils::process_memory()) {
+            print_size(out, "resident (VmRSS)", process->rss_bytes);
+            print_size(out, "peak resident (VmHWM)", process->peak_rss_bytes);
+        }
+        else {
+            out << "  resident set not available (no /proc/self/status)\n";
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
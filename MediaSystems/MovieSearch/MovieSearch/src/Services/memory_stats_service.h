@@ -0,0 +1,27 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file memory_stats_service.h
+ * @date 2025-10-04
+ */
+
+#include <ostream>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    /**
+     * @brief Handle "memstats"
+     *
+     * Waits for the startup stages, then prints the heap bytes of every resident dataset and index
+     * (from their memory_bytes() hooks and the arena block counters), the live and peak heap bytes
+     * seen by the global operator new, and the current and peak resident set of the process.
+     * Nothing is loaded or built: components not in memory are reported as such.
+     *
+     * @param out Output stream
+     * @param catalog The resident catalog
+     */
+    void run_memstats(std::ostream& out, models::Catalog& catalog);
+
+}
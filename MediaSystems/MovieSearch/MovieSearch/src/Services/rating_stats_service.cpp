@@ -0,0 +1,79 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_stats_service.cpp
+ * @date 2025-10-03
+ */
+
+#include "rating_stats_service.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+#include "catalog_service.h"
+#include "date_utils.h"
+
+namespace movie_search::services {
+
+    void run_rating_stats(std::ostream& out, models::Catalog& catalog, const std::vector<std::string>& arguments) {
+        if (arguments.size() > 1) {
+            out << "Error: ratings expects at most one movie id\n";
+            return;
+        }
+
+        int movie_id = 0;
+        if (!arguments.empty()) {
+            try {
+                movie_id = std::stoi(arguments.front());
+            }
+            catch (...) {
+                out << "Error: Invalid movie id: '" << arguments.front() << "'\n";
+                return;
+            }
+        }
+
+        ensure_movies(catalog);
+        const auto& store = ensure_compressed_ratings(catalog);
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(2);
+
+        if (arguments.empty()) {
+            const auto plain = store.size() * sizeof(movie_parser::models::MovieRating);
+            out << store.size() << " ratings of " << store.movie_count() << " movies: "
+                << store.memory_bytes() << " bytes compressed ("
+                << (store.size() ? static_cast<double>(store.memory_bytes()) / static_cast<double>(store.size()) : 0.0)
+                << " bytes/rating), " << plain << " bytes as MovieRating vector"
+                << (store.lossless() ? "" : " (some ratings rounded to half stars)") << "\n";
+        }
+        else if (const auto block = store.find_movie(movie_id)) {
+            const auto count = store.count(*block);
+            long first = std::numeric_limits<long>::max();
+            long last = std::numeric_limits<long>::min();
+            for (const auto& rating : store.movie(*block)) {
+                first = std::min(first, rating.timestamp);
+                last = std::max(last, rating.timestamp);
+            }
+
+            const auto movie = catalog.row_of_movie.find(movie_id);
+            out << movie_id;
+            if (movie != shared::utils::IdRowMap::npos) out << "::" << catalog.movies[movie].title;
+            out << ": " << count << " ratings, mean " << store.rating_sum(*block) / static_cast<double>(count)
+                << ", " << shared::utils::format_day(shared::utils::day_of_timestamp(first))
+                << " .. " << shared::utils::format_day(shared::utils::day_of_timestamp(last)) << "\n";
+
+            const auto histogram = store.rating_histogram(*block);
+            out << std::setprecision(1);
+            for (std::size_t code = 0; code < histogram.size(); ++code) {
+                if (histogram[code]) out << "  " << static_cast<double>(code) * 0.5 << ": " << histogram[code] << "\n";
+            }
+        }
+        else {
+            out << "No ratings for movie " << movie_id << "\n";
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_stats_service.h
+ * @date 2025-10-03
+ */
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    /**
+     * @brief Handle "ratings [<movie_id>]"
+     *
+     * Without an id, prints the size of the compressed ratings store against the plain vector.
+     * With an id, prints the count, mean, date range and half-star histogram of that movie,
+     * decoded from the compressed store.
+     *
+     * @param out Output stream
+     * @param catalog The resident catalog (the store is built on first use)
+     * @param arguments Tokens after the leading "ratings" token
+     */
+    void run_rating_stats(std::ostream& out, models::Catalog& catalog, const std::vector<std::string>& arguments);
+
+}
@@ -0,0 +1,143 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file recommendation_service.cpp
+ * @date 2025-10-01
+ */
+
+#include "recommendation_service.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "catalog_service.h"
+#include "cmdline_utils.h"
+#include "command_service.h"
+#include "search_service.h"
+#include "string_utils.h"
+
+namespace movie_search::services {
+    namespace {
+        struct ScoredMovie {
+            std::uint32_t item;
+            float score;
+        };
+
+        // Heap order that keeps the worst of the current top-K at the front.
+        bool better(const ScoredMovie& a, const ScoredMovie& b) {
+            return a.score != b.score ? a.score > b.score : a.item < b.item;
+        }
+    }
+
+    RecommendRequest parse_recommend_line(const std::vector<std::string>& arguments) {
+        RecommendRequest request;
+        std::vector<std::string> filter_args;
+        bool has_user = false;
+
+        std::size_t i = 0;
+        while (i < arguments.size()) {
+            const std::string& token = arguments[i++];
+
+            if (!has_user && !shared::utils::token_is_option(token)) {
+                try {
+                    request.user_id = std::stoi(token);
+                    has_user = true;
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid user id: '" + token + "'");
+                }
+            }
+            else if (shared::utils::matches_option(token, "limit")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "limit", request.errors);
+                if (!value) continue;
+                try {
+                    const auto limit = std::stoi(*value);
+                    if (limit <= 0) throw std::out_of_range("limit");
+                    request.limit = static_cast<std::size_t>(limit);
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid limit: '" + *value + "'");
+                }
+            }
+            else {
+                filter_args.push_back(token);
+            }
+        }
+
+        if (!has_user) {
+            request.errors.emplace_back("recommend requires a user id");
+        }
+        if (!filter_args.empty()) {
+            auto parse_result = moviesearch::services::parse_moviesearch_line(filter_args);
+            request.filters = std::move(parse_result.query);
+            request.has_filters = true;
+            if (request.filters.has_user) request.errors.emplace_back("--user is not a recommend filter (the user is the first argument)");
+            request.errors.insert(request.errors.end(), parse_result.errors.begin(), parse_result.errors.end());
+            request.warnings.insert(request.warnings.end(), parse_result.warnings.begin(), parse_result.warnings.end());
+        }
+        request.ok = request.errors.empty();
+        return request;
+    }
+
+    void run_recommend(std::ostream& out, models::Catalog& catalog, const RecommendRequest& request,
+        shared::utils::QueryCounters* counters) {
+        const auto& pool = ensure_candidate_pool(catalog);
+        if (request.has_filters) ensure_tags(catalog);
+        const auto distinct_users = request.filters.min_users ? ensure_distinct_users(catalog) : std::span<const std::uint32_t>{};
+
+        shared::utils::QueryCounters local_counters;
+        auto candidates = pool.candidates_for(request.user_id, request.filters.genres);
+        local_counters.rows_scanned = candidates.size();
+
+        if (request.has_filters) {
+            std::erase_if(candidates, [&](std::uint32_t item) {
+                if (request.filters.min_users && distinct_users[item] < request.filters.min_users) return true;
+                return !movie_matches(request.filters, catalog.movies[item], movie_tags(catalog, item), local_counters);
+            });
+        }
+
+        std::vector<float> scores(candidates.size());
+        if (catalog.factor_model) {
+            catalog.factor_model->score_items(request.user_id, candidates, scores);
+        }
+        else {
+            for (std::size_t i = 0; i < candidates.size(); ++i) scores[i] = pool.popularity_score(candidates[i]);
+        }
+
+        // Bounded top-K: a min-heap (by `better`) of at most limit entries.
+        std::vector<ScoredMovie> top;
+        top.reserve(request.limit + 1);
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            const ScoredMovie scored{ candidates[i], scores[i] };
+            if (top.size() < request.limit) {
+                top.push_back(scored);
+                std::push_heap(top.begin(), top.end(), better);
+            }
+            else if (better(scored, top.front())) {
+                std::pop_heap(top.begin(), top.end(), better);
+                top.back() = scored;
+                std::push_heap(top.begin(), top.end(), better);
+            }
+        }
+        std::sort_heap(top.begin(), top.end(), better);
+
+        local_counters.matches = top.size();
+        if (counters) *counters += local_counters;
+
+        if (top.empty()) {
+            out << "No recommendations for user " << request.user_id << "\n";
+            return;
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(2);
+        for (const auto& entry : top) {
+            const auto& movie = catalog.movies[entry.item];
+            out << movie.movie_id << "::" << movie.title << "::" << shared::utils::join(movie.genres, "|")
+                << "::" << entry.score << "\n";
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
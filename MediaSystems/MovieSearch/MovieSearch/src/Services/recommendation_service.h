@@ -0,0 +1,50 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file recommendation_service.h
+ * @date 2025-10-01
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "instrumentation.h"
+#include "../models/Catalog.h"
+#include "../models/Query.h"
+
+namespace movie_search::services {
+
+    // Parsed form of "recommend <user_id> [--limit N] [moviesearch filters]".
+    struct RecommendRequest {
+        bool ok = false;
+        int user_id = 0;
+        std::size_t limit = 10;
+        bool has_filters = false;
+        models::Query filters;
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+    };
+
+    /**
+     * @brief Parse the tokens after the leading "recommend" token
+     * @return The request; ok == errors.empty()
+     */
+    RecommendRequest parse_recommend_line(const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Print the top unseen movies of a user as "id::title::genres::score"
+     *
+     * Candidates come from the precomputed pool, are filtered with the moviesearch predicate and
+     * scored with the trained factor model (or by popularity when no model was trained).
+     *
+     * @param out Output stream
+     * @param catalog The resident catalog
+     * @param request A parsed request
+     * @param counters Optional work counters (candidates scanned, predicates, matches)
+     */
+    void run_recommend(std::ostream& out, models::Catalog& catalog, const RecommendRequest& request,
+        shared::utils::QueryCounters* counters = nullptr);
+
+}
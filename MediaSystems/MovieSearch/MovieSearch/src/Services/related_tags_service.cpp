@@ -0,0 +1,112 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file related_tags_service.cpp
+ * @date 2025-10-04
+ */
+
+#include "related_tags_service.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "catalog_service.h"
+#include "cmdline_utils.h"
+
+namespace movie_search::services {
+
+    RelatedTagsRequest parse_related_tags_line(const std::vector<std::string>& arguments) {
+        RelatedTagsRequest request;
+
+        std::size_t i = 0;
+        while (i < arguments.size()) {
+            const std::string& token = arguments[i++];
+
+            if (!shared::utils::token_is_option(token)) {
+                // The words of the tag, quoted or not
+                auto word = token;
+                std::erase(word, '"');
+                if (word.empty()) continue;
+                if (!request.tag.empty()) request.tag += ' ';
+                request.tag += word;
+            }
+            else if (shared::utils::matches_option(token, "all")) {
+                request.all = true;
+            }
+            else if (shared::utils::matches_option(token, "limit")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "limit", request.errors);
+                if (!value) continue;
+                try {
+                    const auto limit = std::stoi(*value);
+                    if (limit <= 0) throw std::out_of_range("limit");
+                    request.limit = static_cast<std::size_t>(limit);
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid limit: '" + *value + "'");
+                    continue;
+                }
+                // Only the top_k related tags of a tag are kept, so a larger limit could never be filled
+                const auto max_limit = indexes::TagCooccurrenceOptions{}.top_k;
+                if (request.limit > max_limit) {
+                    request.errors.push_back("Limit " + *value + " exceeds the " + std::to_string(max_limit) + " related tags kept per tag");
+                }
+            }
+            else if (shared::utils::matches_option(token, "measure")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "measure", request.errors);
+                if (!value) continue;
+                if (*value == "jaccard") request.measure = indexes::TagAssociation::jaccard;
+                else if (*value == "pmi") request.measure = indexes::TagAssociation::pmi;
+                else request.errors.push_back("Unknown measure: '" + *value + "' (expected jaccard or pmi)");
+            }
+            else {
+                request.errors.push_back("Unknown option: '" + token + "'");
+                while (i < arguments.size() && !shared::utils::token_is_option(arguments[i])) ++i; // skip
+            }
+        }
+
+        if (request.tag.empty() && !request.all) {
+            request.errors.emplace_back("relatedtags requires a tag (or --all)");
+        }
+        request.ok = request.errors.empty();
+        return request;
+    }
+
+    void run_related_tags(std::ostream& out, models::Catalog& catalog, const RelatedTagsRequest& request) {
+        auto& index = related_tags_index(catalog, request.measure);
+        const auto& matrix = catalog.tag_movies;
+
+        if (request.all) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto computed = index.precompute();
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            out << "Computed related tags for " << computed << " tags in " << elapsed.count() << " ms ("
+                << index.cached_tags() << " cached)\n";
+            return;
+        }
+
+        const auto tag = matrix.find(request.tag);
+        if (tag == indexes::TagMovieMatrix::npos) {
+            out << "Error: unknown tag '" << request.tag << "'\n";
+            return;
+        }
+
+        const auto related = index.related(static_cast<std::uint32_t>(tag));
+        if (related.empty()) {
+            out << "No related tags found for '" << matrix.names[tag] << "' (" << matrix.movie_count(static_cast<std::uint32_t>(tag))
+                << " movies)\n";
+            return;
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(4);
+
+        const auto count = std::min(request.limit, related.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            out << matrix.names[related[i].tag] << "::" << related[i].common << "::" << related[i].score << "\n";
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
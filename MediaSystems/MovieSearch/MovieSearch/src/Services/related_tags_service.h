@@ -0,0 +1,43 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file related_tags_service.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    // Parsed form of "relatedtags <tag> [--limit N] [--measure jaccard|pmi]" or "relatedtags --all".
+    struct RelatedTagsRequest {
+        bool ok = false;
+        bool all = false;
+        std::string tag;                // may be several words
+        std::size_t limit = 10;
+        indexes::TagAssociation measure = indexes::TagAssociation::jaccard;
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @brief Parse the tokens after the leading "relatedtags" token
+     * @param arguments Command arguments
+     * @return The request; ok == errors.empty()
+     */
+    RelatedTagsRequest parse_related_tags_line(const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Print the tags most often put on the same movies as "tag::shared movies::score", or
+     *        precompute all lists
+     * @param out Output stream
+     * @param catalog The resident catalog (tags and the co-occurrence lists are built on first use)
+     * @param request A parsed request
+     */
+    void run_related_tags(std::ostream& out, models::Catalog& catalog, const RelatedTagsRequest& request);
+
+}
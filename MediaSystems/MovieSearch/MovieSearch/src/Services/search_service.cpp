@@ -7,9 +7,16 @@
 #include "search_service.h"
 #include <algorithm>
 #include <cctype>
+#include <functional>
+#include <future>
+#include <limits>
 #include <optional>
+#include <span>
+#include <utility>
 
+#include "sort_by_member.h"
 #include "string_utils.h"
+#include "text_fold.h"
 
 namespace {
 
@@ -19,7 +26,7 @@ namespace movie_search::services {
 
     namespace
     {
-        bool match_genres(const std::vector<std::string>& queried_list, const std::vector<std::string>& genres) {
+        bool match_genres(const std::vector<std::string>& queried_list, const std::pmr::vector<std::pmr::string>& genres) {
             for (const auto& query : queried_list) {
                 bool found = false;
                 for (const auto& parsed_token : genres) {
@@ -33,14 +40,14 @@ namespace movie_search::services {
             return true; // all queries matched
         }
 
-        bool match_tags(const movie_parser::models::Movie& movie,
-            const std::vector<std::string>& queried_list,
-            const std::vector<movie_parser::models::MovieTag>& tags) {
+        bool match_tags(const std::vector<std::string>& queried_list,
+            std::span<const movie_parser::models::MovieTag> movie_tags,
+            shared::utils::QueryCounters& counters) {
             for (const auto& query : queried_list) {
                 bool found = false;
-                for (const auto& tag : tags) {
-                    if (tag.movie_id == movie.movie_id &&
-                        shared::utils::case_insensitive_contains_word(tag.tag, query)) {
+                for (const auto& tag : movie_tags) {
+                    ++counters.tag_rows_scanned;
+                    if (shared::utils::case_insensitive_contains_word(tag.tag, query)) {
                         found = true; break;
                     }
                 }
@@ -48,56 +55,354 @@ namespace movie_search::services {
             }
             return true; // all queries matched
         }
+
+        // Strict weak order of result rows for a sort order; ties fall back to the row, so rows never compare equal.
+        struct ResultOrder {
+            models::SortOrder order;
+            const std::vector<movie_parser::models::Movie>& movies;
+
+            bool operator()(std::uint32_t a, std::uint32_t b) const {
+                const auto& left = movies[a];
+                const auto& right = movies[b];
+                switch (order) {
+                case models::SortOrder::id:
+                    if (left.movie_id != right.movie_id) return left.movie_id < right.movie_id;
+                    break;
+                case models::SortOrder::title:
+                    if (left.title != right.title) return left.title < right.title;
+                    break;
+                case models::SortOrder::year:
+                    if (left.year != right.year) return left.year && (!right.year || *left.year < *right.year); // no year last
+                    break;
+                default:
+                    break;
+                }
+                return a < b;
+            }
+        };
+
+        // Order result rows like ResultOrder. The rows arrive ascending and sort_by is stable, so ties
+        // stay in row order; ids and years are radix-sorted, titles merge-sorted.
+        void sort_rows(std::vector<std::uint32_t>& rows, models::SortOrder order, const std::vector<movie_parser::models::Movie>& movies) {
+            using shared::utils::ascending;
+            switch (order) {
+            case models::SortOrder::id:
+                shared::utils::sort_by(rows, ascending([&](std::uint32_t row) { return movies[row].movie_id; }));
+                break;
+            case models::SortOrder::title:
+                shared::utils::sort_by(rows, ascending([&](std::uint32_t row) -> const std::pmr::string& { return movies[row].title; }));
+                break;
+            case models::SortOrder::year: // no year last
+                shared::utils::sort_by(rows, ascending([&](std::uint32_t row) { return movies[row].year.value_or(std::numeric_limits<int>::max()); }));
+                break;
+            default:
+                break;
+            }
+        }
+
+        // k-way merge of sorted shard results with a heap of cursors (shard, position).
+        std::vector<std::uint32_t> merge_sorted(const std::vector<std::vector<std::uint32_t>>& parts, const ResultOrder& before) {
+            using Cursor = std::pair<std::size_t, std::size_t>;
+            const auto later = [&](const Cursor& a, const Cursor& b) {
+                return before(parts[b.first][b.second], parts[a.first][a.second]);
+            };
+            std::vector<Cursor> heap;
+            std::size_t total = 0;
+            for (std::size_t part = 0; part < parts.size(); ++part) {
+                if (!parts[part].empty()) heap.emplace_back(part, 0);
+                total += parts[part].size();
+            }
+            std::make_heap(heap.begin(), heap.end(), later);
+
+            std::vector<std::uint32_t> merged;
+            merged.reserve(total);
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                auto& cursor = heap.back();
+                merged.push_back(parts[cursor.first][cursor.second]);
+                if (++cursor.second < parts[cursor.first].size()) std::push_heap(heap.begin(), heap.end(), later);
+                else heap.pop_back();
+            }
+            return merged;
+        }
+    }
+
+    bool movie_matches(const models::Query& query,
+        const movie_parser::models::Movie& movie,
+        std::span<const movie_parser::models::MovieTag> movie_tags,
+        shared::utils::QueryCounters& counters) {
+        // All title keywords must appear
+        for (const auto& keyword : query.titles) {
+            ++counters.predicates_evaluated;
+            if (!shared::utils::case_insensitive_contains_word(movie.title, keyword)) {
+                return false;
+            }
+        }
+
+        // And every quoted phrase
+        for (const auto& phrase : query.title_phrases) {
+            ++counters.predicates_evaluated;
+            if (!shared::utils::contains_phrase(movie.title, phrase.words, phrase.slop)) {
+                return false;
+            }
+        }
+
+        // Year filter
+        if (query.has_year) {
+            ++counters.predicates_evaluated;
+            if (!movie.year || *movie.year != query.year) {
+            	return false;
+            }
+        }
+
+        // All genres must appear
+        if (!query.genres.empty()) {
+            ++counters.predicates_evaluated;
+            if (!match_genres(query.genres, movie.genres))
+            {
+                return false;
+            }
+        }
+
+        // All tags must appear
+        if (!query.tags.empty()) {
+            ++counters.predicates_evaluated;
+            if (!match_tags(query.tags, movie_tags, counters))
+            {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     std::vector<movie_parser::models::Movie> search_movies(
         const models::Query& query,
         const std::vector<movie_parser::models::Movie>& movies,
-        const std::vector<movie_parser::models::MovieTag>& tags
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        std::span<const std::uint32_t> tag_offsets,
+        shared::utils::QueryCounters* counters,
+        const shared::utils::QueryDeadline* deadline
     ) {
         std::vector<movie_parser::models::Movie> results;
+        shared::utils::QueryCounters local_counters;
+        const std::span<const movie_parser::models::MovieTag> all_tags(tags);
 
-        for (const auto& movie : movies) {
-            bool match = true;
-
-            // All title keywords must appear
-            for (const auto& keyword : query.titles) {
-                if (!shared::utils::case_insensitive_contains_word(movie.title, keyword)) {
-                    match = false;
-                    break;
-                }
+        for (std::size_t row = 0; row < movies.size(); ++row) {
+            if (shared::utils::out_of_time(deadline, row)) break;
+            ++local_counters.rows_scanned;
+            if (query.has_user) {
+                ++local_counters.predicates_evaluated;
+                if (!std::binary_search(query.user_rows.begin(), query.user_rows.end(), static_cast<std::uint32_t>(row))) continue;
             }
+            if (query.min_users) {
+                ++local_counters.predicates_evaluated;
+                if (query.distinct_users[row] < query.min_users) continue;
+            }
+            const auto movie_tags = all_tags.subspan(tag_offsets[row], tag_offsets[row + 1] - tag_offsets[row]);
+            if (movie_matches(query, movies[row], movie_tags, local_counters)) {
+                results.push_back(movies[row]);
+            }
+        }
 
-            // Year filter
-            if (match && query.has_year) {
-                if (!movie.year || *movie.year != query.year) {
-                	match = false;
-                }
+        local_counters.matches = results.size();
+        if (counters) {
+            *counters += local_counters;
+        }
+        return results;
+    }
+
+    std::vector<std::uint32_t> search_movie_rows(
+        const models::Query& query,
+        const std::vector<movie_parser::models::Movie>& movies,
+        const indexes::SearchIndex& index,
+        shared::utils::QueryCounters* counters,
+        const shared::utils::QueryDeadline* deadline
+    ) {
+        shared::utils::QueryCounters local_counters;
+
+        // One posting list per keyword; keywords are folded on the stack like the indexed words
+        std::vector<std::span<const std::uint32_t>> lists;
+        lists.reserve(query.titles.size() + query.genres.size() + query.tags.size() + query.title_phrases.size());
+        const auto look_up = [&](const indexes::TokenIndex& words, const std::vector<std::string>& keywords) {
+            for (const auto& keyword : keywords) {
+                ++local_counters.predicates_evaluated;
+                if (keyword.empty()) lists.emplace_back();
+                else lists.push_back(words.rows(shared::utils::FoldedWord(keyword).view()));
             }
+        };
+        look_up(index.titles, query.titles);
+        look_up(index.genres, query.genres);
+        look_up(index.tags, query.tags);
 
-            // All genres must appear
-            if (match && !query.genres.empty()) {
+        // Phrases are merges of positional postings; their rows join the other lists
+        std::vector<std::vector<std::uint32_t>> phrase_rows;
+        phrase_rows.reserve(query.title_phrases.size());
+        for (const auto& phrase : query.title_phrases) {
+            if (deadline && deadline->expired()) break;
+            ++local_counters.predicates_evaluated;
+            std::vector<shared::utils::FoldedWord> folded(phrase.words.begin(), phrase.words.end());
+            std::vector<std::string_view> words;
+            words.reserve(folded.size());
+            for (const auto& word : folded) words.push_back(word.view());
+            phrase_rows.push_back(index.title_positions.match(words, phrase.slop, &local_counters.rows_scanned));
+            lists.push_back(phrase_rows.back());
+        }
+
+        // The movies of --user span all shards; the rows of this shard keep only its own
+        if (query.has_user) {
+            ++local_counters.predicates_evaluated;
+            lists.push_back(query.user_rows);
+            lists.push_back(index.rows);
+        }
 
-                if (!match_genres(query.genres, movie.genres))
-                {
-                    match = false;
+        std::vector<std::uint32_t> rows;
+        if (lists.empty()) {
+            rows = index.rows;
+        }
+        else {
+            // Intersect from the shortest list; every other list is only probed with binary searches
+            std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+            rows.assign(lists.front().begin(), lists.front().end());
+            local_counters.rows_scanned += rows.size();
+            for (std::size_t i = 1; i < lists.size() && !rows.empty(); ++i) {
+                if (deadline && deadline->expired()) break;
+                auto next = lists[i].begin();
+                auto kept = rows.begin();
+                for (auto it = rows.begin(); it != rows.end(); ++it) {
+                    if (shared::utils::out_of_time(deadline, ++local_counters.rows_scanned)) break;
+                    next = std::lower_bound(next, lists[i].end(), *it);
+                    if (next == lists[i].end()) break;
+                    if (*next == *it) *kept++ = *it;
                 }
+                rows.erase(kept, rows.end());
             }
+        }
 
-            // All tags must appear
-            if (match && !query.tags.empty()) {
+        if (query.has_year) {
+            std::erase_if(rows, [&](std::uint32_t row) {
+                ++local_counters.predicates_evaluated;
+                return !movies[row].year || *movies[row].year != query.year;
+            });
+        }
+        if (query.min_users) {
+            std::erase_if(rows, [&](std::uint32_t row) {
+                ++local_counters.predicates_evaluated;
+                return query.distinct_users[row] < query.min_users;
+            });
+        }
 
-                if (!match_tags(movie, query.tags, tags))
-                {
-                    match = false;
-                }
+        sort_rows(rows, query.sort, movies);
+
+        local_counters.matches = rows.size();
+        if (counters) {
+            *counters += local_counters;
+        }
+        return rows;
+    }
+
+    std::vector<std::uint32_t> search_movie_rows(
+        const models::Query& query,
+        const std::vector<movie_parser::models::Movie>& movies,
+        std::span<const indexes::SearchIndex> shards,
+        shared::utils::QueryCounters* counters,
+        const shared::utils::QueryDeadline* deadline,
+        shared::utils::ThreadPool* pool
+    ) {
+        if (shards.size() == 1) return search_movie_rows(query, movies, shards.front(), counters, deadline);
+
+        // Scatter: shard 0 runs on the calling thread, every other shard on the pool
+        std::vector<std::vector<std::uint32_t>> parts(shards.size());
+        std::vector<shared::utils::QueryCounters> shard_counters(shards.size());
+        const auto search_shard = [&](std::size_t shard) {
+            parts[shard] = search_movie_rows(query, movies, shards[shard], &shard_counters[shard], deadline);
+        };
+        std::vector<std::shared_future<void>> scattered;
+        if (pool) {
+            scattered.reserve(shards.size());
+            for (std::size_t shard = 1; shard < shards.size(); ++shard) {
+                scattered.push_back(pool->submit([&search_shard, shard] { search_shard(shard); }));
             }
+        }
+        if (!shards.empty()) search_shard(0);
+        if (!pool) {
+            for (std::size_t shard = 1; shard < shards.size(); ++shard) search_shard(shard);
+        }
+        for (const auto& done : scattered) done.wait();   // every shard is done with the locals before any rethrow
+        for (const auto& done : scattered) done.get();
+
+        // Gather
+        auto rows = merge_sorted(parts, ResultOrder{ query.sort, movies });
+        if (counters) {
+            for (const auto& shard : shard_counters) *counters += shard;
+        }
+        return rows;
+    }
+
+    std::vector<indexes::ScoredRow> rank_movie_rows(
+        const models::Query& query,
+        const std::vector<movie_parser::models::Movie>& movies,
+        std::span<const indexes::SearchIndex> shards,
+        const indexes::RankIndex& ranking,
+        shared::utils::QueryCounters* counters,
+        const shared::utils::QueryDeadline* deadline,
+        shared::utils::ThreadPool* pool
+    ) {
+        shared::utils::QueryCounters local_counters;
+
+        // Year, genres and phrases filter through the word indexes; keywords (and phrase words) score
+        std::vector<std::uint32_t> allowed;
+        const bool filtered = query.has_year || query.has_user || query.min_users || !query.genres.empty() || !query.title_phrases.empty();
+        if (filtered) {
+            models::Query filter;
+            filter.has_year = query.has_year;
+            filter.year = query.year;
+            filter.has_user = query.has_user;
+            filter.user_id = query.user_id;
+            filter.user_rows = query.user_rows;
+            filter.min_users = query.min_users;
+            filter.distinct_users = query.distinct_users;
+            filter.genres = query.genres;
+            filter.title_phrases = query.title_phrases;
+            allowed = search_movie_rows(filter, movies, shards, &local_counters, deadline, pool);
+        }
+
+        std::vector<shared::utils::FoldedWord> folded;
+        folded.reserve(query.titles.size() + query.tags.size());
+        for (const auto& keyword : query.titles) folded.emplace_back(keyword);
+        for (const auto& keyword : query.tags) folded.emplace_back(keyword);
+        for (const auto& phrase : query.title_phrases) {
+            for (const auto& word : phrase.words) folded.emplace_back(word);
+        }
+        std::vector<std::string_view> words;
+        words.reserve(folded.size());
+        for (const auto& word : folded) {
+            if (!word.view().empty() && std::find(words.begin(), words.end(), word.view()) == words.end()) words.push_back(word.view());
+        }
 
-            if (match) {
-                results.push_back(movie);
+        std::vector<indexes::ScoredRow> results;
+        if (!words.empty()) {
+            std::function<bool(std::uint32_t)> accept;
+            if (filtered) accept = [&](std::uint32_t row) { return std::binary_search(allowed.begin(), allowed.end(), row); };
+            results = ranking.top_k(words, query.rank_limit, accept, &local_counters.rows_scanned, deadline);
+        }
+        else {
+            if (!filtered) {
+                allowed.resize(movies.size());
+                for (std::uint32_t row = 0; row < allowed.size(); ++row) allowed[row] = row;
             }
+            results.reserve(allowed.size());
+            for (const auto row : allowed) results.push_back({ row, ranking.popularity(row) });
+            const auto kept = std::min(query.rank_limit, results.size());
+            std::partial_sort(results.begin(), results.begin() + static_cast<std::ptrdiff_t>(kept), results.end(),
+                [](const indexes::ScoredRow& a, const indexes::ScoredRow& b) { return a.score != b.score ? a.score > b.score : a.row < b.row; });
+            results.resize(kept);
         }
 
+        local_counters.matches = results.size();
+        if (counters) {
+            *counters += local_counters;
+        }
         return results;
     }
-}
+}
\ No newline at end of file
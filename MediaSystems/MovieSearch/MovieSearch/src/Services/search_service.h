@@ -5,25 +5,127 @@
  * @date 2025-09-17
  */
 
+#include <cstdint>
+#include <span>
 #include <vector>
 #include "Movie.h"
 #include "MovieTag.h"
+#include "deadline.h"
+#include "instrumentation.h"
+#include "thread_pool.h"
+#include "../indexes/rank_index.h"
+#include "../indexes/token_index.h"
 #include "../models/Query.h"
 
 namespace movie_search::services {
 
+    /**
+     * @brief Check a single movie against all filters of a query
+     *
+     * @param query The query (title keywords, year, genres, tags)
+     * @param movie The movie to test
+     * @param movie_tags The tags of this movie
+     * @param counters Work counters (predicates evaluated, tag rows scanned)
+     * @return true if every filter of the query matches, except --user (query.user_rows) and
+     *         --min-users (query.distinct_users), which the callers check against the movie row
+     */
+    bool movie_matches(const movie_search::models::Query& query,
+        const movie_parser::models::Movie& movie,
+        std::span<const movie_parser::models::MovieTag> movie_tags,
+        shared::utils::QueryCounters& counters);
+
     /**
      * @brief Search movies based on a parsed query
      *
      * @param The query (title keywords, year, genres, tags)
      * @param movies Parsed movies from movies.dat
-     * @param tags Parsed tags from tags.dat
+     * @param tags Parsed tags from tags.dat, grouped by movie row (see shared::utils::group_by_row)
+     * @param tag_offsets The tags of movie row r are tags[tag_offsets[r] .. tag_offsets[r + 1])
+     * @param counters Optional work counters (movie and tag rows scanned, predicates evaluated, matches)
+     * @param deadline Optional time budget / cancellation; the scan stops early once it expired,
+     *        so the results are incomplete whenever deadline->stopped() is true afterwards
      * @return Vector of matching movies
      */
     std::vector<movie_parser::models::Movie> search_movies(
         const movie_search::models::Query&,
         const std::vector<movie_parser::models::Movie>& movies,
-        const std::vector<movie_parser::models::MovieTag>& tags
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        std::span<const std::uint32_t> tag_offsets,
+        shared::utils::QueryCounters* counters = nullptr,
+        const shared::utils::QueryDeadline* deadline = nullptr
+    );
+
+    /**
+     * @brief Search movies with the word indexes instead of scanning every movie
+     *
+     * Every title, genre and tag keyword is folded once and looked up, and every title phrase is
+     * merged from the positional postings; with --user, query.user_rows joins them. The row lists
+     * are intersected from the shortest one, then the year and --min-users filters are applied. Matches the same movies
+     * as search_movies (restricted to the rows of the index), ordered by query.sort.
+     *
+     * @param query The query (title keywords, year, genres, tags)
+     * @param movies Movies the index was built over
+     * @param index Word indexes of the movies
+     * @param counters Optional work counters (posting entries scanned, predicates evaluated, matches)
+     * @param deadline Optional time budget / cancellation, checked while intersecting (see search_movies)
+     * @return Matching movie rows in query.sort order (file order: ascending rows)
+     */
+    std::vector<std::uint32_t> search_movie_rows(
+        const movie_search::models::Query& query,
+        const std::vector<movie_parser::models::Movie>& movies,
+        const indexes::SearchIndex& index,
+        shared::utils::QueryCounters* counters = nullptr,
+        const shared::utils::QueryDeadline* deadline = nullptr
+    );
+
+    /**
+     * @brief Scatter a query to every shard in parallel and gather the results
+     *
+     * Shard 0 is searched (and its results sorted) on the calling thread, every other shard on the
+     * pool; the sorted shard results are then combined with a k-way merge, so the order is the
+     * same as with a single index.
+     *
+     * @param query The query (title keywords, year, genres, tags, sort order)
+     * @param movies Movies the shards were built over
+     * @param shards Word indexes of disjoint sets of movies
+     * @param counters Optional work counters, summed over the shards
+     * @param deadline Optional time budget / cancellation, shared by all shards
+     * @param pool Workers for shards 1..n-1 (e.g. Catalog::shard_pool); without one they run on the calling thread
+     * @return Matching movie rows in query.sort order
+     */
+    std::vector<std::uint32_t> search_movie_rows(
+        const movie_search::models::Query& query,
+        const std::vector<movie_parser::models::Movie>& movies,
+        std::span<const indexes::SearchIndex> shards,
+        shared::utils::QueryCounters* counters = nullptr,
+        const shared::utils::QueryDeadline* deadline = nullptr,
+        shared::utils::ThreadPool* pool = nullptr
+    );
+
+    /**
+     * @brief Rank movies for moviesearch --rank
+     *
+     * Title and tag keywords become one disjunctive BM25 query (a movie needs only one of them);
+     * year, genres and title phrases stay filters, answered by the shards (phrase words also
+     * score). Without keywords the filtered movies are ranked by popularity alone.
+     *
+     * @param query The query (keywords, filters, rank_limit)
+     * @param movies Movies the indexes were built over
+     * @param shards Word indexes for the year and genre filters
+     * @param ranking BM25 postings of the movies
+     * @param counters Optional work counters (postings scored, matches)
+     * @param deadline Optional time budget / cancellation for the filters and the WAND loop
+     * @param pool Workers for the filter shards (see the sharded search_movie_rows)
+     * @return Up to query.rank_limit movies by descending score
+     */
+    std::vector<indexes::ScoredRow> rank_movie_rows(
+        const movie_search::models::Query& query,
+        const std::vector<movie_parser::models::Movie>& movies,
+        std::span<const indexes::SearchIndex> shards,
+        const indexes::RankIndex& ranking,
+        shared::utils::QueryCounters* counters = nullptr,
+        const shared::utils::QueryDeadline* deadline = nullptr,
+        shared::utils::ThreadPool* pool = nullptr
     );
 
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file similarity_service.cpp
+ * @date 2025-09-29
+ */
+
+#include "similarity_service.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "catalog_service.h"
+#include "cmdline_utils.h"
+#include "string_utils.h"
+
+namespace movie_search::services {
+
+    SimilarRequest parse_similar_line(const std::vector<std::string>& arguments) {
+        SimilarRequest request;
+        bool has_movie = false;
+
+        std::size_t i = 0;
+        while (i < arguments.size()) {
+            const std::string& token = arguments[i++];
+
+            if (!shared::utils::token_is_option(token)) {
+                if (has_movie) {
+                    request.errors.push_back("Unexpected token: '" + token + "'");
+                    continue;
+                }
+                try {
+                    request.movie_id = std::stoi(token);
+                    has_movie = true;
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid movie id: '" + token + "'");
+                }
+            }
+            else if (shared::utils::matches_option(token, "all")) {
+                request.all = true;
+            }
+            else if (shared::utils::matches_option(token, "limit")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "limit", request.errors);
+                if (!value) continue;
+                try {
+                    const auto limit = std::stoi(*value);
+                    if (limit <= 0) throw std::out_of_range("limit");
+                    request.limit = static_cast<std::size_t>(limit);
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid limit: '" + *value + "'");
+                    continue;
+                }
+                // Only the top_k neighbours of a movie are kept, so a larger limit could never be filled
+                const auto max_limit = indexes::SimilarityOptions{}.top_k;
+                if (request.limit > max_limit) {
+                    request.errors.push_back("Limit " + *value + " exceeds the " + std::to_string(max_limit) + " neighbours kept per movie");
+                }
+            }
+            else if (shared::utils::matches_option(token, "measure")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "measure", request.errors);
+                if (!value) continue;
+                if (*value == "cosine") request.measure = indexes::SimilarityMeasure::cosine;
+                else if (*value == "adjusted" || *value == "adjusted-cosine") request.measure = indexes::SimilarityMeasure::adjusted_cosine;
+                else request.errors.push_back("Unknown measure: '" + *value + "' (expected cosine or adjusted)");
+            }
+            else {
+                request.errors.push_back("Unknown option: '" + token + "'");
+                while (i < arguments.size() && !shared::utils::token_is_option(arguments[i])) ++i; // skip
+            }
+        }
+
+        if (!has_movie && !request.all) {
+            request.errors.emplace_back("similar requires a movie id (or --all)");
+        }
+        request.ok = request.errors.empty();
+        return request;
+    }
+
+    void run_similar(std::ostream& out, models::Catalog& catalog, const SimilarRequest& request) {
+        auto& index = similarity_index(catalog, request.measure);
+
+        if (request.all) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto computed = index.precompute();
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            out << "Computed neighbours for " << computed << " movies in " << elapsed.count() << " ms ("
+                << index.cached_items() << " cached)\n";
+            return;
+        }
+
+        const auto row = catalog.row_of_movie.find(request.movie_id);
+        if (row == shared::utils::IdRowMap::npos) {
+            out << "Error: unknown movie id " << request.movie_id << "\n";
+            return;
+        }
+
+        const auto neighbors = index.neighbors(row);
+        if (neighbors.empty()) {
+            out << "No similar movies found for " << request.movie_id << "\n";
+            return;
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(4);
+
+        const auto count = std::min(request.limit, neighbors.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& movie = catalog.movies[neighbors[i].item];
+            out << movie.movie_id << "::" << movie.title << "::" << shared::utils::join(movie.genres, "|")
+                << "::" << neighbors[i].similarity << "\n";
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
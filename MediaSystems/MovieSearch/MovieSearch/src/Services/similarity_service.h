@@ -0,0 +1,42 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file similarity_service.h
+ * @date 2025-09-29
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    // Parsed form of "similar <movie_id> [--limit N] [--measure cosine|adjusted]" or "similar --all".
+    struct SimilarRequest {
+        bool ok = false;
+        bool all = false;
+        int movie_id = 0;
+        std::size_t limit = 10;
+        indexes::SimilarityMeasure measure = indexes::SimilarityMeasure::cosine;
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @brief Parse the tokens after the leading "similar" token
+     * @param arguments Command arguments
+     * @return The request; ok == errors.empty()
+     */
+    SimilarRequest parse_similar_line(const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Print the most similar movies as "id::title::genres::similarity", or precompute all lists
+     * @param out Output stream
+     * @param catalog The resident catalog (ratings and indexes are built on first use)
+     * @param request A parsed request
+     */
+    void run_similar(std::ostream& out, models::Catalog& catalog, const SimilarRequest& request);
+
+}
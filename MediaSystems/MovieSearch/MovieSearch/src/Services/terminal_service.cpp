@@ -7,10 +7,39 @@
 #include <ostream>
 #include <string>
 
+#include "../indexes/facet_index.h"
 #include "../models/Query.h"
 
 
 namespace movie_search::services {
+    namespace
+    {
+        const char* sort_order_name(models::SortOrder order) {
+            switch (order) {
+            case models::SortOrder::id: return "id";
+            case models::SortOrder::title: return "title";
+            case models::SortOrder::year: return "year";
+            default: return "file";
+            }
+        }
+    }
+
+    void print_facets(std::ostream& out, const indexes::FacetCounts& counts, std::size_t limit) {
+        const auto print_list = [&](const char* name, const std::vector<indexes::FacetCount>& list) {
+            out << "  " << name;
+            if (list.empty()) out << " (none)";
+            for (std::size_t i = 0; i < list.size() && i < limit; ++i) {
+                out << (i ? ", " : " ") << list[i].label << " " << list[i].count;
+            }
+            if (list.size() > limit) out << ", ...";
+            out << "\n";
+        };
+        out << "Facets of " << counts.results << " result" << (counts.results == 1 ? "" : "s") << ":\n";
+        print_list("genres :", counts.genres);
+        print_list("decades:", counts.decades);
+        print_list("tags   :", counts.tags);
+    }
+
     void print_query(std::ostream& out, const movie_search::models::Query& query) {
         out << "Parsed movie search (AND semantics):\n";
         out << "  titles : ";
@@ -23,7 +52,25 @@ namespace movie_search::services {
             }
             out << "]\n";
         }
+        out << "  phrases        : ";
+        if (query.title_phrases.empty()) out << "(none)\n";
+        else {
+            out << "[";
+            for (std::size_t i = 0; i < query.title_phrases.size(); ++i) {
+                if (i) out << ", ";
+                out << "\"";
+                for (std::size_t w = 0; w < query.title_phrases[i].words.size(); ++w) {
+                    if (w) out << " ";
+                    out << query.title_phrases[i].words[w];
+                }
+                out << "\"";
+                if (query.title_phrases[i].slop) out << "~" << query.title_phrases[i].slop;
+            }
+            out << "]\n";
+        }
         out << "  year           : " << (query.has_year ? std::to_string(query.year) : "(none)") << "\n";
+        out << "  user           : " << (query.has_user ? std::to_string(query.user_id) : "(none)") << "\n";
+        out << "  min users      : " << (query.min_users ? std::to_string(query.min_users) : "(none)") << "\n";
         out << "  genres         : ";
         if (query.genres.empty()) out << "(none)\n";
         else {
@@ -44,6 +91,9 @@ namespace movie_search::services {
             }
             out << "]\n";
         }
+        out << "  sort           : " << sort_order_name(query.sort) << "\n";
+        out << "  rank           : " << (query.rank ? "top " + std::to_string(query.rank_limit) : std::string("(none)")) << "\n";
+        out << "  facets         : " << (query.facets ? "yes" : "no") << "\n";
         out << "(parsing of command only)\n";
     }
 }
@@ -5,6 +5,10 @@
  * @date 2025-09-17
  */
 
+#include <cstddef>
+#include <ostream>
+
+#include "../indexes/facet_index.h"
 #include "../models/Query.h"
 
 namespace movie_search::services {
@@ -16,4 +20,12 @@ namespace movie_search::services {
      */
     void print_query(std::ostream& out, const movie_search::models::Query& query);
 
+    /**
+     * @brief Print the facet counts of a result set, one line per facet
+     * @param out Output stream to write to
+     * @param counts Facet counts (see indexes::FacetIndex)
+     * @param limit Values shown per facet
+     */
+    void print_facets(std::ostream& out, const indexes::FacetCounts& counts, std::size_t limit = 10);
+
 }
\ No newline at end of file
@@ -0,0 +1,190 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file training_service.cpp
+ * @date 2025-09-30
+ */
+
+#include "training_service.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+
+#include "catalog_service.h"
+#include "cmdline_utils.h"
+#include "rating_parser.h"
+#include "splits/rating_folds.h"
+
+namespace movie_search::services {
+    namespace {
+        void parse_count(const std::vector<std::string>& args, std::size_t& i, const std::string& name,
+            std::size_t& target, std::vector<std::string>& errors) {
+            const auto value = shared::utils::collect_single_value(args, i, name, errors);
+            if (!value) return;
+            try {
+                const auto parsed = std::stoi(*value);
+                if (parsed <= 0) throw std::out_of_range(name);
+                target = static_cast<std::size_t>(parsed);
+            }
+            catch (...) {
+                errors.push_back("Invalid value for --" + name + ": '" + *value + "'");
+            }
+        }
+
+        void print_iteration(std::ostream& out, const recommender::IterationReport& report, std::size_t threads) {
+            out << "iteration " << report.iteration
+                << ": train RMSE " << std::setprecision(4) << report.train_rmse
+                << ", " << std::setprecision(3) << report.seconds << " s, "
+                << std::setprecision(0) << report.ratings_per_second_per_core << " ratings/sec/core ("
+                << threads << (threads == 1 ? " thread" : " threads") << ")\n";
+        }
+    }
+
+    TrainRequest parse_train_line(const std::vector<std::string>& arguments) {
+        TrainRequest request;
+
+        std::size_t i = 0;
+        while (i < arguments.size()) {
+            const std::string& token = arguments[i++];
+
+            if (!shared::utils::token_is_option(token)) {
+                request.errors.push_back("Unexpected token: '" + token + "'");
+            }
+            else if (shared::utils::matches_option(token, "factors")) {
+                parse_count(arguments, i, "factors", request.options.factors, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "iterations")) {
+                parse_count(arguments, i, "iterations", request.options.iterations, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "threads")) {
+                parse_count(arguments, i, "threads", request.options.threads, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "folds")) {
+                parse_count(arguments, i, "folds", request.folds, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "fold")) {
+                parse_count(arguments, i, "fold", request.fold, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "lambda")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "lambda", request.errors);
+                if (!value) continue;
+                try {
+                    request.options.lambda = std::stof(*value);
+                    if (request.options.lambda <= 0.0f) throw std::out_of_range("lambda");
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid value for --lambda: '" + *value + "'");
+                }
+            }
+            else if (shared::utils::matches_option(token, "train")) {
+                if (const auto value = shared::utils::collect_single_value(arguments, i, "train", request.errors)) request.train_file = *value;
+            }
+            else if (shared::utils::matches_option(token, "test")) {
+                if (const auto value = shared::utils::collect_single_value(arguments, i, "test", request.errors)) request.test_file = *value;
+            }
+            else {
+                request.errors.push_back("Unknown option: '" + token + "'");
+                while (i < arguments.size() && !shared::utils::token_is_option(arguments[i])) ++i; // skip
+            }
+        }
+
+        if (request.train_file.empty() != request.test_file.empty()) {
+            request.errors.emplace_back("--train and --test must be given together");
+        }
+        if (request.fold > request.folds) {
+            request.errors.push_back("--fold must be between 1 and " + std::to_string(request.folds));
+        }
+        request.ok = request.errors.empty();
+        return request;
+    }
+
+    PredictRequest parse_predict_line(const std::vector<std::string>& arguments) {
+        PredictRequest request;
+        if (arguments.size() != 2) {
+            request.errors.emplace_back("predict expects <user_id> <movie_id>");
+            return request;
+        }
+        try {
+            request.user_id = std::stoi(arguments[0]);
+            request.movie_id = std::stoi(arguments[1]);
+        }
+        catch (...) {
+            request.errors.push_back("Invalid ids: '" + arguments[0] + "' '" + arguments[1] + "'");
+        }
+        request.ok = request.errors.empty();
+        return request;
+    }
+
+    void run_train(std::ostream& out, models::Catalog& catalog, const TrainRequest& request) {
+        ensure_movies(catalog);
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed;
+
+        const auto threads = std::max<std::size_t>(request.options.threads ? request.options.threads : std::thread::hardware_concurrency(), 1);
+        auto options = request.options;
+        options.threads = threads;
+        const auto fit = [&](const indexes::RatingMatrix& matrix) {
+            catalog.factor_model.reset();
+            catalog.factor_model = recommender::train_als(matrix, options, [&](const recommender::IterationReport& report) {
+                print_iteration(out, report, threads);
+            });
+        };
+
+        double test_rmse = 0.0;
+        std::size_t evaluated = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        if (!request.train_file.empty()) {
+            const auto train = movie_parser::parsers::load_ratings(request.train_file, &catalog.parse_errors);
+            const auto test = movie_parser::parsers::load_ratings(request.test_file, &catalog.parse_errors);
+            out << "Training on " << train.size() << " ratings from " << request.train_file
+                << ", testing on " << test.size() << " from " << request.test_file << "\n";
+
+            fit(indexes::build_rating_matrix(train, catalog.row_of_movie, catalog.movies.size()));
+            test_rmse = recommender::rmse(*catalog.factor_model, test, catalog.row_of_movie, &evaluated);
+        }
+        else {
+            ensure_ratings(catalog);
+            const auto folds = movie_parser::splits::FoldIndex::k_fold(catalog.ratings, request.folds, movie_parser::splits::FoldAssignment::hash);
+            const auto fold = request.fold - 1;
+            const auto train_rows = folds.train_rows(fold);
+            out << "Training on " << folds.train_size(fold) << " ratings (fold " << request.fold << " of " << request.folds
+                << "), testing on " << folds.test_size(fold) << "\n";
+
+            fit(indexes::build_rating_matrix(catalog.ratings, train_rows, catalog.row_of_movie, catalog.movies.size()));
+            test_rmse = recommender::rmse(*catalog.factor_model, catalog.ratings, folds.test_rows(fold), catalog.row_of_movie, &evaluated);
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        out << "Test RMSE: " << std::setprecision(4) << test_rmse << " over " << evaluated << " ratings ("
+            << std::setprecision(2) << elapsed.count() << " s total)\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    void run_predict(std::ostream& out, models::Catalog& catalog, const PredictRequest& request) {
+        if (!catalog.factor_model) {
+            out << "Error: no trained model (run train first)\n";
+            return;
+        }
+        const auto movie = catalog.row_of_movie.find(request.movie_id);
+        if (movie == shared::utils::IdRowMap::npos) {
+            out << "Error: unknown movie id " << request.movie_id << "\n";
+            return;
+        }
+
+        const auto& model = *catalog.factor_model;
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << request.user_id << "::" << catalog.movies[movie].title << "::"
+            << std::fixed << std::setprecision(2) << model.predict(request.user_id, movie);
+        if (!model.knows_user(request.user_id)) out << " (unknown user, global mean)";
+        out << "\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file training_service.h
+ * @date 2025-09-30
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+#include "../recommender/factor_model.h"
+
+namespace movie_search::services {
+
+    // Parsed form of "train [options]".
+    struct TrainRequest {
+        bool ok = false;
+        recommender::AlsOptions options;
+        std::size_t folds = 5;          // k-fold split of ratings.dat when no files are given
+        std::size_t fold = 1;           // 1-based test fold
+        std::string train_file;         // e.g. r1.train written by splitratings
+        std::string test_file;          // e.g. r1.test
+        std::vector<std::string> errors;
+    };
+
+    // Parsed form of "predict <user_id> <movie_id>".
+    struct PredictRequest {
+        bool ok = false;
+        int user_id = 0;
+        int movie_id = 0;
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @brief Parse the tokens after the leading "train" token
+     * @return The request; ok == errors.empty()
+     */
+    TrainRequest parse_train_line(const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Parse the tokens after the leading "predict" token
+     * @return The request; ok == errors.empty()
+     */
+    PredictRequest parse_predict_line(const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Fit an ALS model on the training split, report throughput and test RMSE, keep it resident
+     * @param out Output stream
+     * @param catalog The resident catalog; receives the model
+     * @param request A parsed request
+     */
+    void run_train(std::ostream& out, models::Catalog& catalog, const TrainRequest& request);
+
+    /**
+     * @brief Print the predicted rating of the resident model
+     */
+    void run_predict(std::ostream& out, models::Catalog& catalog, const PredictRequest& request);
+
+}
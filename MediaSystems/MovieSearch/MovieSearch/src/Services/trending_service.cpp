@@ -0,0 +1,149 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file trending_service.cpp
+ * @date 2025-10-02
+ */
+
+#include "trending_service.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+#include "catalog_service.h"
+#include "cmdline_utils.h"
+#include "date_utils.h"
+#include "string_utils.h"
+
+namespace movie_search::services {
+    namespace {
+        void parse_day(const std::vector<std::string>& args, std::size_t& i, const std::string& name, bool last,
+            std::optional<int>& target, std::vector<std::string>& errors) {
+            const auto value = shared::utils::collect_single_value(args, i, name, errors);
+            if (!value) return;
+            const auto range = shared::utils::parse_date_range(*value);
+            if (!range) {
+                errors.push_back("Invalid date for --" + name + ": '" + *value + "' (expected YYYY, YYYY-MM or YYYY-MM-DD)");
+                return;
+            }
+            target = last ? range->last : range->first;
+        }
+    }
+
+    TrendingRequest parse_trending_line(const std::vector<std::string>& arguments) {
+        TrendingRequest request;
+
+        std::size_t i = 0;
+        while (i < arguments.size()) {
+            const std::string& token = arguments[i++];
+
+            if (!shared::utils::token_is_option(token)) {
+                request.errors.push_back("Unexpected token: '" + token + "'");
+            }
+            else if (shared::utils::matches_option(token, "since")) {
+                parse_day(arguments, i, "since", false, request.since, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "until")) {
+                parse_day(arguments, i, "until", true, request.until, request.errors);
+            }
+            else if (shared::utils::matches_option(token, "by")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "by", request.errors);
+                if (!value) continue;
+                if (*value == "count") request.order = TrendingOrder::count;
+                else if (*value == "mean") request.order = TrendingOrder::mean;
+                else request.errors.push_back("Unknown order: '" + *value + "' (expected count or mean)");
+            }
+            else if (shared::utils::matches_option(token, "source")) {
+                const auto value = shared::utils::collect_single_value(arguments, i, "source", request.errors);
+                if (!value) continue;
+                if (*value == "ratings") request.source = TrendingSource::ratings;
+                else if (*value == "tags") request.source = TrendingSource::tags;
+                else request.errors.push_back("Unknown source: '" + *value + "' (expected ratings or tags)");
+            }
+            else if (shared::utils::matches_option(token, "limit") || shared::utils::matches_option(token, "min-count")) {
+                const auto name = token.substr(token.find_first_not_of('-'));
+                const auto value = shared::utils::collect_single_value(arguments, i, name, request.errors);
+                if (!value) continue;
+                try {
+                    const auto parsed = std::stoi(*value);
+                    if (parsed <= 0) throw std::out_of_range(name);
+                    (name == "limit" ? request.limit : request.min_count) = static_cast<std::size_t>(parsed);
+                }
+                catch (...) {
+                    request.errors.push_back("Invalid value for --" + name + ": '" + *value + "'");
+                }
+            }
+            else {
+                request.errors.push_back("Unknown option: '" + token + "'");
+                while (i < arguments.size() && !shared::utils::token_is_option(arguments[i])) ++i; // skip
+            }
+        }
+
+        if (request.source == TrendingSource::tags && request.order == TrendingOrder::mean) {
+            request.errors.emplace_back("--by mean needs --source ratings (tags have no value)");
+        }
+        if (request.since && request.until && *request.since > *request.until) {
+            request.errors.emplace_back("--since is after --until");
+        }
+        request.ok = request.errors.empty();
+        return request;
+    }
+
+    void run_trending(std::ostream& out, models::Catalog& catalog, const TrendingRequest& request) {
+        const bool ratings = request.source == TrendingSource::ratings;
+        const auto& index = ratings ? ensure_rating_times(catalog) : ensure_tag_times(catalog);
+        if (index.empty()) {
+            out << "No " << (ratings ? "ratings" : "tags") << " loaded\n";
+            return;
+        }
+
+        const auto first = request.since.value_or(index.first_day());
+        const auto last = request.until.value_or(index.last_day());
+        const auto totals = index.aggregate(first, last);
+        const auto min_count = request.min_count ? request.min_count : (request.order == TrendingOrder::mean ? 10 : 1);
+
+        std::vector<std::uint32_t> items;
+        for (std::size_t item = 0; item < totals.counts.size(); ++item) {
+            if (totals.counts[item] >= min_count) items.push_back(static_cast<std::uint32_t>(item));
+        }
+
+        const auto mean = [&](std::uint32_t item) { return totals.sums[item] / totals.counts[item]; };
+        const auto ranks_before = [&](std::uint32_t a, std::uint32_t b) {
+            if (request.order == TrendingOrder::mean && mean(a) != mean(b)) return mean(a) > mean(b);
+            if (totals.counts[a] != totals.counts[b]) return totals.counts[a] > totals.counts[b];
+            return a < b;
+        };
+        const auto shown = std::min(request.limit, items.size());
+        std::partial_sort(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(shown), items.end(), ranks_before);
+
+        const auto window_first = std::max(first, index.first_day());
+        const auto window_last = std::min(last, index.last_day());
+        if (window_first > window_last) {
+            // The requested window misses the data entirely; clamping would print an inverted range,
+            // so only the bounds that were asked for are shown
+            out << "Window";
+            if (request.since) out << " from " << shared::utils::format_day(*request.since);
+            if (request.until) out << " until " << shared::utils::format_day(*request.until);
+            out << " lies outside the data range " << shared::utils::format_day(index.first_day()) << " .. "
+                << shared::utils::format_day(index.last_day()) << ": 0" << (ratings ? " ratings" : " tags") << "\n";
+            return;
+        }
+        out << "Window " << shared::utils::format_day(window_first) << " .. "
+            << shared::utils::format_day(window_last) << ": " << totals.events
+            << (ratings ? " ratings" : " tags") << "\n";
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(2);
+        for (std::size_t i = 0; i < shown; ++i) {
+            const auto& movie = catalog.movies[items[i]];
+            out << movie.movie_id << "::" << movie.title << "::" << shared::utils::join(movie.genres, "|")
+                << "::" << totals.counts[items[i]];
+            if (ratings) out << "::" << mean(items[i]);
+            out << "\n";
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file trending_service.h
+ * @date 2025-10-02
+ */
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    enum class TrendingSource { ratings, tags };
+    enum class TrendingOrder { count, mean };
+
+    // Parsed form of "trending [--since d] [--until d] [--by count|mean] [--source ratings|tags] ...".
+    struct TrendingRequest {
+        bool ok = false;
+        std::optional<int> since;       // first day (inclusive)
+        std::optional<int> until;       // last day (inclusive)
+        TrendingSource source = TrendingSource::ratings;
+        TrendingOrder order = TrendingOrder::count;
+        std::size_t limit = 10;
+        std::size_t min_count = 0;      // 0 = default (1 for count, 10 for mean)
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @brief Parse the tokens after the leading "trending" token
+     *
+     * Dates are "YYYY", "YYYY-MM" or "YYYY-MM-DD"; --since uses the first and --until the last
+     * day they cover.
+     *
+     * @return The request; ok == errors.empty()
+     */
+    TrendingRequest parse_trending_line(const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Print the top movies of a time window as "id::title::genres::count[::mean]"
+     * @param out Output stream
+     * @param catalog The resident catalog (time buckets are built on first use)
+     * @param request A parsed request
+     */
+    void run_trending(std::ostream& out, models::Catalog& catalog, const TrendingRequest& request);
+
+}
@@ -0,0 +1,106 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file user_service.cpp
+ * @date 2025-10-04
+ */
+
+#include "user_service.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <span>
+
+#include "catalog_service.h"
+
+namespace movie_search::services {
+
+    namespace
+    {
+        std::span<const std::uint32_t> rows_of(const indexes::UserAdjacency& adjacency, int user_id) {
+            const auto user = adjacency.user_row(user_id);
+            if (user == shared::utils::IdRowMap::npos) return {};
+            return adjacency.movie_rows(user);
+        }
+    }
+
+    std::vector<std::uint32_t> user_movie_rows(models::Catalog& catalog, int user_id) {
+        ensure_tags(catalog);
+        ensure_ratings(catalog);
+        // Both lists are sorted by movie row; a user may tag one movie several times
+        const auto tagged = rows_of(catalog.user_tags, user_id);
+        const auto rated = rows_of(catalog.user_ratings, user_id);
+        std::vector<std::uint32_t> rows;
+        rows.reserve(tagged.size() + rated.size());
+        std::set_union(tagged.begin(), tagged.end(), rated.begin(), rated.end(), std::back_inserter(rows));
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        return rows;
+    }
+
+    void run_user_tags(std::ostream& out, models::Catalog& catalog, const std::vector<std::string>& arguments) {
+        if (arguments.size() != 1) {
+            out << "Error: usertags expects one user id\n";
+            return;
+        }
+        int user_id = 0;
+        try {
+            user_id = std::stoi(arguments.front());
+        }
+        catch (...) {
+            out << "Error: Invalid user id: '" << arguments.front() << "'\n";
+            return;
+        }
+
+        ensure_tags(catalog);
+        ensure_ratings(catalog);
+        const auto tag_user = catalog.user_tags.user_row(user_id);
+        const auto rating_user = catalog.user_ratings.user_row(user_id);
+        if (tag_user == shared::utils::IdRowMap::npos && rating_user == shared::utils::IdRowMap::npos) {
+            out << "Error: unknown user id " << user_id << "\n";
+            return;
+        }
+
+        std::span<const std::uint32_t> tagged, tag_ids, rated, codes;
+        if (tag_user != shared::utils::IdRowMap::npos) {
+            tagged = catalog.user_tags.movie_rows(tag_user);
+            tag_ids = catalog.user_tags.values(tag_user);
+        }
+        if (rating_user != shared::utils::IdRowMap::npos) {
+            rated = catalog.user_ratings.movie_rows(rating_user);
+            codes = catalog.user_ratings.values(rating_user);
+        }
+
+        std::size_t tagged_movies = 0;
+        for (std::size_t i = 0; i < tagged.size(); ++i) {
+            if (i == 0 || tagged[i] != tagged[i - 1]) ++tagged_movies;
+        }
+        out << "User " << user_id << ": " << tagged.size() << " tag" << (tagged.size() == 1 ? "" : "s") << " on "
+            << tagged_movies << " movie" << (tagged_movies == 1 ? "" : "s") << ", " << rated.size() << " rating"
+            << (rated.size() == 1 ? "" : "s") << "\n";
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(1);
+
+        // Both lists are in movie row order, so the ratings are joined with one forward cursor
+        std::size_t rating = 0;
+        for (std::size_t first = 0; first < tagged.size();) {
+            const auto row = tagged[first];
+            const auto& movie = catalog.movies[row];
+            out << movie.movie_id << "::" << movie.title << ": ";
+            std::size_t last = first;
+            for (; last < tagged.size() && tagged[last] == row; ++last) {
+                if (last != first) out << ", ";
+                out << catalog.tags[tag_ids[last]].tag;
+            }
+            while (rating < rated.size() && rated[rating] < row) ++rating;
+            if (rating < rated.size() && rated[rating] == row) out << " (rated " << static_cast<double>(codes[rating]) * 0.5 << ")";
+            out << "\n";
+            first = last;
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
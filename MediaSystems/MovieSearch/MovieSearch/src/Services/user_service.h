@@ -0,0 +1,37 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file user_service.h
+ * @date 2025-10-04
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../models/Catalog.h"
+
+namespace movie_search::services {
+
+    /**
+     * @brief Movies a user rated or tagged, from the user-major indexes (loads tags and ratings if needed)
+     * @param catalog The resident catalog
+     * @param user_id The user
+     * @return Movie rows, ascending and distinct; empty for an unknown user
+     */
+    std::vector<std::uint32_t> user_movie_rows(models::Catalog& catalog, int user_id);
+
+    /**
+     * @brief Handle "usertags <user_id>"
+     *
+     * Prints every movie the user tagged with the user's tags (and rating, if any), in movies.dat
+     * order, after a summary of the user's tag and rating counts.
+     *
+     * @param out Output stream
+     * @param catalog The resident catalog
+     * @param arguments Tokens after the leading "usertags" token
+     */
+    void run_user_tags(std::ostream& out, models::Catalog& catalog, const std::vector<std::string>& arguments);
+
+}
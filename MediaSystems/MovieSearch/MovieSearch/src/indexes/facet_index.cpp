@@ -0,0 +1,88 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file facet_index.cpp
+ * @date 2025-10-04
+ */
+
+#include "facet_index.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "memory_usage.h"
+#include "simd.h"
+#include "text_fold.h"
+
+namespace movie_search::indexes {
+
+    FacetIndex::FacetIndex(const std::vector<movie_parser::models::Movie>& movies,
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t top_tags) : words_((movies.size() + 63) / 64) {
+        // Facet values with their movie rows (ordered maps keep the labels sorted)
+        std::map<std::string, std::vector<std::uint32_t>> genres;
+        std::map<int, std::vector<std::uint32_t>> decades;
+        for (std::size_t row = 0; row < movies.size(); ++row) {
+            const auto movie_row = static_cast<std::uint32_t>(row);
+            for (const auto& genre : movies[row].genres) genres[std::string(genre)].push_back(movie_row);
+            if (movies[row].year) decades[*movies[row].year / 10 * 10].push_back(movie_row);
+        }
+
+        std::unordered_map<std::string, std::vector<std::uint32_t>> tag_rows;
+        for (const auto& tag : tags) {
+            const auto movie = row_of_movie.find(tag.movie_id);
+            if (movie == shared::utils::IdRowMap::npos) continue;
+            auto& rows = tag_rows[shared::utils::fold_text(tag.tag)];
+            if (rows.empty() || rows.back() != movie) rows.push_back(movie);
+        }
+        std::vector<std::pair<std::string, std::vector<std::uint32_t>>> ranked_tags;
+        ranked_tags.reserve(tag_rows.size());
+        for (auto& [label, rows] : tag_rows) {
+            std::sort(rows.begin(), rows.end());
+            rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+            ranked_tags.emplace_back(label, std::move(rows));
+        }
+        const auto kept = std::min(top_tags, ranked_tags.size());
+        std::partial_sort(ranked_tags.begin(), ranked_tags.begin() + static_cast<std::ptrdiff_t>(kept), ranked_tags.end(),
+            [](const auto& a, const auto& b) { return a.second.size() != b.second.size() ? a.second.size() > b.second.size() : a.first < b.first; });
+        ranked_tags.resize(kept);
+
+        labels_.reserve(genres.size() + decades.size() + ranked_tags.size());
+        bits_.assign((genres.size() + decades.size() + ranked_tags.size()) * words_, 0);
+        const auto add_facet = [&](std::string label, const std::vector<std::uint32_t>& rows) {
+            auto* bits = bitmap(labels_.size());
+            for (const auto row : rows) bits[row >> 6] |= std::uint64_t{ 1 } << (row & 63);
+            labels_.push_back(std::move(label));
+        };
+        for (const auto& [genre, rows] : genres) add_facet(genre, rows);
+        genre_end_ = labels_.size();
+        for (const auto& [decade, rows] : decades) add_facet(std::to_string(decade) + "s", rows);
+        decade_end_ = labels_.size();
+        for (const auto& [tag, rows] : ranked_tags) add_facet(tag, rows);
+    }
+
+    FacetCounts FacetIndex::count(std::span<const std::uint32_t> rows) const {
+        FacetCounts counts;
+        counts.results = rows.size();
+        std::vector<std::uint64_t> result(words_, 0);
+        for (const auto row : rows) result[row >> 6] |= std::uint64_t{ 1 } << (row & 63);
+
+        const auto collect = [&](std::size_t first, std::size_t last, std::vector<FacetCount>& out, bool by_count) {
+            for (auto facet = first; facet < last; ++facet) {
+                const auto count = shared::utils::popcount_and(result.data(), bitmap(facet), words_);
+                if (count) out.push_back({ labels_[facet], static_cast<std::uint32_t>(count) });
+            }
+            if (by_count) std::stable_sort(out.begin(), out.end(), [](const FacetCount& a, const FacetCount& b) { return a.count > b.count; });
+        };
+        collect(0, genre_end_, counts.genres, true);
+        collect(genre_end_, decade_end_, counts.decades, false);
+        collect(decade_end_, labels_.size(), counts.tags, true);
+        return counts;
+    }
+
+    std::size_t FacetIndex::memory_bytes() const {
+        return shared::utils::vector_bytes(labels_) + shared::utils::vector_bytes(bits_);
+    }
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file facet_index.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Movie.h"
+#include "MovieTag.h"
+#include "id_row_map.h"
+
+namespace movie_search::indexes {
+
+    // Number of results with one facet value.
+    struct FacetCount {
+        std::string label;
+        std::uint32_t count;
+    };
+
+    // Facet counts of a result set by descending count (decades chronologically); values with no results are left out.
+    struct FacetCounts {
+        std::size_t results = 0;
+        std::vector<FacetCount> genres;
+        std::vector<FacetCount> decades;
+        std::vector<FacetCount> tags;
+    };
+
+    /**
+     * @brief Per-value movie bitmaps for result facets: every genre, every release decade and the
+     *        most used tags (folded, by number of movies).
+     *
+     * Counting a result set sets its rows in one bitmap and intersects it with every facet bitmap
+     * using popcount_and (simd.h), so the cost is (facet values x movies / 64) word operations no
+     * matter how many movies matched, and no genre or tag string is touched per query.
+     */
+    class FacetIndex {
+    public:
+        FacetIndex() = default;
+
+        /**
+         * @brief Build the bitmaps
+         * @param movies Parsed movies (rows)
+         * @param tags Parsed tags; tags of unknown movies are skipped
+         * @param row_of_movie Movie id -> movie row
+         * @param top_tags Number of tags that get a bitmap
+         */
+        FacetIndex(const std::vector<movie_parser::models::Movie>& movies,
+            const std::vector<movie_parser::models::MovieTag>& tags,
+            const shared::utils::IdRowMap& row_of_movie,
+            std::size_t top_tags = 50);
+
+        /**
+         * @brief Facet counts of a result set
+         * @param rows Distinct result rows, in any order
+         * @return Counts per genre, decade and top tag
+         */
+        FacetCounts count(std::span<const std::uint32_t> rows) const;
+
+        std::size_t facet_count() const { return labels_.size(); }
+        std::size_t memory_bytes() const;
+
+    private:
+        std::uint64_t* bitmap(std::size_t facet) { return bits_.data() + facet * words_; }
+        const std::uint64_t* bitmap(std::size_t facet) const { return bits_.data() + facet * words_; }
+
+        std::size_t words_ = 0;                 // bitmap words per facet value
+        std::vector<std::string> labels_;       // genres, then decades, then tags
+        std::size_t genre_end_ = 0;
+        std::size_t decade_end_ = 0;
+        std::vector<std::uint64_t> bits_;       // labels_.size() x words_
+    };
+
+}
@@ -0,0 +1,96 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file item_similarity.cpp
+ * @date 2025-09-29
+ */
+
+#include "item_similarity.h"
+
+#include <cmath>
+
+#include "memory_usage.h"
+
+namespace movie_search::indexes {
+
+    ItemSimilarityIndex::ItemSimilarityIndex(const RatingMatrix& matrix, SimilarityOptions options)
+        : matrix_(matrix), options_(options),
+          user_values_(matrix.by_user.values), item_values_(matrix.by_item.values),
+          norms_(matrix.by_item.rows, 0.0f),
+          lists_(matrix.by_item.rows) {
+        if (options_.measure == SimilarityMeasure::adjusted_cosine) {
+            for (std::size_t user = 0; user < matrix_.by_user.rows; ++user) {
+                for (auto i = matrix_.by_user.offsets[user]; i < matrix_.by_user.offsets[user + 1]; ++i) {
+                    user_values_[i] -= matrix_.user_means[user];
+                }
+            }
+            for (std::size_t item = 0; item < matrix_.by_item.rows; ++item) {
+                for (auto i = matrix_.by_item.offsets[item]; i < matrix_.by_item.offsets[item + 1]; ++i) {
+                    item_values_[i] -= matrix_.user_means[matrix_.by_item.columns[i]];
+                }
+            }
+        }
+
+        for (std::size_t item = 0; item < matrix_.by_item.rows; ++item) {
+            double sum = 0.0;
+            for (auto i = matrix_.by_item.offsets[item]; i < matrix_.by_item.offsets[item + 1]; ++i) {
+                sum += static_cast<double>(item_values_[i]) * item_values_[i];
+            }
+            norms_[item] = static_cast<float>(std::sqrt(sum));
+        }
+    }
+
+    std::vector<Neighbor> ItemSimilarityIndex::compute(std::uint32_t item, Workspace& workspace) const {
+        const auto& by_item = matrix_.by_item;
+        const auto& by_user = matrix_.by_user;
+        std::vector<Neighbor> result;
+        if (norms_[item] == 0.0f) return result;
+
+        workspace.dot.resize(by_item.rows, 0.0f);
+        workspace.common.resize(by_item.rows, 0);
+        workspace.touched.clear();
+
+        for (auto i = by_item.offsets[item]; i < by_item.offsets[item + 1]; ++i) {
+            const auto user = by_item.columns[i];
+            const auto weight = item_values_[i];
+            for (auto j = by_user.offsets[user]; j < by_user.offsets[user + 1]; ++j) {
+                const auto other = by_user.columns[j];
+                if (workspace.common[other]++ == 0) workspace.touched.push_back(other);
+                workspace.dot[other] += weight * user_values_[j];
+            }
+        }
+
+        for (const auto other : workspace.touched) {
+            if (other != item && workspace.common[other] >= options_.min_common && norms_[other] > 0.0f) {
+                const auto similarity = workspace.dot[other] / (norms_[item] * norms_[other]);
+                if (similarity > 0.0f) result.push_back({ other, similarity });
+            }
+            workspace.dot[other] = 0.0f;
+            workspace.common[other] = 0;
+        }
+
+        const auto by_similarity = [](const Neighbor& a, const Neighbor& b) {
+            return a.similarity != b.similarity ? a.similarity > b.similarity : a.item < b.item;
+        };
+        keep_top_k(result, options_.top_k, by_similarity);
+        return result;
+    }
+
+    std::span<const Neighbor> ItemSimilarityIndex::neighbors(std::uint32_t item) {
+        return lists_.get<Workspace>(item, [this](std::uint32_t row, Workspace& workspace) { return compute(row, workspace); });
+    }
+
+    std::size_t ItemSimilarityIndex::precompute() {
+        return lists_.precompute<Workspace>(options_.block_size, options_.threads,
+            [this](std::uint32_t row, Workspace& workspace) { return compute(row, workspace); });
+    }
+
+    std::size_t ItemSimilarityIndex::cached_items() const {
+        return lists_.cached_rows();
+    }
+
+    std::size_t ItemSimilarityIndex::memory_bytes() const {
+        return shared::utils::vector_bytes(user_values_) + shared::utils::vector_bytes(item_values_)
+            + shared::utils::vector_bytes(norms_) + lists_.memory_bytes();
+    }
+
+}
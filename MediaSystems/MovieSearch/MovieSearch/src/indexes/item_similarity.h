@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file item_similarity.h
+ * @date 2025-09-29
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "rating_matrix.h"
+#include "row_list_cache.h"
+
+namespace movie_search::indexes {
+
+    enum class SimilarityMeasure {
+        cosine,          // cosine over the raw rating vectors
+        adjusted_cosine  // cosine after subtracting every user's mean rating
+    };
+
+    // One entry of a neighbour list.
+    struct Neighbor {
+        std::uint32_t item;
+        float similarity;
+    };
+
+    struct SimilarityOptions {
+        SimilarityMeasure measure = SimilarityMeasure::cosine;
+        std::size_t top_k = 50;        // neighbours kept per item
+        std::size_t min_common = 2;    // minimum number of co-rating users
+        std::size_t block_size = 64;   // items per work unit in precompute
+        std::size_t threads = 0;       // 0 = std::thread::hardware_concurrency()
+    };
+
+    /**
+     * @brief Top-K item-item similarity over a RatingMatrix, cached per item.
+     *
+     * The similarities of item i against every other item are accumulated in one sparse pass:
+     * for each user u in column i (CSC) and each item j in row u (CSR), acc[j] += r(u,i) * r(u,j).
+     * Lists are computed on first request or in bulk by precompute(); both may run concurrently.
+     * The matrix must outlive the index.
+     */
+    class ItemSimilarityIndex {
+    public:
+        ItemSimilarityIndex(const RatingMatrix& matrix, SimilarityOptions options);
+
+        /**
+         * @brief Neighbours of an item, most similar first (computed and cached on a miss)
+         * @param item Item (movie row) of the rating matrix
+         * @return At most top_k neighbours with a positive similarity
+         */
+        std::span<const Neighbor> neighbors(std::uint32_t item);
+
+        /**
+         * @brief Compute the lists of all items not cached yet, in blocks over worker threads
+         * @return Number of items computed by this call
+         */
+        std::size_t precompute();
+
+        std::size_t cached_items() const;
+
+        // Heap bytes of the centred values, norms and cached lists (not of the matrix).
+        std::size_t memory_bytes() const;
+        const SimilarityOptions& options() const { return options_; }
+
+    private:
+        // Per-thread scratch space: a dense accumulator plus the list of touched items.
+        struct Workspace {
+            std::vector<float> dot;
+            std::vector<std::uint32_t> common;
+            std::vector<std::uint32_t> touched;
+        };
+
+        std::vector<Neighbor> compute(std::uint32_t item, Workspace& workspace) const;
+
+        const RatingMatrix& matrix_;
+        SimilarityOptions options_;
+        std::vector<float> user_values_;   // values of matrix_.by_user, centred for adjusted cosine
+        std::vector<float> item_values_;   // values of matrix_.by_item, centred for adjusted cosine
+        std::vector<float> norms_;         // L2 norm of every item column
+        RowListCache<Neighbor> lists_;
+    };
+
+}
@@ -0,0 +1,162 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file positional_index.cpp
+ * @date 2025-10-04
+ */
+
+#include "positional_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "string_utils.h"
+#include "memory_usage.h"
+#include "text_fold.h"
+
+namespace movie_search::indexes {
+
+    namespace
+    {
+        void write_varint(std::vector<std::uint8_t>& out, std::uint32_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        std::uint32_t read_varint(const std::uint8_t*& in) {
+            std::uint32_t value = 0;
+            for (int shift = 0;; shift += 7) {
+                const auto byte = *in++;
+                value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+        }
+
+        // Decodes one word's stream a posting at a time.
+        struct PostingReader {
+            const std::uint8_t* in;
+            const std::uint8_t* end;
+            std::uint32_t row = 0;
+            std::vector<std::uint32_t> positions;
+
+            PostingReader(const std::uint8_t* first, const std::uint8_t* last) : in(first), end(last) {}
+
+            bool next() {
+                if (in == end) return false;
+                row += read_varint(in);
+                positions.resize(read_varint(in));
+                std::uint32_t position = 0;
+                for (auto& value : positions) value = position += read_varint(in);
+                return true;
+            }
+        };
+    }
+
+    void PositionalIndex::add(std::uint32_t row, std::string_view text) {
+        occurrences_.clear();
+        std::uint32_t position = 0;
+        std::size_t start = 0;
+        while (start < text.size()) {
+            auto end = text.find(' ', start);
+            if (end == std::string_view::npos) end = text.size();
+            if (end > start) {
+                folded_.clear();
+                shared::utils::append_folded(text.substr(start, end - start), folded_);
+                const auto [word, inserted] = word_ids_.try_emplace(folded_, static_cast<std::uint32_t>(word_ids_.size()));
+                if (inserted) {
+                    streams_.emplace_back();
+                    last_rows_.push_back(0);
+                }
+                occurrences_.emplace_back(word->second, position++);
+            }
+            start = end + 1;
+        }
+
+        // One posting per distinct word: row delta, count, position deltas
+        std::sort(occurrences_.begin(), occurrences_.end());
+        for (std::size_t i = 0; i < occurrences_.size();) {
+            const auto word = occurrences_[i].first;
+            auto j = i;
+            while (j < occurrences_.size() && occurrences_[j].first == word) ++j;
+            auto& stream = streams_[word];
+            write_varint(stream, row - last_rows_[word]);
+            last_rows_[word] = row;
+            write_varint(stream, static_cast<std::uint32_t>(j - i));
+            std::uint32_t previous = 0;
+            for (; i < j; ++i) {
+                write_varint(stream, occurrences_[i].second - previous);
+                previous = occurrences_[i].second;
+            }
+        }
+    }
+
+    void PositionalIndex::finish() {
+        offsets_.assign(streams_.size() + 1, 0);
+        std::size_t total = 0;
+        for (const auto& stream : streams_) total += stream.size();
+        bytes_.clear();
+        bytes_.reserve(total);
+        for (std::size_t word = 0; word < streams_.size(); ++word) {
+            bytes_.insert(bytes_.end(), streams_[word].begin(), streams_[word].end());
+            offsets_[word + 1] = bytes_.size();
+        }
+        streams_ = {};
+        last_rows_ = {};
+        occurrences_ = {};
+        folded_ = {};
+    }
+
+    std::vector<std::uint32_t> PositionalIndex::match(std::span<const std::string_view> folded_words, std::size_t slop,
+        std::uint64_t* postings_read) const {
+        std::vector<std::uint32_t> rows;
+        if (folded_words.empty()) return rows;
+
+        std::vector<PostingReader> readers;
+        readers.reserve(folded_words.size());
+        for (const auto word : folded_words) {
+            const auto it = word_ids_.find(word);
+            if (it == word_ids_.end()) return rows;
+            readers.emplace_back(bytes_.data() + offsets_[it->second], bytes_.data() + offsets_[it->second + 1]);
+        }
+
+        std::uint64_t read = 0;
+        std::vector<std::vector<std::uint32_t>> positions(readers.size());
+        bool more = true;
+        for (auto& reader : readers) {
+            more = more && reader.next();
+            ++read;
+        }
+        while (more) {
+            // Advance every stream to the largest current row; rows present in all are phrase candidates
+            std::uint32_t target = 0;
+            for (const auto& reader : readers) target = std::max(target, reader.row);
+            bool aligned = true;
+            for (auto& reader : readers) {
+                while (reader.row < target && (more = reader.next())) ++read;
+                if (!more) break;
+                aligned = aligned && reader.row == target;
+            }
+            if (!more || !aligned) continue;
+
+            for (std::size_t word = 0; word < readers.size(); ++word) positions[word].swap(readers[word].positions);
+            if (shared::utils::positions_form_phrase(positions, slop)) rows.push_back(target);
+            for (std::size_t word = 0; word < readers.size(); ++word) {
+                positions[word].swap(readers[word].positions);
+                more = more && readers[word].next();
+                ++read;
+            }
+        }
+
+        if (postings_read) *postings_read += read;
+        return rows;
+    }
+
+    std::size_t PositionalIndex::memory_bytes() const {
+        return shared::utils::hash_map_bytes(word_ids_) + shared::utils::vector_bytes(offsets_) + shared::utils::vector_bytes(bytes_)
+            + shared::utils::vector_bytes(streams_) + shared::utils::vector_bytes(last_rows_)
+            + shared::utils::vector_bytes(occurrences_) + shared::utils::string_bytes(folded_);
+    }
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file positional_index.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace movie_search::indexes {
+
+    /**
+     * @brief Positional inverted index of folded words, for phrase and proximity queries.
+     *
+     * The postings of a word are one byte stream of varints: per row the row delta, the number of
+     * occurrences and the position deltas. A phrase is answered by merging the streams of its words
+     * on row and checking the decoded positions, so titles are never tokenized at query time.
+     */
+    class PositionalIndex {
+    public:
+        /**
+         * @brief Index the space-separated words of a text; rows must be added in ascending order
+         */
+        void add(std::uint32_t row, std::string_view text);
+
+        // Concatenate the per-word streams. Call once, after the last add.
+        void finish();
+
+        /**
+         * @brief Rows whose text contains the words in order with at most slop other words in between
+         * @param folded_words Phrase words in folded form, in order
+         * @param slop Extra words allowed inside the phrase (0: adjacent)
+         * @param postings_read Optional counter of the postings decoded
+         * @return Matching rows, ascending
+         */
+        std::vector<std::uint32_t> match(std::span<const std::string_view> folded_words, std::size_t slop,
+            std::uint64_t* postings_read = nullptr) const;
+
+        std::size_t words() const { return word_ids_.size(); }
+        std::size_t bytes() const { return bytes_.size(); }
+
+        // Heap bytes of the word table and streams (and of the build state before finish).
+        std::size_t memory_bytes() const;
+
+    private:
+        struct WordHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view word) const { return std::hash<std::string_view>{}(word); }
+        };
+
+        std::unordered_map<std::string, std::uint32_t, WordHash, std::equal_to<>> word_ids_;
+        std::vector<std::uint64_t> offsets_;                 // per word id, plus the end
+        std::vector<std::uint8_t> bytes_;
+
+        // Build state, released by finish
+        std::vector<std::vector<std::uint8_t>> streams_;
+        std::vector<std::uint32_t> last_rows_;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> occurrences_; // (word id, position) of one text
+        std::string folded_;
+    };
+
+}
@@ -0,0 +1,201 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file rank_index.cpp
+ * @date 2025-10-04
+ */
+
+#include "rank_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "memory_usage.h"
+#include "text_fold.h"
+
+namespace movie_search::indexes {
+
+    namespace
+    {
+        // A query word's position in its posting list.
+        struct Cursor {
+            const std::uint32_t* row;
+            const std::uint32_t* end;
+            const float* impact;
+            float upper;
+        };
+
+        bool better(const ScoredRow& a, const ScoredRow& b) {
+            return a.score != b.score ? a.score > b.score : a.row < b.row;
+        }
+    }
+
+    RankIndex::RankIndex(const std::vector<movie_parser::models::Movie>& movies,
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::span<const std::uint32_t> rating_counts,
+        Bm25Options options) {
+        // (word id, row) per word occurrence, and the document length of every movie
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> occurrences;
+        std::vector<std::uint32_t> lengths(movies.size(), 0);
+        std::string folded;
+        const auto add_words = [&](std::uint32_t row, std::string_view text) {
+            std::size_t start = 0;
+            while (start < text.size()) {
+                auto end = text.find(' ', start);
+                if (end == std::string_view::npos) end = text.size();
+                if (end > start) {
+                    folded.clear();
+                    shared::utils::append_folded(text.substr(start, end - start), folded);
+                    const auto [word, inserted] = word_ids_.try_emplace(folded, static_cast<std::uint32_t>(word_ids_.size()));
+                    occurrences.emplace_back(word->second, row);
+                    ++lengths[row];
+                }
+                start = end + 1;
+            }
+        };
+        for (std::size_t row = 0; row < movies.size(); ++row) add_words(static_cast<std::uint32_t>(row), movies[row].title);
+        for (const auto& tag : tags) {
+            const auto movie = row_of_movie.find(tag.movie_id);
+            if (movie != shared::utils::IdRowMap::npos) add_words(movie, tag.tag);
+        }
+
+        // Per-document norms and popularity factors
+        const auto documents = movies.size();
+        const auto average_length = documents ? static_cast<double>(occurrences.size()) / static_cast<double>(documents) : 1.0;
+        std::vector<float> norms(documents);
+        for (std::size_t row = 0; row < documents; ++row) {
+            norms[row] = options.k1 * (1.0f - options.b + options.b * static_cast<float>(lengths[row] / std::max(average_length, 1.0)));
+        }
+        popularity_.assign(documents, 1.0f);
+        if (rating_counts.size() == documents) {
+            const auto most = rating_counts.empty() ? 0u : *std::max_element(rating_counts.begin(), rating_counts.end());
+            if (most > 0) {
+                const auto scale = options.popularity_weight / std::log1p(static_cast<float>(most));
+                for (std::size_t row = 0; row < documents; ++row) popularity_[row] = 1.0f + scale * std::log1p(static_cast<float>(rating_counts[row]));
+            }
+        }
+
+        // Counting sort of the occurrences by word; equal rows of a word collapse into one posting with its tf
+        const auto words = word_ids_.size();
+        std::vector<std::uint32_t> starts(words + 1, 0);
+        for (const auto& [word, row] : occurrences) ++starts[word + 1];
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        std::vector<std::uint32_t> grouped(occurrences.size());
+        auto next = starts;
+        for (const auto& [word, row] : occurrences) grouped[next[word]++] = row;
+        occurrences.clear();
+        occurrences.shrink_to_fit();
+
+        offsets_.assign(words + 1, 0);
+        max_impacts_.assign(words, 0.0f);
+        rows_.reserve(grouped.size());
+        impacts_.reserve(grouped.size());
+        std::vector<std::uint32_t> frequencies;
+        for (std::size_t word = 0; word < words; ++word) {
+            const auto first = grouped.begin() + starts[word];
+            const auto last = grouped.begin() + starts[word + 1];
+            std::sort(first, last);
+            const auto begin = rows_.size();
+            frequencies.clear();
+            for (auto it = first; it != last; ++it) {
+                if (rows_.size() == begin || rows_.back() != *it) {
+                    rows_.push_back(*it);
+                    frequencies.push_back(0);
+                }
+                ++frequencies.back();
+            }
+            const auto frequency = static_cast<double>(frequencies.size());
+            const auto idf = static_cast<float>(std::log(1.0 + (static_cast<double>(documents) - frequency + 0.5) / (frequency + 0.5)));
+            for (std::size_t i = 0; i < frequencies.size(); ++i) {
+                const auto row = rows_[begin + i];
+                const auto tf = static_cast<float>(frequencies[i]);
+                const auto impact = idf * tf * (options.k1 + 1.0f) / (tf + norms[row]) * popularity_[row];
+                impacts_.push_back(impact);
+                max_impacts_[word] = std::max(max_impacts_[word], impact);
+            }
+            offsets_[word + 1] = static_cast<std::uint32_t>(rows_.size());
+        }
+        rows_.shrink_to_fit();
+        impacts_.shrink_to_fit();
+    }
+
+    std::vector<ScoredRow> RankIndex::top_k(std::span<const std::string_view> folded_words, std::size_t k,
+        const std::function<bool(std::uint32_t)>& accept, std::uint64_t* postings_read,
+        const shared::utils::QueryDeadline* deadline) const {
+        std::vector<Cursor> cursors;
+        cursors.reserve(folded_words.size());
+        for (const auto word : folded_words) {
+            const auto it = word_ids_.find(word);
+            if (it == word_ids_.end()) continue;
+            const auto begin = offsets_[it->second];
+            const auto end = offsets_[it->second + 1];
+            cursors.push_back({ rows_.data() + begin, rows_.data() + end, impacts_.data() + begin, max_impacts_[it->second] });
+        }
+
+        // Min-heap of the best k so far (front = worst kept result)
+        std::vector<ScoredRow> heap;
+        if (k == 0) return heap;
+        heap.reserve(k);
+        std::uint64_t read = 0;
+
+        for (std::uint64_t step = 1;; ++step) {
+            if (shared::utils::out_of_time(deadline, step)) break;
+            std::erase_if(cursors, [](const Cursor& cursor) { return cursor.row == cursor.end; });
+            if (cursors.empty()) break;
+            std::sort(cursors.begin(), cursors.end(), [](const Cursor& a, const Cursor& b) { return *a.row < *b.row; });
+
+            // Pivot: the first cursor at which the summed upper bounds can beat the k-th score
+            const auto threshold = heap.size() == k ? heap.front().score : 0.0f;
+            float bound = 0.0f;
+            std::size_t pivot = 0;
+            while (pivot < cursors.size() && (bound += cursors[pivot].upper) <= threshold) ++pivot;
+            if (pivot == cursors.size()) break;
+            const auto row = *cursors[pivot].row;
+
+            if (*cursors.front().row == row) {
+                // Every cursor up to the pivot is on the row: score it fully
+                const bool accepted = !accept || accept(row);
+                float score = 0.0f;
+                for (auto& cursor : cursors) {
+                    if (*cursor.row != row) break;
+                    score += *cursor.impact;
+                    ++cursor.row;
+                    ++cursor.impact;
+                    ++read;
+                }
+                if (!accepted) continue;
+                const ScoredRow result{ row, score };
+                if (heap.size() < k) {
+                    heap.push_back(result);
+                    std::push_heap(heap.begin(), heap.end(), better);
+                }
+                else if (better(result, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), better);
+                    heap.back() = result;
+                    std::push_heap(heap.begin(), heap.end(), better);
+                }
+            }
+            else {
+                // No row before the pivot's can reach the threshold: skip the preceding lists ahead
+                for (std::size_t i = 0; i < pivot; ++i) {
+                    auto& cursor = cursors[i];
+                    const auto* target = std::lower_bound(cursor.row, cursor.end, row);
+                    cursor.impact += target - cursor.row;
+                    cursor.row = target;
+                }
+            }
+        }
+
+        if (postings_read) *postings_read += read;
+        std::sort(heap.begin(), heap.end(), better);
+        return heap;
+    }
+
+    std::size_t RankIndex::memory_bytes() const {
+        return shared::utils::hash_map_bytes(word_ids_) + shared::utils::vector_bytes(offsets_) + shared::utils::vector_bytes(rows_)
+            + shared::utils::vector_bytes(impacts_) + shared::utils::vector_bytes(max_impacts_) + shared::utils::vector_bytes(popularity_);
+    }
+
+}
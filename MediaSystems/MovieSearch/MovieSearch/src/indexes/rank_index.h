@@ -0,0 +1,100 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file rank_index.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Movie.h"
+#include "MovieTag.h"
+#include "deadline.h"
+#include "id_row_map.h"
+
+namespace movie_search::indexes {
+
+    struct Bm25Options {
+        float k1 = 1.2f;
+        float b = 0.75f;
+        float popularity_weight = 1.0f;   // the most-rated movie scores (1 + weight) times its BM25 score
+    };
+
+    struct ScoredRow {
+        std::uint32_t row;
+        float score;
+    };
+
+    /**
+     * @brief BM25 postings over the title and tag words of every movie, for ranked search.
+     *
+     * A movie's document is its title plus all its tags, words folded like TokenIndex. Every
+     * posting stores its final impact, idf * tf * (k1 + 1) / (tf + norm) * popularity, where the
+     * per-movie norm k1 * (1 - b + b * length / average length) and the popularity factor
+     * 1 + weight * log(1 + ratings) / log(1 + max ratings) are computed once at build time. The
+     * score of a movie is the sum of its impacts, and every list keeps its largest impact so top_k
+     * can skip movies with WAND.
+     */
+    class RankIndex {
+    public:
+        RankIndex() = default;
+
+        /**
+         * @brief Build the postings
+         * @param movies Parsed movies (rows)
+         * @param tags Parsed tags; tags of unknown movies are skipped
+         * @param row_of_movie Movie id -> movie row
+         * @param rating_counts Number of ratings per movie row (empty: no popularity weighting)
+         * @param options BM25 parameters
+         */
+        RankIndex(const std::vector<movie_parser::models::Movie>& movies,
+            const std::vector<movie_parser::models::MovieTag>& tags,
+            const shared::utils::IdRowMap& row_of_movie,
+            std::span<const std::uint32_t> rating_counts,
+            Bm25Options options = {});
+
+        /**
+         * @brief The k best movies for a disjunction of words, by WAND over the impact postings
+         * @param folded_words Distinct query words in folded form
+         * @param k Number of results
+         * @param accept Optional filter; rejected rows are skipped
+         * @param postings_read Optional counter of the postings scored
+         * @param deadline Optional time budget / cancellation; the best rows found so far are
+         *        returned once it expired
+         * @return Up to k rows by descending score (ties by ascending row)
+         */
+        std::vector<ScoredRow> top_k(std::span<const std::string_view> folded_words, std::size_t k,
+            const std::function<bool(std::uint32_t)>& accept = {}, std::uint64_t* postings_read = nullptr,
+            const shared::utils::QueryDeadline* deadline = nullptr) const;
+
+        // Popularity factor of a movie row (1 when no ratings were given).
+        float popularity(std::uint32_t row) const { return popularity_[row]; }
+
+        std::size_t words() const { return word_ids_.size(); }
+        std::size_t postings() const { return rows_.size(); }
+
+        // Heap bytes of the word table, postings and popularity factors.
+        std::size_t memory_bytes() const;
+
+    private:
+        struct WordHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view word) const { return std::hash<std::string_view>{}(word); }
+        };
+
+        std::unordered_map<std::string, std::uint32_t, WordHash, std::equal_to<>> word_ids_;
+        std::vector<std::uint32_t> offsets_;      // per word id, plus the end
+        std::vector<std::uint32_t> rows_;         // ascending per word
+        std::vector<float> impacts_;              // parallel to rows_
+        std::vector<float> max_impacts_;          // per word id
+        std::vector<float> popularity_;           // per movie row
+    };
+
+}
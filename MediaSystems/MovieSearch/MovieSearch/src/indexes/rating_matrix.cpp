@@ -0,0 +1,77 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_matrix.cpp
+ * @date 2025-09-29
+ */
+
+#include "rating_matrix.h"
+
+#include "memory_usage.h"
+
+namespace movie_search::indexes {
+    namespace {
+        void add_entry(RatingMatrix& matrix, std::vector<MatrixEntry>& entries,
+            const movie_parser::models::MovieRating& rating, const shared::utils::IdRowMap& row_of_movie) {
+            const auto movie = row_of_movie.find(rating.movie_id);
+            if (movie == shared::utils::IdRowMap::npos) return;
+
+            auto [user, inserted] = matrix.user_rows.try_emplace(rating.user_id, static_cast<std::uint32_t>(matrix.user_ids.size()));
+            if (inserted) matrix.user_ids.push_back(rating.user_id);
+
+            entries.push_back({ user->second, movie, static_cast<float>(rating.rating) });
+        }
+
+        void pack(RatingMatrix& matrix, const std::vector<MatrixEntry>& entries, std::size_t movie_count) {
+            matrix.by_user = build_csr(matrix.user_ids.size(), movie_count, entries);
+            matrix.by_item = transpose(matrix.by_user);
+
+            matrix.user_means.assign(matrix.user_ids.size(), 0.0f);
+            for (std::size_t user = 0; user < matrix.by_user.rows; ++user) {
+                const auto values = matrix.by_user.row_values(user);
+                if (values.empty()) continue;
+                double sum = 0.0;
+                for (const auto value : values) sum += value;
+                matrix.user_means[user] = static_cast<float>(sum / static_cast<double>(values.size()));
+            }
+        }
+    }
+
+    RatingMatrix build_rating_matrix(const std::vector<movie_parser::models::MovieRating>& ratings,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t movie_count) {
+        RatingMatrix matrix;
+        std::vector<MatrixEntry> entries;
+        entries.reserve(ratings.size());
+
+        for (const auto& rating : ratings) {
+            add_entry(matrix, entries, rating, row_of_movie);
+        }
+        pack(matrix, entries, movie_count);
+        return matrix;
+    }
+
+    RatingMatrix build_rating_matrix(const std::vector<movie_parser::models::MovieRating>& ratings,
+        std::span<const std::span<const std::uint32_t>> row_groups,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t movie_count) {
+        RatingMatrix matrix;
+        std::vector<MatrixEntry> entries;
+        std::size_t selected = 0;
+        for (const auto group : row_groups) selected += group.size();
+        entries.reserve(selected);
+
+        for (const auto group : row_groups) {
+            for (const auto row : group) {
+                add_entry(matrix, entries, ratings[row], row_of_movie);
+            }
+        }
+        pack(matrix, entries, movie_count);
+        return matrix;
+    }
+
+    std::size_t RatingMatrix::memory_bytes() const {
+        return by_user.memory_bytes() + by_item.memory_bytes() + shared::utils::vector_bytes(user_ids)
+            + shared::utils::hash_map_bytes(user_rows) + shared::utils::vector_bytes(user_means);
+    }
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file rating_matrix.h
+ * @date 2025-09-29
+ */
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "MovieRating.h"
+#include "id_row_map.h"
+#include "sparse_matrix.h"
+
+namespace movie_search::indexes {
+
+    /**
+     * @brief Ratings packed as a user x item sparse matrix in both orientations.
+     *
+     * Items are movie rows of the catalog; users are numbered in order of first appearance.
+     */
+    struct RatingMatrix {
+        SparseMatrix by_user;               // user x item (CSR)
+        SparseMatrix by_item;               // item x user (CSC of by_user)
+        std::vector<int> user_ids;          // user row -> user id
+        std::unordered_map<int, std::uint32_t> user_rows; // user id -> user row
+        std::vector<float> user_means;      // mean rating per user row
+
+        std::size_t memory_bytes() const;
+    };
+
+    /**
+     * @brief Pack ratings into CSR/CSC form
+     * @param ratings Parsed ratings
+     * @param row_of_movie Movie id -> movie row; ratings of unknown movies are skipped
+     * @param movie_count Number of movie rows (item dimension)
+     * @return The packed matrix
+     */
+    RatingMatrix build_rating_matrix(const std::vector<movie_parser::models::MovieRating>& ratings,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t movie_count);
+
+    /**
+     * @brief Pack a subset of the ratings (e.g. the training rows of a fold) into CSR/CSC form
+     * @param ratings Parsed ratings
+     * @param row_groups Groups of row numbers into ratings to include
+     * @param row_of_movie Movie id -> movie row; ratings of unknown movies are skipped
+     * @param movie_count Number of movie rows (item dimension)
+     * @return The packed matrix
+     */
+    RatingMatrix build_rating_matrix(const std::vector<movie_parser::models::MovieRating>& ratings,
+        std::span<const std::span<const std::uint32_t>> row_groups,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t movie_count);
+
+}
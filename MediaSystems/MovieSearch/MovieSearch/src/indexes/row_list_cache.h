@@ -0,0 +1,152 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file row_list_cache.h
+ * @date 2025-10-04
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "memory_usage.h"
+
+namespace movie_search::indexes {
+
+    /**
+     * @brief Keep the first top_k entries of a list by an order, sorted; the rest is dropped
+     */
+    template <typename Entry, typename Order>
+    void keep_top_k(std::vector<Entry>& list, std::size_t top_k, Order order) {
+        if (list.size() > top_k) {
+            std::nth_element(list.begin(), list.begin() + static_cast<std::ptrdiff_t>(top_k), list.end(), order);
+            list.resize(top_k);
+        }
+        std::sort(list.begin(), list.end(), order);
+        list.shrink_to_fit();
+    }
+
+    /**
+     * @brief Per-row result lists (e.g. top-K neighbours), filled lazily or in bulk.
+     *
+     * The row kernel is a callable compute(row, workspace) -> std::vector<Entry>, where Workspace
+     * is per-thread scratch space it may reuse between rows. get() computes a missing row on the
+     * calling thread; precompute() spreads blocks of rows over worker threads. Both may run
+     * concurrently. A stored list is never replaced, so returned spans stay valid while the
+     * cache lives.
+     */
+    template <typename Entry>
+    class RowListCache {
+    public:
+        explicit RowListCache(std::size_t rows) : lists_(rows), cached_(rows, 0) {}
+
+        std::size_t rows() const { return lists_.size(); }
+
+        /**
+         * @brief List of a row (computed and stored on a miss)
+         */
+        template <typename Workspace, typename Compute>
+        std::span<const Entry> get(std::uint32_t row, Compute&& compute) {
+            {
+                std::lock_guard lock(mutex_);
+                if (cached_[row]) return lists_[row];
+            }
+
+            Workspace workspace;
+            auto list = compute(row, workspace);
+
+            std::lock_guard lock(mutex_);
+            store(row, std::move(list));
+            return lists_[row];
+        }
+
+        /**
+         * @brief Compute the lists of all rows not stored yet, in blocks over worker threads
+         * @param block_size Rows per work unit
+         * @param threads Worker threads; 0 = std::thread::hardware_concurrency()
+         * @return Number of rows computed by this call
+         */
+        template <typename Workspace, typename Compute>
+        std::size_t precompute(std::size_t block_size, std::size_t threads, Compute&& compute) {
+            const auto rows = lists_.size();
+            block_size = std::max<std::size_t>(block_size, 1);
+            const auto blocks = (rows + block_size - 1) / block_size;
+            if (!threads) threads = std::thread::hardware_concurrency();
+            threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(blocks, 1));
+
+            std::atomic<std::size_t> next_block{ 0 };
+            std::atomic<std::size_t> computed{ 0 };
+
+            const auto worker = [&] {
+                Workspace workspace;
+                std::vector<std::pair<std::uint32_t, std::vector<Entry>>> block_lists;
+                for (auto block = next_block++; block < blocks; block = next_block++) {
+                    const auto begin = block * block_size;
+                    const auto end = std::min(begin + block_size, rows);
+
+                    std::vector<std::uint8_t> pending(end - begin);
+                    {
+                        std::lock_guard lock(mutex_);
+                        for (auto row = begin; row < end; ++row) pending[row - begin] = !cached_[row];
+                    }
+
+                    block_lists.clear();
+                    for (auto row = begin; row < end; ++row) {
+                        if (!pending[row - begin]) continue;
+                        const auto id = static_cast<std::uint32_t>(row);
+                        block_lists.emplace_back(id, compute(id, workspace));
+                    }
+
+                    std::lock_guard lock(mutex_);
+                    for (auto& [row, list] : block_lists) store(row, std::move(list));
+                    computed += block_lists.size();
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+            worker();
+            for (auto& thread : pool) thread.join();
+
+            return computed;
+        }
+
+        std::size_t cached_rows() const {
+            std::lock_guard lock(mutex_);
+            return cached_count_;
+        }
+
+        // Entries over all stored lists.
+        std::size_t entries() const {
+            std::lock_guard lock(mutex_);
+            return entry_count_;
+        }
+
+        std::size_t memory_bytes() const {
+            std::lock_guard lock(mutex_);
+            return shared::utils::vector_bytes(lists_) + shared::utils::vector_bytes(cached_);
+        }
+
+    private:
+        void store(std::uint32_t row, std::vector<Entry> list) {
+            if (cached_[row]) return;
+            entry_count_ += list.size();
+            lists_[row] = std::move(list);
+            cached_[row] = 1;
+            ++cached_count_;
+        }
+
+        mutable std::mutex mutex_;
+        std::vector<std::vector<Entry>> lists_;
+        std::vector<std::uint8_t> cached_;
+        std::size_t cached_count_ = 0;
+        std::size_t entry_count_ = 0;
+    };
+
+}
@@ -0,0 +1,79 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file sparse_matrix.cpp
+ * @date 2025-09-29
+ */
+
+#include "sparse_matrix.h"
+
+#include <numeric>
+
+#include "memory_usage.h"
+
+namespace movie_search::indexes {
+
+    SparseMatrix build_csr(std::size_t rows, std::size_t cols, const std::vector<MatrixEntry>& entries) {
+        // Two counting-sort passes (LSD): first by column, then stable by row, so every
+        // row comes out sorted by column without a comparison sort.
+        std::vector<std::size_t> column_offsets(cols + 1, 0);
+        for (const auto& entry : entries) {
+            ++column_offsets[entry.column + 1];
+        }
+        std::partial_sum(column_offsets.begin(), column_offsets.end(), column_offsets.begin());
+
+        std::vector<std::size_t> by_column(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            by_column[column_offsets[entries[i].column]++] = i;
+        }
+
+        SparseMatrix matrix;
+        matrix.rows = rows;
+        matrix.cols = cols;
+        matrix.offsets.assign(rows + 1, 0);
+        matrix.columns.resize(entries.size());
+        matrix.values.resize(entries.size());
+
+        for (const auto& entry : entries) {
+            ++matrix.offsets[entry.row + 1];
+        }
+        std::partial_sum(matrix.offsets.begin(), matrix.offsets.end(), matrix.offsets.begin());
+
+        auto next = matrix.offsets;
+        for (const auto i : by_column) {
+            const auto position = next[entries[i].row]++;
+            matrix.columns[position] = entries[i].column;
+            matrix.values[position] = entries[i].value;
+        }
+        return matrix;
+    }
+
+    SparseMatrix transpose(const SparseMatrix& matrix) {
+        SparseMatrix result;
+        result.rows = matrix.cols;
+        result.cols = matrix.rows;
+        result.offsets.assign(matrix.cols + 1, 0);
+        result.columns.resize(matrix.non_zeros());
+        result.values.resize(matrix.non_zeros());
+
+        for (const auto column : matrix.columns) {
+            ++result.offsets[column + 1];
+        }
+        std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+
+        // Walking the source rows in order keeps the new rows sorted by column.
+        auto next = result.offsets;
+        for (std::size_t row = 0; row < matrix.rows; ++row) {
+            for (auto i = matrix.offsets[row]; i < matrix.offsets[row + 1]; ++i) {
+                const auto position = next[matrix.columns[i]]++;
+                result.columns[position] = static_cast<std::uint32_t>(row);
+                result.values[position] = matrix.values[i];
+            }
+        }
+        return result;
+    }
+
+    std::size_t SparseMatrix::memory_bytes() const {
+        return shared::utils::vector_bytes(offsets) + shared::utils::vector_bytes(columns) + shared::utils::vector_bytes(values);
+    }
+
+}
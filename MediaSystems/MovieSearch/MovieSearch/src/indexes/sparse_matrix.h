@@ -0,0 +1,65 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file sparse_matrix.h
+ * @date 2025-09-29
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace movie_search::indexes {
+
+    // A single non-zero entry used to build a matrix.
+    struct MatrixEntry {
+        std::uint32_t row;
+        std::uint32_t column;
+        float value;
+    };
+
+    /**
+     * @brief Compressed sparse row (CSR) matrix.
+     *
+     * Row r owns columns[offsets[r] .. offsets[r + 1]) and the values at the same positions;
+     * columns are sorted within a row. The CSR form of the transpose is the CSC form of the
+     * original, which is how column access is provided.
+     */
+    struct SparseMatrix {
+        std::size_t rows = 0;
+        std::size_t cols = 0;
+        std::vector<std::size_t> offsets;
+        std::vector<std::uint32_t> columns;
+        std::vector<float> values;
+
+        std::size_t non_zeros() const { return columns.size(); }
+        std::size_t memory_bytes() const;
+        std::size_t row_size(std::size_t row) const { return offsets[row + 1] - offsets[row]; }
+
+        std::span<const std::uint32_t> row_columns(std::size_t row) const {
+            return std::span<const std::uint32_t>(columns).subspan(offsets[row], row_size(row));
+        }
+
+        std::span<const float> row_values(std::size_t row) const {
+            return std::span<const float>(values).subspan(offsets[row], row_size(row));
+        }
+    };
+
+    /**
+     * @brief Build a CSR matrix with a counting sort over the row numbers
+     * @param rows Number of rows
+     * @param cols Number of columns
+     * @param entries Non-zero entries in any order (duplicates are kept)
+     * @return Matrix with columns sorted within each row
+     */
+    SparseMatrix build_csr(std::size_t rows, std::size_t cols, const std::vector<MatrixEntry>& entries);
+
+    /**
+     * @brief Transpose a CSR matrix (equivalently: convert it to CSC)
+     * @param matrix Matrix to transpose
+     * @return CSR matrix of the transpose, columns sorted within each row
+     */
+    SparseMatrix transpose(const SparseMatrix& matrix);
+
+}
@@ -0,0 +1,121 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file tag_cooccurrence.cpp
+ * @date 2025-10-04
+ */
+
+#include "tag_cooccurrence.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "memory_usage.h"
+#include "text_fold.h"
+
+namespace movie_search::indexes {
+
+    TagMovieMatrix build_tag_movie_matrix(std::span<const movie_parser::models::MovieTag> tags,
+        std::span<const std::uint32_t> tag_offsets, std::size_t movies) {
+        TagMovieMatrix matrix;
+        std::vector<MatrixEntry> entries;
+        std::vector<std::uint32_t> movie_tags;
+        for (std::size_t row = 0; row < movies; ++row) {
+            movie_tags.clear();
+            for (auto i = tag_offsets[row]; i < tag_offsets[row + 1]; ++i) {
+                auto folded = shared::utils::fold_text(tags[i].tag);
+                const auto [id, added] = matrix.ids.try_emplace(std::move(folded), static_cast<std::uint32_t>(matrix.names.size()));
+                if (added) matrix.names.emplace_back(tags[i].tag);
+                movie_tags.push_back(id->second);
+            }
+            if (movie_tags.empty()) continue;
+            ++matrix.tagged_movies;
+
+            // One entry per distinct tag of the movie, valued with its number of applications
+            std::sort(movie_tags.begin(), movie_tags.end());
+            for (std::size_t i = 0; i < movie_tags.size();) {
+                auto end = i;
+                while (end < movie_tags.size() && movie_tags[end] == movie_tags[i]) ++end;
+                entries.push_back({ static_cast<std::uint32_t>(row), movie_tags[i], static_cast<float>(end - i) });
+                i = end;
+            }
+        }
+
+        matrix.by_movie = build_csr(movies, matrix.names.size(), entries);
+        matrix.by_tag = transpose(matrix.by_movie);
+        return matrix;
+    }
+
+    std::size_t TagMovieMatrix::find(std::string_view tag) const {
+        const auto it = ids.find(shared::utils::fold_text(tag));
+        return it == ids.end() ? npos : it->second;
+    }
+
+    std::size_t TagMovieMatrix::memory_bytes() const {
+        return shared::utils::vector_bytes(names) + shared::utils::hash_map_bytes(ids)
+            + by_tag.memory_bytes() + by_movie.memory_bytes();
+    }
+
+    TagCooccurrenceIndex::TagCooccurrenceIndex(const TagMovieMatrix& matrix, TagCooccurrenceOptions options)
+        : matrix_(matrix), options_(options), lists_(matrix.tag_count()) {}
+
+    std::vector<RelatedTag> TagCooccurrenceIndex::compute(std::uint32_t tag, Workspace& workspace) const {
+        const auto& by_tag = matrix_.by_tag;
+        const auto& by_movie = matrix_.by_movie;
+        workspace.common.resize(matrix_.tag_count(), 0);
+        workspace.touched.clear();
+
+        for (const auto movie : by_tag.row_columns(tag)) {
+            for (const auto other : by_movie.row_columns(movie)) {
+                if (workspace.common[other]++ == 0) workspace.touched.push_back(other);
+            }
+        }
+
+        std::vector<RelatedTag> result;
+        const auto movies = static_cast<double>(matrix_.movie_count(tag));
+        const auto population = static_cast<double>(matrix_.tagged_movies);
+        for (const auto other : workspace.touched) {
+            const auto common = workspace.common[other];
+            workspace.common[other] = 0;
+            if (other == tag || common < options_.min_common) continue;
+
+            const auto other_movies = static_cast<double>(matrix_.movie_count(other));
+            double score = 0.0;
+            if (options_.measure == TagAssociation::jaccard) {
+                score = common / (movies + other_movies - common);
+            }
+            else {
+                score = std::log(common * population / (movies * other_movies));
+                if (score <= 0.0) continue;
+            }
+            result.push_back({ other, common, static_cast<float>(score) });
+        }
+
+        const auto by_score = [](const RelatedTag& a, const RelatedTag& b) {
+            if (a.score != b.score) return a.score > b.score;
+            return a.common != b.common ? a.common > b.common : a.tag < b.tag;
+        };
+        keep_top_k(result, options_.top_k, by_score);
+        return result;
+    }
+
+    std::span<const RelatedTag> TagCooccurrenceIndex::related(std::uint32_t tag) {
+        return lists_.get<Workspace>(tag, [this](std::uint32_t row, Workspace& workspace) { return compute(row, workspace); });
+    }
+
+    std::size_t TagCooccurrenceIndex::precompute() {
+        return lists_.precompute<Workspace>(options_.block_size, options_.threads,
+            [this](std::uint32_t row, Workspace& workspace) { return compute(row, workspace); });
+    }
+
+    std::size_t TagCooccurrenceIndex::cached_tags() const {
+        return lists_.cached_rows();
+    }
+
+    std::size_t TagCooccurrenceIndex::pairs() const {
+        return lists_.entries();
+    }
+
+    std::size_t TagCooccurrenceIndex::memory_bytes() const {
+        return lists_.memory_bytes();
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file tag_cooccurrence.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "MovieTag.h"
+#include "row_list_cache.h"
+#include "sparse_matrix.h"
+
+namespace movie_search::indexes {
+
+    /**
+     * @brief Tag x movie incidence matrix.
+     *
+     * Tags are identified by their folded text; by_tag[t][m] is the number of times tag t was put
+     * on movie row m, by_movie is its transpose. Tags of unknown movies are left out.
+     */
+    struct TagMovieMatrix {
+        std::vector<std::string> names;                         // tag id -> first spelling seen
+        std::unordered_map<std::string, std::uint32_t> ids;     // folded text -> tag id
+        SparseMatrix by_tag;                                    // tag x movie row (CSR)
+        SparseMatrix by_movie;                                  // movie row x tag (CSC of by_tag)
+        std::size_t tagged_movies = 0;                          // movie rows with at least one tag
+
+        std::size_t tag_count() const { return names.size(); }
+        std::size_t movie_count(std::uint32_t tag) const { return by_tag.row_size(tag); }
+
+        /**
+         * @brief Id of a tag, matched after folding
+         * @return The tag id, or npos if no movie has the tag
+         */
+        std::size_t find(std::string_view tag) const;
+
+        std::size_t memory_bytes() const;
+
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    };
+
+    /**
+     * @brief Build the incidence matrix from tags grouped by movie row
+     * @param tags Parsed tags, grouped by movie row (see shared::utils::group_by_row)
+     * @param tag_offsets The tags of movie row r are tags[tag_offsets[r] .. tag_offsets[r + 1])
+     * @param movies Number of movie rows
+     */
+    TagMovieMatrix build_tag_movie_matrix(std::span<const movie_parser::models::MovieTag> tags,
+        std::span<const std::uint32_t> tag_offsets, std::size_t movies);
+
+    enum class TagAssociation {
+        jaccard,    // |A and B| / |A or B| over the movies of both tags
+        pmi         // log(P(A and B) / (P(A) P(B))), movies with a tag as the population
+    };
+
+    // One entry of a related-tag list.
+    struct RelatedTag {
+        std::uint32_t tag;
+        std::uint32_t common;   // movies carrying both tags
+        float score;
+    };
+
+    struct TagCooccurrenceOptions {
+        TagAssociation measure = TagAssociation::jaccard;
+        std::size_t top_k = 50;        // related tags kept per tag
+        std::size_t min_common = 2;    // minimum number of shared movies
+        std::size_t block_size = 256;  // tags per work unit
+        std::size_t threads = 0;       // 0 = std::thread::hardware_concurrency()
+    };
+
+    /**
+     * @brief Top-K related tags per tag, from the co-occurrence counts A x A^T, cached per tag.
+     *
+     * Row t of the product is accumulated in one sparse pass: for each movie m of tag t (by_tag)
+     * and each tag u of m (by_movie), common[u] += 1; the row is then scored and cut to its top_k.
+     * Lists are computed on first request or in bulk by precompute(), which spreads blocks of tags
+     * over worker threads with a dense accumulator each; both may run concurrently. The matrix
+     * must outlive the index.
+     */
+    class TagCooccurrenceIndex {
+    public:
+        TagCooccurrenceIndex(const TagMovieMatrix& matrix, TagCooccurrenceOptions options);
+
+        /**
+         * @brief Related tags of a tag, best score first (computed and cached on a miss)
+         * @param tag Tag id of the matrix
+         * @return At most top_k tags sharing at least min_common movies (and a positive PMI)
+         */
+        std::span<const RelatedTag> related(std::uint32_t tag);
+
+        /**
+         * @brief Compute the lists of all tags not cached yet, in blocks over worker threads
+         * @return Number of tags computed by this call
+         */
+        std::size_t precompute();
+
+        std::size_t cached_tags() const;
+        std::size_t pairs() const;
+
+        // Heap bytes of the cached lists (not of the matrix).
+        std::size_t memory_bytes() const;
+        const TagCooccurrenceOptions& options() const { return options_; }
+
+    private:
+        // Per-thread scratch space: a dense count per tag plus the list of touched tags.
+        struct Workspace {
+            std::vector<std::uint32_t> common;
+            std::vector<std::uint32_t> touched;
+        };
+
+        std::vector<RelatedTag> compute(std::uint32_t tag, Workspace& workspace) const;
+
+        const TagMovieMatrix& matrix_;
+        TagCooccurrenceOptions options_;
+        RowListCache<RelatedTag> lists_;
+    };
+
+}
@@ -0,0 +1,134 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file time_buckets.cpp
+ * @date 2025-10-02
+ */
+
+#include "time_buckets.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "date_utils.h"
+#include "memory_usage.h"
+
+namespace movie_search::indexes {
+
+    TimeBucketIndex::TimeBucketIndex(std::size_t items, const std::vector<TimeEvent>& events) : items_(items) {
+        if (events.empty()) return;
+
+        const auto [low, high] = std::minmax_element(events.begin(), events.end(),
+            [](const TimeEvent& a, const TimeEvent& b) { return a.day < b.day; });
+        first_day_ = low->day;
+        days_ = static_cast<std::size_t>(high->day - low->day) + 1;
+
+        // Counting sort by item, then stably by day: every day's events come out grouped by item.
+        std::vector<std::size_t> item_offsets(items_ + 1, 0);
+        for (const auto& event : events) ++item_offsets[event.item + 1];
+        std::partial_sum(item_offsets.begin(), item_offsets.end(), item_offsets.begin());
+        std::vector<std::uint32_t> by_item(events.size());
+        for (std::size_t i = 0; i < events.size(); ++i) by_item[item_offsets[events[i].item]++] = static_cast<std::uint32_t>(i);
+
+        std::vector<std::size_t> day_starts(days_ + 1, 0);
+        for (const auto& event : events) ++day_starts[static_cast<std::size_t>(event.day - first_day_) + 1];
+        std::partial_sum(day_starts.begin(), day_starts.end(), day_starts.begin());
+        std::vector<std::uint32_t> by_day(events.size());
+        auto next = day_starts;
+        for (const auto i : by_item) by_day[next[static_cast<std::size_t>(events[i].day - first_day_)]++] = i;
+
+        // Collapse equal items within a day into one bucket entry.
+        day_offsets_.assign(days_ + 1, 0);
+        for (std::size_t day = 0; day < days_; ++day) {
+            for (auto i = day_starts[day]; i < day_starts[day + 1]; ++i) {
+                const auto& event = events[by_day[i]];
+                if (i == day_starts[day] || day_items_.back() != event.item) {
+                    day_items_.push_back(event.item);
+                    day_counts_.push_back(0);
+                    day_sums_.push_back(0.0f);
+                }
+                ++day_counts_.back();
+                day_sums_.back() += event.value;
+            }
+            day_offsets_[day + 1] = day_items_.size();
+        }
+
+        first_month_ = shared::utils::month_of_day(first_day_);
+        months_ = static_cast<std::size_t>(shared::utils::month_of_day(last_day()) - first_month_) + 1;
+        month_days_.resize(months_ + 1);
+        for (std::size_t month = 0; month < months_; ++month) {
+            const auto start = shared::utils::first_day_of_month(first_month_ + static_cast<int>(month)) - first_day_;
+            month_days_[month] = std::max(start, 0);
+        }
+        month_days_[months_] = static_cast<int>(days_);
+
+        // Month-major prefix sums: row m + 1 first holds the totals of month m, then is accumulated.
+        count_prefix_.assign((months_ + 1) * items_, 0);
+        sum_prefix_.assign((months_ + 1) * items_, 0.0);
+        for (std::size_t month = 0; month < months_; ++month) {
+            auto* counts = count_prefix_.data() + (month + 1) * items_;
+            auto* sums = sum_prefix_.data() + (month + 1) * items_;
+            for (auto day = month_days_[month]; day < month_days_[month + 1]; ++day) {
+                for (auto i = day_offsets_[day]; i < day_offsets_[day + 1]; ++i) {
+                    counts[day_items_[i]] += day_counts_[i];
+                    sums[day_items_[i]] += day_sums_[i];
+                }
+            }
+            const auto* previous_counts = counts - items_;
+            const auto* previous_sums = sums - items_;
+            for (std::size_t item = 0; item < items_; ++item) {
+                counts[item] += previous_counts[item];
+                sums[item] += previous_sums[item];
+            }
+        }
+    }
+
+    void TimeBucketIndex::add_days(int first, int last, WindowTotals& totals) const {
+        for (auto day = first; day <= last; ++day) {
+            for (auto i = day_offsets_[day]; i < day_offsets_[day + 1]; ++i) {
+                totals.counts[day_items_[i]] += day_counts_[i];
+                totals.sums[day_items_[i]] += day_sums_[i];
+            }
+        }
+    }
+
+    WindowTotals TimeBucketIndex::aggregate(int first_day, int last_day) const {
+        WindowTotals totals;
+        totals.counts.assign(items_, 0);
+        totals.sums.assign(items_, 0.0);
+        if (days_ == 0) return totals;
+
+        const auto first = std::max(first_day - first_day_, 0);
+        const auto last = std::min(last_day - first_day_, static_cast<int>(days_) - 1);
+        if (first > last) return totals;
+
+        // Whole months inside the window: [month_begin, month_end).
+        const auto month_begin = static_cast<std::size_t>(std::lower_bound(month_days_.begin(), month_days_.end(), first) - month_days_.begin());
+        const auto month_end = static_cast<std::size_t>(std::upper_bound(month_days_.begin(), month_days_.end(), last + 1) - month_days_.begin()) - 1;
+
+        if (month_begin < month_end) {
+            const auto* counts_end = count_prefix_.data() + month_end * items_;
+            const auto* counts_begin = count_prefix_.data() + month_begin * items_;
+            const auto* sums_end = sum_prefix_.data() + month_end * items_;
+            const auto* sums_begin = sum_prefix_.data() + month_begin * items_;
+            for (std::size_t item = 0; item < items_; ++item) {
+                totals.counts[item] = counts_end[item] - counts_begin[item];
+                totals.sums[item] = sums_end[item] - sums_begin[item];
+            }
+            add_days(first, month_days_[month_begin] - 1, totals);
+            add_days(month_days_[month_end], last, totals);
+        }
+        else {
+            add_days(first, last, totals);
+        }
+
+        totals.events = std::accumulate(totals.counts.begin(), totals.counts.end(), std::size_t{ 0 });
+        return totals;
+    }
+
+    std::size_t TimeBucketIndex::memory_bytes() const {
+        return shared::utils::vector_bytes(month_days_) + shared::utils::vector_bytes(count_prefix_) + shared::utils::vector_bytes(sum_prefix_)
+            + shared::utils::vector_bytes(day_offsets_) + shared::utils::vector_bytes(day_items_)
+            + shared::utils::vector_bytes(day_counts_) + shared::utils::vector_bytes(day_sums_);
+    }
+
+}
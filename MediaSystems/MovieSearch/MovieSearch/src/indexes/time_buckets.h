@@ -0,0 +1,84 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file time_buckets.h
+ * @date 2025-10-02
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace movie_search::indexes {
+
+    // One timestamped event (a rating or a tag) of a movie row.
+    struct TimeEvent {
+        std::uint32_t item;
+        int day;        // days since 1970-01-01
+        float value;    // rating value (0 for tags)
+    };
+
+    // Per-item totals of a time window.
+    struct WindowTotals {
+        std::vector<std::uint32_t> counts;
+        std::vector<double> sums;
+        std::size_t events = 0;
+    };
+
+    /**
+     * @brief Time-partitioned columnar aggregate of events per item.
+     *
+     * Whole months are served from month-major prefix sums: the totals of months [a, b) are
+     * prefix[b] - prefix[a], two contiguous rows of item columns. The partial months at the edges
+     * of a window come from sparse per-day buckets (CSR over days, entries sorted by item). A
+     * window therefore costs O(items + edge-day entries), independent of the number of events.
+     */
+    class TimeBucketIndex {
+    public:
+        TimeBucketIndex() = default;
+
+        /**
+         * @brief Build the buckets
+         * @param items Number of item rows
+         * @param events Events in any order
+         */
+        TimeBucketIndex(std::size_t items, const std::vector<TimeEvent>& events);
+
+        /**
+         * @brief Totals per item over the days [first_day, last_day] (clamped to the data)
+         * @param first_day First day of the window
+         * @param last_day Last day of the window (inclusive)
+         * @return Counts and value sums per item
+         */
+        WindowTotals aggregate(int first_day, int last_day) const;
+
+        bool empty() const { return days_ == 0; }
+        int first_day() const { return first_day_; }
+        int last_day() const { return first_day_ + static_cast<int>(days_) - 1; }
+        std::size_t months() const { return months_; }
+        std::size_t day_entries() const { return day_items_.size(); }
+        std::size_t memory_bytes() const;
+
+    private:
+        void add_days(int first, int last, WindowTotals& totals) const;
+
+        std::size_t items_ = 0;
+        int first_day_ = 0;
+        std::size_t days_ = 0;
+
+        // Month partitions: months_ months starting at first_month_; month_days_[m] is the first
+        // day of month m (relative to first_day_, clamped), with one extra entry for the end.
+        int first_month_ = 0;
+        std::size_t months_ = 0;
+        std::vector<int> month_days_;
+        std::vector<std::uint32_t> count_prefix_;   // (months_ + 1) x items_
+        std::vector<double> sum_prefix_;            // (months_ + 1) x items_
+
+        // Day partitions (CSR over relative days).
+        std::vector<std::size_t> day_offsets_;
+        std::vector<std::uint32_t> day_items_;
+        std::vector<std::uint32_t> day_counts_;
+        std::vector<float> day_sums_;
+    };
+
+}
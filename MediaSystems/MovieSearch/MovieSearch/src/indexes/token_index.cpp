@@ -0,0 +1,142 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file token_index.cpp
+ * @date 2025-10-04
+ */
+
+#include "token_index.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+#include "text_fold.h"
+#include "memory_usage.h"
+
+namespace movie_search::indexes {
+
+    void TokenIndex::add(std::uint32_t row, std::string_view text) {
+        std::size_t start = 0;
+        while (start < text.size()) {
+            auto end = text.find(' ', start);
+            if (end == std::string_view::npos) end = text.size();
+            if (end > start) {
+                folded_.clear();
+                shared::utils::append_folded(text.substr(start, end - start), folded_);
+                const auto [word, inserted] = word_ids_.try_emplace(folded_, static_cast<std::uint32_t>(word_ids_.size()));
+                pending_.emplace_back(word->second, row);
+            }
+            start = end + 1;
+        }
+    }
+
+    void TokenIndex::finish() {
+        // Counting sort of the postings by word, then sort and deduplicate every word's rows in place.
+        const auto words = word_ids_.size();
+        std::vector<std::uint32_t> starts(words + 1, 0);
+        for (const auto& [word, row] : pending_) ++starts[word + 1];
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        std::vector<std::uint32_t> grouped(pending_.size());
+        auto next = starts;
+        for (const auto& [word, row] : pending_) grouped[next[word]++] = row;
+        pending_.clear();
+        pending_.shrink_to_fit();
+
+        offsets_.assign(words + 1, 0);
+        rows_.clear();
+        rows_.reserve(grouped.size());
+        for (std::size_t word = 0; word < words; ++word) {
+            const auto first = grouped.begin() + starts[word];
+            const auto last = grouped.begin() + starts[word + 1];
+            std::sort(first, last);
+            const auto unique_end = std::unique(first, last);
+            rows_.insert(rows_.end(), first, unique_end);
+            offsets_[word + 1] = static_cast<std::uint32_t>(rows_.size());
+        }
+        rows_.shrink_to_fit();
+        folded_.clear();
+        folded_.shrink_to_fit();
+    }
+
+    std::span<const std::uint32_t> TokenIndex::rows(std::string_view folded_word) const {
+        const auto it = word_ids_.find(folded_word);
+        if (it == word_ids_.end()) return {};
+        return std::span<const std::uint32_t>(rows_.data() + offsets_[it->second], offsets_[it->second + 1] - offsets_[it->second]);
+    }
+
+    namespace
+    {
+        // Index the given movie rows (ascending) and tags (indexes into tags, with their movie rows).
+        SearchIndex build_index(const std::vector<movie_parser::models::Movie>& movies,
+            const std::vector<movie_parser::models::MovieTag>& tags,
+            std::vector<std::uint32_t> rows,
+            const std::vector<std::pair<std::uint32_t, std::uint32_t>>& tag_rows) {
+            SearchIndex index;
+            for (const auto row : rows) {
+                index.titles.add(row, movies[row].title);
+                index.title_positions.add(row, movies[row].title);
+                for (const auto& genre : movies[row].genres) index.genres.add(row, genre);
+            }
+            for (const auto& [tag, row] : tag_rows) index.tags.add(row, tags[tag].tag);
+            index.titles.finish();
+            index.title_positions.finish();
+            index.genres.finish();
+            index.tags.finish();
+            index.rows = std::move(rows);
+            return index;
+        }
+    }
+
+    SearchIndex build_search_index(const std::vector<movie_parser::models::Movie>& movies,
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        const shared::utils::IdRowMap& row_of_movie) {
+        return std::move(build_search_shards(movies, tags, row_of_movie, 1).front());
+    }
+
+    std::size_t shard_of_movie(int movie_id, std::size_t shard_count) {
+        const auto hash = static_cast<std::uint32_t>(movie_id) * 2654435761u;
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * shard_count) >> 32);
+    }
+
+    std::vector<SearchIndex> build_search_shards(const std::vector<movie_parser::models::Movie>& movies,
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t shard_count) {
+        shard_count = std::max<std::size_t>(shard_count, 1);
+        std::vector<std::vector<std::uint32_t>> rows(shard_count);
+        for (std::size_t row = 0; row < movies.size(); ++row) {
+            rows[shard_of_movie(movies[row].movie_id, shard_count)].push_back(static_cast<std::uint32_t>(row));
+        }
+        std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> tag_rows(shard_count);
+        for (std::size_t tag = 0; tag < tags.size(); ++tag) {
+            const auto movie = row_of_movie.find(tags[tag].movie_id);
+            if (movie == shared::utils::IdRowMap::npos) continue;
+            tag_rows[shard_of_movie(tags[tag].movie_id, shard_count)].emplace_back(
+                static_cast<std::uint32_t>(tag), movie);
+        }
+
+        std::vector<SearchIndex> shards(shard_count);
+        if (shard_count == 1) {
+            shards.front() = build_index(movies, tags, std::move(rows.front()), tag_rows.front());
+            return shards;
+        }
+        std::vector<std::thread> pool;
+        pool.reserve(shard_count);
+        for (std::size_t shard = 0; shard < shard_count; ++shard) {
+            pool.emplace_back([&, shard] { shards[shard] = build_index(movies, tags, std::move(rows[shard]), tag_rows[shard]); });
+        }
+        for (auto& thread : pool) thread.join();
+        return shards;
+    }
+
+    std::size_t TokenIndex::memory_bytes() const {
+        return shared::utils::hash_map_bytes(word_ids_) + shared::utils::vector_bytes(pending_)
+            + shared::utils::vector_bytes(offsets_) + shared::utils::vector_bytes(rows_) + shared::utils::string_bytes(folded_);
+    }
+
+    std::size_t SearchIndex::memory_bytes() const {
+        return shared::utils::vector_bytes(rows) + titles.memory_bytes() + genres.memory_bytes() + tags.memory_bytes()
+            + title_positions.memory_bytes();
+    }
+
+}
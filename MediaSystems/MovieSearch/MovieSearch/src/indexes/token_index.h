@@ -0,0 +1,108 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file token_index.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Movie.h"
+#include "MovieTag.h"
+#include "id_row_map.h"
+#include "positional_index.h"
+
+namespace movie_search::indexes {
+
+    /**
+     * @brief Inverted index from folded words to sorted movie rows.
+     *
+     * Texts are split on spaces like case_insensitive_contains_word and every word is folded once
+     * (text_fold.h) while the index is built, so a lookup is a hash probe with an already folded
+     * word: rows(w) holds exactly the rows with a text containing a word that folds to w.
+     */
+    class TokenIndex {
+    public:
+        /**
+         * @brief Index the words of a text under a row (any row order; repeats are merged by finish)
+         */
+        void add(std::uint32_t row, std::string_view text);
+
+        // Group the postings per word. Call once, after the last add.
+        void finish();
+
+        /**
+         * @brief Sorted rows containing a word
+         * @param folded_word Word in folded form (see shared::utils::FoldedWord)
+         * @return The rows, empty for unknown words
+         */
+        std::span<const std::uint32_t> rows(std::string_view folded_word) const;
+
+        std::size_t words() const { return word_ids_.size(); }
+        std::size_t postings() const { return rows_.size(); }
+
+        // Heap bytes of the word table and postings.
+        std::size_t memory_bytes() const;
+
+    private:
+        struct WordHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view word) const { return std::hash<std::string_view>{}(word); }
+        };
+
+        std::unordered_map<std::string, std::uint32_t, WordHash, std::equal_to<>> word_ids_;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pending_;  // (word id, row) until finish
+        std::vector<std::uint32_t> offsets_;                             // per word id, plus the end
+        std::vector<std::uint32_t> rows_;
+        std::string folded_;                                             // scratch for add
+    };
+
+    // Word indexes over the searchable fields of (a shard of) the catalog; rows are movie rows.
+    struct SearchIndex {
+        std::vector<std::uint32_t> rows;    // every movie row covered, ascending
+        TokenIndex titles;
+        TokenIndex genres;
+        TokenIndex tags;
+        PositionalIndex title_positions;    // for quoted title phrases
+
+        std::size_t memory_bytes() const;
+    };
+
+    /**
+     * @brief Build the title, genre and tag word indexes
+     * @param movies Parsed movies (rows)
+     * @param tags Parsed tags; tags of unknown movies are skipped
+     * @param row_of_movie Movie id -> movie row
+     * @return The finished indexes
+     */
+    SearchIndex build_search_index(const std::vector<movie_parser::models::Movie>& movies,
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        const shared::utils::IdRowMap& row_of_movie);
+
+    /**
+     * @brief Shard of a movie id: a multiplicative hash spreads consecutive ids over all shards
+     */
+    std::size_t shard_of_movie(int movie_id, std::size_t shard_count);
+
+    /**
+     * @brief Hash-partition the movies by id and build an independent index per shard, one thread per shard
+     * @param movies Parsed movies (rows)
+     * @param tags Parsed tags; a tag goes to the shard of its movie
+     * @param row_of_movie Movie id -> movie row
+     * @param shard_count Number of shards (at least 1)
+     * @return One index per shard; postings hold global movie rows
+     */
+    std::vector<SearchIndex> build_search_shards(const std::vector<movie_parser::models::Movie>& movies,
+        const std::vector<movie_parser::models::MovieTag>& tags,
+        const shared::utils::IdRowMap& row_of_movie,
+        std::size_t shard_count);
+
+}
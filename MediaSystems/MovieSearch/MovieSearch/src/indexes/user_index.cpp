@@ -0,0 +1,104 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file user_index.cpp
+ * @date 2025-10-04
+ */
+
+#include "user_index.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include "sort_by_member.h"
+
+namespace movie_search::indexes {
+
+    namespace
+    {
+        // Below this many events per thread the threads cost more than they save.
+        constexpr std::size_t min_events_per_thread = 64 * 1024;
+
+        // Sorted distinct ids: a presence table when the id range is dense (as IdRowMap decides), sort and unique otherwise.
+        std::vector<int> distinct_ids(std::span<const int> ids) {
+            std::vector<int> distinct;
+            if (ids.empty()) return distinct;
+            const auto [min, max] = std::minmax_element(ids.begin(), ids.end());
+            const auto span = static_cast<std::uint64_t>(static_cast<std::int64_t>(*max) - *min) + 1;
+            if (span <= shared::utils::IdRowMap::dense_limit(ids.size())) {
+                std::vector<std::uint8_t> present(static_cast<std::size_t>(span), 0);
+                for (const auto id : ids) present[static_cast<std::size_t>(static_cast<std::int64_t>(id) - *min)] = 1;
+                for (std::size_t slot = 0; slot < present.size(); ++slot) {
+                    if (present[slot]) distinct.push_back(static_cast<int>(*min + static_cast<std::int64_t>(slot)));
+                }
+                return distinct;
+            }
+            distinct.assign(ids.begin(), ids.end());
+            shared::utils::sort_by(distinct, shared::utils::ascending(std::identity{}));
+            distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+            return distinct;
+        }
+    }
+
+    UserAdjacency::UserAdjacency(std::span<const int> user_ids, std::span<const std::uint32_t> values,
+        std::span<const std::uint32_t> movie_offsets, std::size_t threads) {
+        const std::size_t events = movie_offsets.empty() ? 0 : movie_offsets.back();
+        user_ids_ = distinct_ids(user_ids.first(events));
+        row_of_user_ = shared::utils::IdRowMap(user_ids_);
+        const auto users = user_ids_.size();
+
+        if (!threads) threads = std::thread::hardware_concurrency();
+        threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(events / min_events_per_thread, 1));
+
+        // Slice t covers the events [slice(t), slice(t + 1)); slices are in movie order
+        const auto slice = [&](std::size_t t) { return events * t / threads; };
+        const auto run = [&](auto&& work) {
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+            for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(work, t);
+            work(std::size_t{ 0 });
+            for (auto& thread : pool) thread.join();
+        };
+
+        // Count the users of every slice
+        std::vector<std::vector<std::uint32_t>> next(threads);
+        run([&](std::size_t t) {
+            next[t].assign(users, 0);
+            for (auto event = slice(t); event < slice(t + 1); ++event) ++next[t][row_of_user_.find(user_ids[event])];
+        });
+
+        // Exclusive scan over (user, slice): where every slice writes the events of every user
+        offsets_.assign(users + 1, 0);
+        std::uint32_t position = 0;
+        for (std::size_t user = 0; user < users; ++user) {
+            offsets_[user] = position;
+            for (std::size_t t = 0; t < threads; ++t) {
+                const auto count = next[t][user];
+                next[t][user] = position;
+                position += count;
+            }
+        }
+        offsets_[users] = position;
+
+        // Scatter; the movie row of an event follows from the movie offsets
+        movie_rows_.resize(events);
+        values_.resize(events);
+        run([&](std::size_t t) {
+            auto& cursor = next[t];
+            const auto first = slice(t);
+            auto movie = static_cast<std::size_t>(std::upper_bound(movie_offsets.begin(), movie_offsets.end(), first) - movie_offsets.begin()) - 1;
+            for (auto event = first; event < slice(t + 1); ++event) {
+                while (movie_offsets[movie + 1] <= event) ++movie;
+                const auto at = cursor[row_of_user_.find(user_ids[event])]++;
+                movie_rows_[at] = static_cast<std::uint32_t>(movie);
+                values_[at] = values[event];
+            }
+        });
+    }
+
+    std::size_t UserAdjacency::memory_bytes() const {
+        return user_ids_.size() * sizeof(int) + row_of_user_.memory_bytes()
+            + (offsets_.size() + movie_rows_.size() + values_.size()) * sizeof(std::uint32_t);
+    }
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file user_index.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "id_row_map.h"
+
+namespace movie_search::indexes {
+
+    /**
+     * @brief User-major CSR over events (ratings or tags) that are grouped by movie row.
+     *
+     * Every user row lists the (movie row, value) pairs of its events with ascending movie rows.
+     * The value is whatever the caller stores per event: a rating code (2 * rating) or the index
+     * of a tag. Built with a parallel counting sort: every thread counts the users of a slice of
+     * the events, an exclusive scan over (user, thread) gives each thread its write position per
+     * user, and the threads scatter their slices. Slices follow the movie order, so the movie
+     * rows of a user come out sorted without a comparison sort.
+     */
+    class UserAdjacency {
+    public:
+        UserAdjacency() = default;
+
+        /**
+         * @brief Build the user rows
+         * @param user_ids User of every event
+         * @param values Value of every event
+         * @param movie_offsets The events of movie row r are [movie_offsets[r], movie_offsets[r + 1]);
+         *        events after the last offset (unknown movies) are left out
+         * @param threads Worker threads (0 = std::thread::hardware_concurrency())
+         */
+        UserAdjacency(std::span<const int> user_ids, std::span<const std::uint32_t> values,
+            std::span<const std::uint32_t> movie_offsets, std::size_t threads = 0);
+
+        // User row of a user id, or shared::utils::IdRowMap::npos.
+        std::uint32_t user_row(int user_id) const { return row_of_user_.find(user_id); }
+        int user_id(std::size_t user_row) const { return user_ids_[user_row]; }
+
+        std::span<const std::uint32_t> movie_rows(std::size_t user_row) const {
+            return std::span(movie_rows_).subspan(offsets_[user_row], offsets_[user_row + 1] - offsets_[user_row]);
+        }
+        std::span<const std::uint32_t> values(std::size_t user_row) const {
+            return std::span(values_).subspan(offsets_[user_row], offsets_[user_row + 1] - offsets_[user_row]);
+        }
+
+        std::size_t user_count() const { return user_ids_.size(); }
+        std::size_t size() const { return movie_rows_.size(); }
+        std::size_t memory_bytes() const;
+
+    private:
+        std::vector<int> user_ids_;                 // user row -> user id, ascending
+        shared::utils::IdRowMap row_of_user_;
+        std::vector<std::uint32_t> offsets_;        // first event of every user row, plus the end
+        std::vector<std::uint32_t> movie_rows_;
+        std::vector<std::uint32_t> values_;
+    };
+
+}
@@ -4,14 +4,33 @@
  * @date 2025-09-16
  */
 
+#include <charconv>
+#include <chrono>
 #include <iostream>
+#include <string>
+#include "parse_errors.h"
 #include "program_runner.h"
 
+/**
+ * Parse a whole decimal number in [min, max]; false on anything else.
+ */
+bool parse_count(const std::string& value, std::size_t min, std::size_t max, std::size_t& count) {
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+    return error == std::errc() && end == value.data() + value.size() && count >= min && count <= max;
+}
+
 void show_help(std::ostream& out) {
     out << "Usage: moviesearch [options]\n"
         << "Options:\n"
         << "  -h, --help                  Show this help message and exit\n"
         << "  -n, --no-menu -d --debug    Run in non-interactive mode\n"
+        << "  -t, --trace                 Print a per-query stage/counter breakdown after each search\n"
+        << "  -s, --strict                Stop at the first malformed line in a dataset file\n"
+        << "                              (default: skip it and print a warning with its line number)\n"
+        << "      --shards <N>            Split the movies into N hash partitions searched in parallel (default 1)\n"
+        << "      --workers <N>           Run up to N searches at once in the background (default 0: one at a time)\n"
+        << "      --queue <N>             Searches waiting for a worker before new ones are rejected (default 16)\n"
+        << "      --timeout <ms>          Stop a search that is not done after this long (default 0: no limit)\n"
         << "Available commands can be displayed with the help command during runtime"
         << "\n";
 }
@@ -38,18 +57,61 @@ int main(int argc, char** argv) {
 
 
     bool interactive_mode = true; // Default to interactive mode
+    bool trace_queries = false;
+    bool strict_parsing = false;
+    std::size_t search_shards = 1;
+    movie_search::services::DispatchLimits limits;
 
-    if (argc > 1) {
-        std::string arg = argv[1];
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
         if (arg == "--no-menu" || arg == "-n" || arg == "--debug" || arg == "-d") {
             interactive_mode = false;
         }
+        else if (arg == "--trace" || arg == "-t") {
+            trace_queries = true;
+        }
+        else if (arg == "--strict" || arg == "-s") {
+            strict_parsing = true;
+        }
+        else if (arg == "--shards" && i + 1 < argc) {
+            if (!parse_count(argv[++i], 1, 256, search_shards)) {
+                std::cerr << "Error: --shards expects a number between 1 and 256\n";
+                return 1;
+            }
+        }
+        else if (arg == "--workers" && i + 1 < argc) {
+            if (!parse_count(argv[++i], 0, 256, limits.workers)) {
+                std::cerr << "Error: --workers expects a number between 0 and 256\n";
+                return 1;
+            }
+        }
+        else if (arg == "--queue" && i + 1 < argc) {
+            if (!parse_count(argv[++i], 0, 65536, limits.queue_capacity)) {
+                std::cerr << "Error: --queue expects a number between 0 and 65536\n";
+                return 1;
+            }
+        }
+        else if (arg == "--timeout" && i + 1 < argc) {
+            std::size_t milliseconds = 0;
+            if (!parse_count(argv[++i], 0, 86400000, milliseconds)) {
+                std::cerr << "Error: --timeout expects milliseconds between 0 and 86400000\n";
+                return 1;
+            }
+            limits.timeout = std::chrono::milliseconds(milliseconds);
+        }
         else if (arg == "--help" || arg == "-h") {
             show_help(std::cout);
             return 0;
         }
     }
 
-    RunProgram(std::cin, std::cout, interactive_mode);
+    try {
+        RunProgram(std::cin, std::cout, interactive_mode, trace_queries, strict_parsing, search_shards, limits);
+    }
+    catch (const movie_parser::parsers::ParseFailure& e) {
+        std::cout.flush();
+        std::cerr << "Error: malformed line " << e.what() << "\n";
+        return 1;
+    }
     return 0;
 }
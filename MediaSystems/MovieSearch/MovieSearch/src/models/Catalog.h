@@ -0,0 +1,105 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file Catalog.h
+ * @date 2025-09-29
+ */
+
+#include <array>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Movie.h"
+#include "MovieRating.h"
+#include "MovieTag.h"
+#include "counting_resource.h"
+#include "hyperloglog.h"
+#include "id_row_map.h"
+#include "parse_errors.h"
+#include "thread_pool.h"
+#include "storage/compressed_ratings.h"
+#include "../indexes/facet_index.h"
+#include "../indexes/item_similarity.h"
+#include "../indexes/rank_index.h"
+#include "../indexes/rating_matrix.h"
+#include "../indexes/tag_cooccurrence.h"
+#include "../indexes/time_buckets.h"
+#include "../indexes/token_index.h"
+#include "../indexes/user_index.h"
+#include "../recommender/candidate_pool.h"
+#include "../recommender/factor_model.h"
+
+namespace movie_search::models {
+    // Datasets and derived indexes kept resident between commands; everything is loaded lazily.
+    struct Catalog {
+        // Arenas holding the title, genre and tag strings. Declared before the datasets so they are
+        // destroyed after them; dropping an arena frees all its strings at once. Their blocks are
+        // counted for memstats.
+        std::unique_ptr<shared::utils::CountedArena> movie_arena;
+        std::unique_ptr<shared::utils::CountedArena> tag_arena;
+
+        std::vector<movie_parser::models::Movie> movies;
+        std::vector<movie_parser::models::MovieTag> tags;
+        std::vector<movie_parser::models::MovieRating> ratings;
+        bool movies_loaded = false;
+        bool tags_loaded = false;
+        bool ratings_loaded = false;
+        movie_parser::parsers::ParseErrorSink parse_errors;    // malformed lines skipped by the loaders
+
+        shared::utils::IdRowMap row_of_movie;                  // movie id -> index in movies
+        // Tags and ratings are grouped by movie row at load: the tags of row r are
+        // tags[tag_offsets[r] .. tag_offsets[r + 1]), those of unknown movies follow the last row.
+        std::vector<std::uint32_t> tag_offsets;
+        std::vector<std::uint32_t> rating_offsets;
+        // The user-major side, built at load from the grouped vectors.
+        indexes::UserAdjacency user_tags;       // user -> (movie row, index in tags)
+        indexes::UserAdjacency user_ratings;    // user -> (movie row, rating code = 2 * rating)
+        // Distinct-user sketches, filled by the same grouping pass (256 bytes each).
+        std::vector<shared::utils::HyperLogLog> movie_taggers;  // per movie row
+        std::vector<shared::utils::HyperLogLog> movie_raters;   // per movie row
+        std::unordered_map<std::string, shared::utils::HyperLogLog> tag_taggers; // folded tag text -> its taggers
+        std::vector<std::uint32_t> distinct_users;  // estimated raters or taggers per movie row, built on first use
+        indexes::TagMovieMatrix tag_movies;     // folded tag x movie row incidence, built with the grouping
+
+        std::size_t search_shard_count = 1;                     // --shards
+        std::vector<indexes::SearchIndex> search_shards;        // folded title/genre/tag words -> movie rows, per shard
+        std::unique_ptr<shared::utils::ThreadPool> shard_pool;  // searches shards 1..n-1 of every query (shard 0 runs on the caller)
+        std::optional<indexes::RankIndex> rank_index;            // BM25 impact postings for moviesearch --rank
+        std::optional<indexes::FacetIndex> facet_index;          // genre/decade/tag bitmaps for moviesearch --facets
+
+        std::optional<movie_parser::storage::CompressedRatings> compressed_ratings;
+
+        std::optional<indexes::RatingMatrix> rating_matrix;
+        std::array<std::unique_ptr<indexes::ItemSimilarityIndex>, 2> similarity; // per SimilarityMeasure
+        std::array<std::unique_ptr<indexes::TagCooccurrenceIndex>, 2> related_tags; // per TagAssociation
+
+        std::optional<recommender::FactorModel> factor_model;   // set by the train command
+        std::unique_ptr<recommender::CandidatePool> candidate_pool;
+
+        std::optional<indexes::TimeBucketIndex> rating_times;   // ratings per movie per day/month
+        std::optional<indexes::TimeBucketIndex> tag_times;      // tags per movie per day/month
+
+        // Startup stages (see services::start_loading) and the malformed lines of each file,
+        // handed to parse_errors once the file is parsed (see services::report_parse_errors).
+        struct LoadingStages {
+            std::shared_future<void> movies;
+            std::shared_future<void> tags_read;
+            std::shared_future<void> ratings_read;
+            std::shared_future<void> tags;                  // parsed and grouped
+            std::shared_future<void> ratings;               // parsed and grouped
+            std::shared_future<void> search_shards;
+            std::shared_future<void> compressed_ratings;
+            movie_parser::parsers::ParseErrorSink movie_errors;
+            movie_parser::parsers::ParseErrorSink tag_errors;
+            movie_parser::parsers::ParseErrorSink rating_errors;
+        } loading;
+        // Declared last: destroyed (finishing its stages) before anything the stages write into.
+        std::unique_ptr<shared::utils::ThreadPool> loader;
+    };
+}
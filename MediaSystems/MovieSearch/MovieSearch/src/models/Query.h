@@ -5,16 +5,41 @@
  * @date 2025-09-17
  */
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace movie_search::models {
+    // Order of the search results; file keeps the order of movies.dat.
+    enum class SortOrder { file, id, title, year };
+
+    // Quoted title words that must appear in order: "las vegas" (adjacent) or "las vegas"~N
+    // (at most N other words in between, summed over the phrase).
+    struct Phrase {
+        std::vector<std::string> words;
+        std::size_t slop = 0;
+
+        bool operator==(const Phrase&) const = default;
+    };
+
     // A structured representation of the parsed query.
     struct Query {
         std::vector<std::string> titles;
+        std::vector<Phrase> title_phrases;
         bool has_year = false;
         int  year = 0;
+        bool has_user = false;          // --user: only movies the user rated or tagged
+        int  user_id = 0;
+        std::vector<std::uint32_t> user_rows;   // those movie rows (sorted), looked up before searching
+        std::size_t min_users = 0;      // --min-users: at least this many distinct raters or taggers (estimated)
+        std::span<const std::uint32_t> distinct_users; // estimate per movie row, set before searching with --min-users
         std::vector<std::string> genres;
         std::vector<std::string> tags;
+        SortOrder sort = SortOrder::file;
+        bool rank = false;              // --rank: best rank_limit movies by BM25 over title and tag words
+        std::size_t rank_limit = 10;
+        bool facets = false;            // --facets: genre, decade and top-tag counts of the results
     };
 }
@@ -7,48 +7,146 @@
 
 #include "program_runner.h"
 
+#include <chrono>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "Services/command_service.h"
 
+#include "allocation_counter.h"
+#include "deadline.h"
+#include "instrumentation.h"
 #include "tags_parser.h"
 #include "movie_parser.h"
 #include "string_utils.h"
+#include "Services/audience_service.h"
+#include "Services/catalog_service.h"
+#include "Services/command_dispatcher.h"
+#include "Services/memory_stats_service.h"
+#include "Services/rating_stats_service.h"
+#include "Services/recommendation_service.h"
+#include "Services/related_tags_service.h"
 #include "Services/search_service.h"
+#include "Services/similarity_service.h"
 #include "Services/terminal_service.h"
+#include "Services/training_service.h"
+#include "Services/user_service.h"
+#include "Services/trending_service.h"
 
 
 const std::string HELP_MESSAGE =
 	"Available commands:\n"
 	"  moviesearch [options]      Prepare and execute a movie search query\n"
-	"    --title <keywords>       Title keywords (multi-word allowed)\n"
+	"    --title <keywords>       Title keywords (multi-word allowed); \"quoted words\" must be\n"
+	"                             adjacent, \"quoted words\"~N at most N words apart\n"
 	"    --year  <YYYY>           Exact release year\n"
-	"    --genre <genres>         One or more genres\n"
-	"    --tag   <tags>           One or more tags\n"
+	"    --genre <genres>         One or more genres; \"quoted words\" are separate words\n"
+	"    --tag   <tags>           One or more tag words; \"quoted words\" are separate words\n"
+	"    --user  <id>             Only movies the user rated or tagged\n"
+	"    --min-users <N>          Only movies rated or tagged by at least N distinct users (estimated)\n"
+	"    --sort  <order>          file (default), id, title or year\n"
+	"    --rank  [N]              Best N (default 10) by BM25 over title and tag words,\n"
+	"                             weighted by rating count; any keyword may match\n"
+	"    --facets                 Also count the results per genre, decade and top tag\n"
+	"\n"
+	"  similar <id> [options]     Movies most similar by co-ratings (ratings.dat)\n"
+	"    --limit <N>              Number of results (default 10, at most 50)\n"
+	"    --measure <m>            cosine (default) or adjusted\n"
+	"    --all                    Precompute the neighbour lists of every movie\n"
+	"  relatedtags <tag> [opts]   Tags most often put on the same movies (tags.dat)\n"
+	"    --limit <N>              Number of results (default 10, at most 50)\n"
+	"    --measure <m>            jaccard (default) or pmi\n"
+	"    --all                    Precompute the related tags of every tag\n"
+	"\n"
+	"  train [options]            Fit an ALS rating model and report test RMSE\n"
+	"    --factors <K>            Latent factors (default 32)\n"
+	"    --iterations <N>         ALS iterations (default 10)\n"
+	"    --lambda <L>             Regularisation (default 0.1)\n"
+	"    --threads <T>            Worker threads (default: all cores)\n"
+	"    --folds <k> --fold <f>   Test fold f of a k-fold split of ratings.dat (default 5, 1)\n"
+	"    --train <file> --test <file>  Use split files (e.g. r1.train r1.test)\n"
+	"  predict <user> <movie>     Predicted rating from the trained model\n"
+	"  recommend <user> [options] Top unseen movies for a user (trained model, else popularity)\n"
+	"    --limit <N>              Number of results (default 10)\n"
+	"    --title/--year/--genre/--tag  Restrict results like moviesearch\n"
+	"\n"
+	"  ratings [<movie_id>]       Rating count, mean and histogram of a movie (or store size)\n"
+	"  usertags <user_id>         Movies a user tagged, with the user's tags and rating\n"
+	"  trending [options]         Top movies by ratings or tags in a time window\n"
+	"    --since <date>           First day (YYYY, YYYY-MM or YYYY-MM-DD)\n"
+	"    --until <date>           Last day, inclusive\n"
+	"    --by <count|mean>        Order by number of ratings (default) or mean rating\n"
+	"    --source <ratings|tags>  Events to count (default ratings)\n"
+	"    --limit <N>              Number of results (default 10)\n"
+	"    --min-count <N>          Minimum events per movie (default 1, 10 with --by mean)\n"
 	"\n"
 	"  parse                      Parse datasets (movies.dat, tags.dat)\n"
 	"  print [options]            Show parsed query structure without searching\n"
 	"  printall                   Print all movies to stdout\n"
+	"  stats                      Show per-stage latency percentiles and counters\n"
+	"  stats <movie_id>           Estimated distinct raters and taggers of a movie and of its tags\n"
+	"  memstats                   Show the memory taken by every dataset and index, and the process RSS\n"
+	"  cancel                     Stop the searches still running (with --workers, piped input)\n"
 	"  alltofile                  Write all movies to all_movies.txt\n"
 	"  help                       Show this help message\n"
 	"  end                        Exit the program\n"
 	"\n"
 	"Examples:\n"
 	"  moviesearch --title Blood --tag Upton\n"
-	"  moviesearch --title Las Vegas\n";
+	"  moviesearch --title Las Vegas\n"
+	"  similar 1 --limit 5 --measure adjusted\n"
+	"  relatedtags pixar --measure pmi\n"
+	"  train --factors 16 --iterations 5\n"
+	"  recommend 1 --limit 5 --genre Comedy\n"
+	"  trending --since 2005 --until 2005-06 --by mean\n";
+
+
+namespace {
+
+    // A moviesearch command from parsing to printing; shared by the command thread and its worker.
+    struct SearchJob {
+        movie_search::models::Query query;
+        std::vector<std::string> warnings;
+        std::shared_ptr<shared::utils::QueryDeadline> deadline;
+        std::chrono::steady_clock::time_point started;
+        std::uint64_t bytes_before = 0;
+        shared::utils::QueryTrace trace;            // stages timed on the command thread, and the counters
+        shared::utils::QueryTrace worker_trace;     // stages timed by the work (recorded by finish)
+        std::vector<std::uint32_t> matches;
+        std::optional<movie_search::indexes::FacetCounts> facets;
+        bool stopped_early = false;                 // the search gave up on its deadline; matches are incomplete
+    };
 
+}
 
-void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode) {
+void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode, bool trace_queries, bool strict_parsing,
+    std::size_t search_shards, const movie_search::services::DispatchLimits& limits) {
     if (interactive_mode) {
         out << HELP_MESSAGE << '\n';
     }
 
+    shared::utils::Instrumentation instrumentation;
+    movie_search::models::Catalog catalog;
+    catalog.parse_errors = movie_parser::parsers::ParseErrorSink(
+        strict_parsing ? movie_parser::parsers::ParseMode::strict : movie_parser::parsers::ParseMode::skip);
+    catalog.search_shard_count = search_shards;
+    // Loads and indexes the datasets in the background; commands wait only for what they need
+    movie_search::services::start_loading(catalog);
+    movie_search::services::CommandDispatcher dispatcher(limits);
+
     std::string input_line;
     while (true) {
+        // A prompt blocks on the next line, so interactively every search prints (or times out)
+        // before it; piped commands keep going while earlier searches run
+        dispatcher.flush(interactive_mode);
+        movie_search::services::report_parse_errors(out, catalog);
         if (interactive_mode) {
             out << "\n";
             out << "Enter command: ";
@@ -62,31 +160,242 @@ void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode) {
         std::string cmd;
         iss >> cmd;
 
+        // Searches may still run on the workers; every other command waits for them (and their
+        // output) first, since it may print or change the catalog
+        if (cmd != "moviesearch" && cmd != "cancel") dispatcher.flush(true);
+
         if (cmd == "parse")
         {
-        	auto tags = movie_parser::parsers::load_tags("tags.dat");
-        	auto movies = movie_parser::parsers::load_movies("movies.dat");
+        	movie_search::services::reload_catalog(catalog);
         }
         else if (cmd == "moviesearch") {
-            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto job = std::make_shared<SearchJob>();
+            job->started = std::chrono::steady_clock::now();
+            job->bytes_before = shared::utils::allocated_bytes();
+            auto& trace = job->trace;
+
+            std::vector<std::string> tokens;
+            {
+                shared::utils::ScopedTimer timer(instrumentation, "tokenize", &trace);
+                tokens = moviesearch::services::tokenize_command_line(input_line);
+            }
             if (tokens.empty()) continue;
 
-            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
-            auto parse_result = moviesearch::services::parse_moviesearch_line(args);
-            for (const auto& warning : parse_result.warnings) out << "Warning: " << warning << "\n";
+            movie_search::models::ParseResult parse_result;
+            {
+                shared::utils::ScopedTimer timer(instrumentation, "parse", &trace);
+                auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+                parse_result = moviesearch::services::parse_moviesearch_line(args);
+            }
+            job->warnings = std::move(parse_result.warnings);
             if (!parse_result.ok) {
-                for (const auto& e : parse_result.errors) out << "Error: " << e << "\n";
+                dispatcher.post([job, errors = std::move(parse_result.errors), &out] {
+                    for (const auto& warning : job->warnings) out << "Warning: " << warning << "\n";
+                    for (const auto& e : errors) out << "Error: " << e << "\n";
+                });
                 continue;
             }
-            auto tags = movie_parser::parsers::load_tags("tags.dat");
-            auto movies = movie_parser::parsers::load_movies("movies.dat");
+            job->query = std::move(parse_result.query);
 
-            auto matches = movie_search::services::search_movies(parse_result.query, movies, tags);
+            // The datasets and the word indexes stay resident: only the first query loads and
+            // indexes them, later ones only look up their keywords. Everything that fills the
+            // catalog runs here, so the search itself only reads it.
+            {
+                shared::utils::ScopedTimer timer(instrumentation, "load_movies", &trace);
+                movie_search::services::ensure_movies(catalog);
+            }
+            {
+                shared::utils::ScopedTimer timer(instrumentation, "load_tags", &trace);
+                movie_search::services::ensure_tags(catalog);
+            }
+            if (job->query.has_user) {
+                shared::utils::ScopedTimer timer(instrumentation, "user_movies", &trace);
+                job->query.user_rows = movie_search::services::user_movie_rows(catalog, job->query.user_id);
+            }
+            if (job->query.min_users) {
+                shared::utils::ScopedTimer timer(instrumentation, "distinct_users", &trace);
+                job->query.distinct_users = movie_search::services::ensure_distinct_users(catalog);
+            }
+            const std::vector<movie_search::indexes::SearchIndex>* shards = nullptr;
+            {
+                shared::utils::ScopedTimer timer(instrumentation, "index", &trace);
+                shards = &movie_search::services::ensure_search_shards(catalog);
+            }
+            const movie_search::indexes::RankIndex* ranking = nullptr;
+            if (job->query.rank) {
+                shared::utils::ScopedTimer timer(instrumentation, "rank_index", &trace);
+                ranking = &movie_search::services::ensure_rank_index(catalog);
+            }
+            const movie_search::indexes::FacetIndex* facet_index = nullptr;
+            if (job->query.facets) {
+                shared::utils::ScopedTimer timer(instrumentation, "facet_index", &trace);
+                facet_index = &movie_search::services::ensure_facet_index(catalog);
+            }
 
-            for (const auto& movie : matches) {
-                out << movie.movie_id << "::" << movie.title << "::" << shared::utils::join(movie.genres, "|") << "\n";
+            // The time budget covers waiting for a worker and the search, not loading the datasets
+            job->deadline = std::make_shared<shared::utils::QueryDeadline>(limits.timeout);
+
+            // Runs on a worker with --workers; stages are timed into the job's own trace
+            auto work = [job, &catalog, shards, ranking, facet_index, shard_pool = catalog.shard_pool.get()] {
+                {
+                    shared::utils::ScopedTimer timer(job->worker_trace, "search");
+                    if (ranking) {
+                        for (const auto& result : movie_search::services::rank_movie_rows(job->query, catalog.movies, *shards,
+                            *ranking, &job->trace.counters, job->deadline.get(), shard_pool)) {
+                            job->matches.push_back(result.row);
+                        }
+                    }
+                    else {
+                        job->matches = movie_search::services::search_movie_rows(job->query, catalog.movies, *shards,
+                            &job->trace.counters, job->deadline.get(), shard_pool);
+                    }
+                    // Decided here, not in finish: finish may run long after the budget even for a complete search
+                    job->stopped_early = job->deadline->stopped();
+                }
+                if (facet_index && !job->stopped_early) {
+                    shared::utils::ScopedTimer timer(job->worker_trace, "facets");
+                    job->facets = facet_index->count(job->matches);
+                }
+                job->worker_trace.stages.push_back({ "total", shared::utils::nanoseconds_since(job->started) });
+                job->trace.counters.bytes_allocated = shared::utils::allocated_bytes() - job->bytes_before;
+            };
+
+            auto finish = [job, &catalog, &instrumentation, &out, &limits, trace_queries] {
+                for (const auto& sample : job->worker_trace.stages) {
+                    instrumentation.record(sample.stage, sample.nanoseconds);
+                    job->trace.stages.push_back(sample);
+                }
+                instrumentation.add_counters(job->trace.counters);
+
+                for (const auto& warning : job->warnings) out << "Warning: " << warning << "\n";
+                if (job->stopped_early) {
+                    // Stopped early: the matches are incomplete, so none are printed
+                    shared::utils::AdmissionCounters stopped;
+                    if (job->deadline->cancelled()) {
+                        ++stopped.cancelled;
+                        out << "Error: query cancelled\n";
+                    }
+                    else {
+                        ++stopped.timed_out;
+                        out << "Error: query timed out after " << limits.timeout.count() << " ms\n";
+                    }
+                    instrumentation.add_admission(stopped);
+                }
+                else {
+                    for (const auto row : job->matches) {
+                        const auto& movie = catalog.movies[row];
+                        out << movie.movie_id << "::" << movie.title << "::" << shared::utils::join(movie.genres, "|") << "\n";
+                    }
+                    if (job->facets) {
+                        movie_search::services::print_facets(out, *job->facets);
+                    }
+                }
+                if (trace_queries) {
+                    shared::utils::print_trace(out, job->trace);
+                }
+            };
+
+            if (!dispatcher.submit(job->deadline, std::move(work), std::move(finish))) {
+                shared::utils::AdmissionCounters shed;
+                ++shed.rejected;
+                instrumentation.add_admission(shed);
+                dispatcher.post([job, in_flight = dispatcher.in_flight(), &out] {
+                    for (const auto& warning : job->warnings) out << "Warning: " << warning << "\n";
+                    out << "Error: too many searches in flight (" << in_flight << "), query rejected\n";
+                });
             }
         }
+        else if (cmd == "cancel") {
+            const auto cancelled = dispatcher.cancel_all();
+            dispatcher.post([cancelled, &out] { out << "Cancelled " << cancelled << " running or queued searches\n"; });
+        }
+        else if (cmd == "similar") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            auto request = movie_search::services::parse_similar_line(args);
+            if (!request.ok) {
+                for (const auto& e : request.errors) out << "Error: " << e << "\n";
+                continue;
+            }
+            shared::utils::ScopedTimer timer(instrumentation, "similar");
+            movie_search::services::run_similar(out, catalog, request);
+        }
+        else if (cmd == "relatedtags") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            auto request = movie_search::services::parse_related_tags_line(args);
+            if (!request.ok) {
+                for (const auto& e : request.errors) out << "Error: " << e << "\n";
+                continue;
+            }
+            shared::utils::ScopedTimer timer(instrumentation, "relatedtags");
+            movie_search::services::run_related_tags(out, catalog, request);
+        }
+        else if (cmd == "train") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            auto request = movie_search::services::parse_train_line(args);
+            if (!request.ok) {
+                for (const auto& e : request.errors) out << "Error: " << e << "\n";
+                continue;
+            }
+            shared::utils::ScopedTimer timer(instrumentation, "train");
+            movie_search::services::run_train(out, catalog, request);
+        }
+        else if (cmd == "predict") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            auto request = movie_search::services::parse_predict_line(args);
+            if (!request.ok) {
+                for (const auto& e : request.errors) out << "Error: " << e << "\n";
+                continue;
+            }
+            movie_search::services::run_predict(out, catalog, request);
+        }
+        else if (cmd == "recommend") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            auto request = movie_search::services::parse_recommend_line(args);
+            for (const auto& warning : request.warnings) out << "Warning: " << warning << "\n";
+            if (!request.ok) {
+                for (const auto& e : request.errors) out << "Error: " << e << "\n";
+                continue;
+            }
+            shared::utils::QueryTrace trace;
+            const auto bytes_before = shared::utils::allocated_bytes();
+            {
+                shared::utils::ScopedTimer timer(instrumentation, "recommend", &trace);
+                movie_search::services::run_recommend(out, catalog, request, &trace.counters);
+            }
+            trace.counters.bytes_allocated = shared::utils::allocated_bytes() - bytes_before;
+            instrumentation.add_counters(trace.counters);
+            if (trace_queries) {
+                shared::utils::print_trace(out, trace);
+            }
+        }
+        else if (cmd == "trending") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            auto request = movie_search::services::parse_trending_line(args);
+            if (!request.ok) {
+                for (const auto& e : request.errors) out << "Error: " << e << "\n";
+                continue;
+            }
+            shared::utils::ScopedTimer timer(instrumentation, "trending");
+            movie_search::services::run_trending(out, catalog, request);
+        }
+        else if (cmd == "ratings") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            shared::utils::ScopedTimer timer(instrumentation, "ratings");
+            movie_search::services::run_rating_stats(out, catalog, args);
+        }
+        else if (cmd == "usertags") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            shared::utils::ScopedTimer timer(instrumentation, "usertags");
+            movie_search::services::run_user_tags(out, catalog, args);
+        }
         else if (cmd == "print") {
             auto tokens = moviesearch::services::tokenize_command_line(input_line);
             if (tokens.empty()) continue;
@@ -102,7 +411,8 @@ void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode) {
 		}
         else if (cmd == "printall")
         {
-            auto movies = movie_parser::parsers::load_movies("movies.dat");
+            std::pmr::monotonic_buffer_resource arena;
+            auto movies = movie_parser::parsers::load_movies("movies.dat", &arena, &catalog.parse_errors);
 
             for (const auto& movie : movies) {
                 out << movie.movie_id << "::" << movie.title << "::" << shared::utils::join(movie.genres, "|") << "\n";
@@ -110,8 +420,9 @@ void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode) {
         }
         else if (cmd == "alltofile")
         {
-            auto movies = movie_parser::parsers::load_movies("movies.dat");
-            auto tags = movie_parser::parsers::load_tags("tags.dat");
+            std::pmr::monotonic_buffer_resource arena;
+            auto movies = movie_parser::parsers::load_movies("movies.dat", &arena, &catalog.parse_errors);
+            auto tags = movie_parser::parsers::load_tags("tags.dat", &arena, &catalog.parse_errors);
 
             // Write movies
             {
@@ -143,6 +454,20 @@ void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode) {
                 }
             }
         }
+        else if (cmd == "stats") {
+            auto tokens = moviesearch::services::tokenize_command_line(input_line);
+            auto args = std::vector<std::string>(tokens.begin() + 1, tokens.end());
+            if (args.empty()) {
+                instrumentation.print_stats(out);
+            }
+            else {
+                shared::utils::ScopedTimer timer(instrumentation, "audience");
+                movie_search::services::run_audience_stats(out, catalog, args);
+            }
+        }
+        else if (cmd == "memstats") {
+            movie_search::services::run_memstats(out, catalog);
+        }
         else if (cmd == "help") {
             out << HELP_MESSAGE << '\n';
         }
@@ -153,6 +478,8 @@ void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode) {
             out << "Error: Unknown command '" << cmd << "'.\n";
         }
     }
+    dispatcher.flush(true);
+    movie_search::services::report_parse_errors(out, catalog);
 }
 
 
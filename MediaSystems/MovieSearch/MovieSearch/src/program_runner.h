@@ -6,7 +6,17 @@
  */
 
 
+#include <cstddef>
 #include <ostream>
 #include "models/Query.h"
+#include "Services/command_dispatcher.h"
 
-void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode);
\ No newline at end of file
+/**
+ * @brief Run the command loop
+ * @param strict_parsing Stop with movie_parser::parsers::ParseFailure at the first malformed dataset line
+ *        instead of skipping it
+ * @param search_shards Number of hash partitions of the movies searched in parallel by moviesearch
+ * @param limits Workers, queue capacity and timeout of moviesearch commands
+ */
+void RunProgram(std::istream& in, std::ostream& out, bool interactive_mode, bool trace_queries = false, bool strict_parsing = false,
+    std::size_t search_shards = 1, const movie_search::services::DispatchLimits& limits = {});
\ No newline at end of file
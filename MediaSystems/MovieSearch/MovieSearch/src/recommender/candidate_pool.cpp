@@ -0,0 +1,123 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file candidate_pool.cpp
+ * @date 2025-10-01
+ */
+
+#include "candidate_pool.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+#include "memory_usage.h"
+#include "string_utils.h"
+
+namespace movie_search::recommender {
+    namespace {
+        // The `limit` most-rated rows of `rows`, returned sorted by row.
+        std::vector<std::uint32_t> most_rated(std::vector<std::uint32_t> rows, const std::vector<std::uint32_t>& counts, std::size_t limit) {
+            const auto by_count = [&](std::uint32_t a, std::uint32_t b) {
+                return counts[a] != counts[b] ? counts[a] > counts[b] : a < b;
+            };
+            if (rows.size() > limit) {
+                std::nth_element(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(limit), rows.end(), by_count);
+                rows.resize(limit);
+            }
+            std::sort(rows.begin(), rows.end());
+            return rows;
+        }
+    }
+
+    CandidatePool::CandidatePool(const std::vector<movie_parser::models::Movie>& movies, const indexes::RatingMatrix& matrix,
+        CandidatePoolOptions options)
+        : matrix_(matrix), options_(options),
+          rating_counts_(matrix.by_item.rows, 0), popularity_scores_(matrix.by_item.rows, 0.0f),
+          movie_genres_(movies.size()) {
+        double sum = 0.0;
+        for (const auto value : matrix.by_item.values) sum += value;
+        const auto global_mean = matrix.by_item.values.empty() ? 0.0 : sum / static_cast<double>(matrix.by_item.values.size());
+
+        std::vector<std::uint32_t> rated;
+        for (std::size_t item = 0; item < matrix.by_item.rows; ++item) {
+            const auto values = matrix.by_item.row_values(item);
+            double item_sum = 0.0;
+            for (const auto value : values) item_sum += value;
+            rating_counts_[item] = static_cast<std::uint32_t>(values.size());
+            popularity_scores_[item] = static_cast<float>((options_.prior_weight * global_mean + item_sum)
+                / (options_.prior_weight + static_cast<double>(values.size())));
+            if (!values.empty()) rated.push_back(static_cast<std::uint32_t>(item));
+        }
+        popular_ = most_rated(rated, rating_counts_, options_.popular);
+
+        std::unordered_map<std::string_view, std::uint16_t> genre_index; // views into the movie genres
+        std::vector<std::vector<std::uint32_t>> genre_members;
+        for (std::size_t row = 0; row < movies.size(); ++row) {
+            for (const auto& genre : movies[row].genres) {
+                auto [it, inserted] = genre_index.try_emplace(std::string_view(genre), static_cast<std::uint16_t>(genre_names_.size()));
+                if (inserted) {
+                    genre_names_.emplace_back(genre);
+                    genre_members.emplace_back();
+                }
+                movie_genres_[row].push_back(it->second);
+                if (row < rating_counts_.size() && rating_counts_[row] > 0) {
+                    genre_members[it->second].push_back(static_cast<std::uint32_t>(row));
+                }
+            }
+        }
+        for (auto& members : genre_members) {
+            genre_buckets_.push_back(most_rated(std::move(members), rating_counts_, options_.per_genre));
+        }
+    }
+
+    std::span<const std::uint32_t> CandidatePool::seen(int user_id) const {
+        const auto user = matrix_.user_rows.find(user_id);
+        if (user == matrix_.user_rows.end()) return {};
+        return matrix_.by_user.row_columns(user->second);
+    }
+
+    std::vector<std::uint32_t> CandidatePool::candidates_for(int user_id, const std::vector<std::string>& genres) const {
+        const auto rated = seen(user_id);
+        std::vector<std::uint32_t> pool(popular_.begin(), popular_.end());
+
+        // Favourite genres: the genres the user rated most often.
+        std::vector<std::uint32_t> genre_counts(genre_names_.size(), 0);
+        for (const auto item : rated) {
+            for (const auto genre : movie_genres_[item]) ++genre_counts[genre];
+        }
+        std::vector<std::uint16_t> order(genre_names_.size());
+        std::iota(order.begin(), order.end(), std::uint16_t{ 0 });
+        const auto favourites = std::min(options_.user_genres, order.size());
+        std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(favourites), order.end(),
+            [&](std::uint16_t a, std::uint16_t b) { return genre_counts[a] != genre_counts[b] ? genre_counts[a] > genre_counts[b] : a < b; });
+        for (std::size_t i = 0; i < favourites && genre_counts[order[i]] > 0; ++i) {
+            const auto& bucket = genre_buckets_[order[i]];
+            pool.insert(pool.end(), bucket.begin(), bucket.end());
+        }
+
+        for (const auto& requested : genres) {
+            for (std::size_t genre = 0; genre < genre_names_.size(); ++genre) {
+                if (shared::utils::case_insensitive_contains_word(genre_names_[genre], requested)) {
+                    pool.insert(pool.end(), genre_buckets_[genre].begin(), genre_buckets_[genre].end());
+                }
+            }
+        }
+
+        std::sort(pool.begin(), pool.end());
+        pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
+
+        std::vector<std::uint32_t> unseen;
+        unseen.reserve(pool.size());
+        std::set_difference(pool.begin(), pool.end(), rated.begin(), rated.end(), std::back_inserter(unseen));
+        return unseen;
+    }
+
+    std::size_t CandidatePool::memory_bytes() const {
+        return shared::utils::vector_bytes(rating_counts_) + shared::utils::vector_bytes(popularity_scores_)
+            + shared::utils::vector_bytes(popular_) + shared::utils::vector_bytes(genre_names_)
+            + shared::utils::vector_bytes(genre_buckets_) + shared::utils::vector_bytes(movie_genres_);
+    }
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file candidate_pool.h
+ * @date 2025-10-01
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Movie.h"
+#include "../indexes/rating_matrix.h"
+
+namespace movie_search::recommender {
+
+    struct CandidatePoolOptions {
+        std::size_t popular = 2000;       // most-rated movies in every pool
+        std::size_t per_genre = 200;      // most-rated movies kept per genre bucket
+        std::size_t user_genres = 3;      // favourite genres of a user whose buckets are added
+        float prior_weight = 10.0f;       // pseudo-ratings at the global mean in popularity_score
+    };
+
+    /**
+     * @brief Precomputed serving data for recommendations.
+     *
+     * Built once from the full rating matrix: per-user seen sets are the sorted movie rows of the
+     * user's CSR row, the pool holds the most popular movies overall and per genre (each sorted by
+     * movie row). A request only scores the union of a few of these lists.
+     */
+    class CandidatePool {
+    public:
+        CandidatePool(const std::vector<movie_parser::models::Movie>& movies, const indexes::RatingMatrix& matrix,
+            CandidatePoolOptions options = {});
+
+        /**
+         * @brief Candidate movie rows for a user: popular movies plus the buckets of the user's
+         *        favourite genres and of the requested genres, minus the movies the user rated
+         * @param user_id User id (unknown users get the popular and requested-genre buckets)
+         * @param genres Requested genre keywords (matched like moviesearch --genre)
+         * @return Sorted, unique movie rows
+         */
+        std::vector<std::uint32_t> candidates_for(int user_id, const std::vector<std::string>& genres) const;
+
+        // Sorted movie rows rated by a user (empty for unknown users).
+        std::span<const std::uint32_t> seen(int user_id) const;
+
+        // Mean rating shrunk towards the global mean (Bayesian average), used when no model is trained.
+        float popularity_score(std::uint32_t item) const { return popularity_scores_[item]; }
+
+        std::size_t rating_count(std::uint32_t item) const { return rating_counts_[item]; }
+        std::size_t genre_count() const { return genre_names_.size(); }
+
+        // Heap bytes of the pool (the seen lists live in the rating matrix).
+        std::size_t memory_bytes() const;
+
+    private:
+        const indexes::RatingMatrix& matrix_;
+        CandidatePoolOptions options_;
+        std::vector<std::uint32_t> rating_counts_;
+        std::vector<float> popularity_scores_;
+        std::vector<std::uint32_t> popular_;                  // sorted movie rows
+        std::vector<std::string> genre_names_;
+        std::vector<std::vector<std::uint32_t>> genre_buckets_; // per genre, sorted movie rows
+        std::vector<std::vector<std::uint16_t>> movie_genres_;  // genre indexes per movie row
+    };
+
+}
@@ -0,0 +1,250 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file factor_model.cpp
+ * @date 2025-09-30
+ */
+
+#include "factor_model.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include "memory_usage.h"
+#include "simd.h"
+
+namespace movie_search::recommender {
+    namespace {
+        constexpr std::size_t rows_per_block = 256;
+
+        // Per-thread normal equations of one row: A is factors x stride, b is stride.
+        struct SolverScratch {
+            shared::utils::aligned_vector<float> a;
+            shared::utils::aligned_vector<float> b;
+        };
+
+        /**
+         * Solve (sum q q^T + lambda * n * I) x = sum (r - mean) q for one row, where q ranges over
+         * the fixed factors of the items (or users) in that row.
+         */
+        void solve_row(const indexes::SparseMatrix& ratings, std::size_t r, const FactorMatrix& fixed,
+            FactorMatrix& target, float mean, float lambda, SolverScratch& scratch) {
+            const auto k = target.factors();
+            const auto stride = target.stride();
+            float* x = target.row(r);
+            const auto n = ratings.row_size(r);
+            if (n == 0) {
+                std::fill(x, x + stride, 0.0f);
+                return;
+            }
+
+            float* a = scratch.a.data();
+            float* b = scratch.b.data();
+            std::fill(scratch.a.begin(), scratch.a.end(), 0.0f);
+            std::fill(scratch.b.begin(), scratch.b.end(), 0.0f);
+
+            const auto columns = ratings.row_columns(r);
+            const auto values = ratings.row_values(r);
+            for (std::size_t e = 0; e < n; ++e) {
+                const float* q = fixed.row(columns[e]);
+                for (std::size_t i = 0; i < k; ++i) {
+                    shared::utils::axpy(q[i], q, a + i * stride, stride);
+                }
+                shared::utils::axpy(values[e] - mean, q, b, stride);
+            }
+            for (std::size_t i = 0; i < k; ++i) {
+                a[i * stride + i] += lambda * static_cast<float>(n);
+            }
+
+            // Cholesky factorisation A = L L^T in the lower triangle (A is positive definite).
+            for (std::size_t j = 0; j < k; ++j) {
+                float* row_j = a + j * stride;
+                float diagonal = row_j[j];
+                for (std::size_t p = 0; p < j; ++p) diagonal -= row_j[p] * row_j[p];
+                row_j[j] = std::sqrt(std::max(diagonal, 1e-12f));
+                for (std::size_t i = j + 1; i < k; ++i) {
+                    float* row_i = a + i * stride;
+                    float sum = row_i[j];
+                    for (std::size_t p = 0; p < j; ++p) sum -= row_i[p] * row_j[p];
+                    row_i[j] = sum / row_j[j];
+                }
+            }
+
+            // Forward substitution L y = b, then backward substitution L^T x = y.
+            for (std::size_t i = 0; i < k; ++i) {
+                float sum = b[i];
+                for (std::size_t p = 0; p < i; ++p) sum -= a[i * stride + p] * b[p];
+                b[i] = sum / a[i * stride + i];
+            }
+            for (std::size_t i = k; i-- > 0;) {
+                float sum = b[i];
+                for (std::size_t p = i + 1; p < k; ++p) sum -= a[p * stride + i] * x[p];
+                x[i] = sum / a[i * stride + i];
+            }
+            std::fill(x + k, x + stride, 0.0f);
+        }
+
+        // Solve every row of one side; blocks of rows are pulled from a shared counter.
+        void solve_side(const indexes::SparseMatrix& ratings, const FactorMatrix& fixed, FactorMatrix& target,
+            float mean, float lambda, std::size_t threads) {
+            const auto blocks = (ratings.rows + rows_per_block - 1) / rows_per_block;
+            std::atomic<std::size_t> next_block{ 0 };
+
+            const auto worker = [&] {
+                SolverScratch scratch;
+                scratch.a.resize(target.factors() * target.stride());
+                scratch.b.resize(target.stride());
+                for (auto block = next_block++; block < blocks; block = next_block++) {
+                    const auto end = std::min((block + 1) * rows_per_block, ratings.rows);
+                    for (auto r = block * rows_per_block; r < end; ++r) {
+                        solve_row(ratings, r, fixed, target, mean, lambda, scratch);
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+            worker();
+            for (auto& thread : pool) thread.join();
+        }
+
+        // Squared prediction errors of the ratings added so far.
+        class SquaredError {
+        public:
+            SquaredError(const FactorModel& model, const shared::utils::IdRowMap& row_of_movie)
+                : model_(model), row_of_movie_(row_of_movie) {
+            }
+
+            void add(const movie_parser::models::MovieRating& rating) {
+                const auto movie = row_of_movie_.find(rating.movie_id);
+                if (movie == shared::utils::IdRowMap::npos) return;
+                const auto error = rating.rating - static_cast<double>(model_.predict(rating.user_id, movie));
+                squared_ += error * error;
+                ++count_;
+            }
+
+            double rmse(std::size_t* evaluated) const {
+                if (evaluated) *evaluated = count_;
+                return count_ ? std::sqrt(squared_ / static_cast<double>(count_)) : 0.0;
+            }
+
+        private:
+            const FactorModel& model_;
+            const shared::utils::IdRowMap& row_of_movie_;
+            double squared_ = 0.0;
+            std::size_t count_ = 0;
+        };
+
+        double training_rmse(const FactorModel& model, const indexes::SparseMatrix& by_user) {
+            if (by_user.non_zeros() == 0) return 0.0;
+            double squared = 0.0;
+            for (std::size_t user = 0; user < by_user.rows; ++user) {
+                const auto columns = by_user.row_columns(user);
+                const auto values = by_user.row_values(user);
+                for (std::size_t e = 0; e < columns.size(); ++e) {
+                    const auto predicted = model.global_mean
+                        + shared::utils::dot(model.users.row(user), model.items.row(columns[e]), model.users.stride());
+                    const auto error = static_cast<double>(values[e]) - predicted;
+                    squared += error * error;
+                }
+            }
+            return std::sqrt(squared / static_cast<double>(by_user.non_zeros()));
+        }
+    }
+
+    FactorMatrix::FactorMatrix(std::size_t rows, std::size_t factors)
+        : rows_(rows), factors_(factors), stride_(shared::utils::simd_padded(factors)),
+          data_(rows * stride_, 0.0f) {
+    }
+
+    float FactorModel::predict(int user_id, std::size_t item) const {
+        float prediction = global_mean;
+        const auto user = user_rows.find(user_id);
+        if (user != user_rows.end() && item < items.rows()) {
+            prediction += shared::utils::dot(users.row(user->second), items.row(item), users.stride());
+        }
+        return std::clamp(prediction, min_rating, max_rating);
+    }
+
+    void FactorModel::score_items(int user_id, std::span<const std::uint32_t> items, std::span<float> scores) const {
+        const auto user = user_rows.find(user_id);
+        if (user == user_rows.end()) {
+            std::fill(scores.begin(), scores.end(), global_mean);
+            return;
+        }
+        const float* factors = users.row(user->second);
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            scores[i] = global_mean + shared::utils::dot(factors, this->items.row(items[i]), users.stride());
+        }
+    }
+
+    FactorModel train_als(const indexes::RatingMatrix& matrix, const AlsOptions& options,
+        const std::function<void(const IterationReport&)>& on_iteration) {
+        FactorModel model;
+        model.users = FactorMatrix(matrix.by_user.rows, options.factors);
+        model.items = FactorMatrix(matrix.by_item.rows, options.factors);
+        model.user_rows = matrix.user_rows;
+        model.training_ratings = matrix.by_user.non_zeros();
+        model.threads = std::max<std::size_t>(options.threads ? options.threads : std::thread::hardware_concurrency(), 1);
+
+        if (!matrix.by_user.values.empty()) {
+            double sum = 0.0;
+            for (const auto value : matrix.by_user.values) sum += value;
+            model.global_mean = static_cast<float>(sum / static_cast<double>(matrix.by_user.values.size()));
+            const auto [low, high] = std::minmax_element(matrix.by_user.values.begin(), matrix.by_user.values.end());
+            model.min_rating = *low;
+            model.max_rating = *high;
+        }
+
+        std::mt19937_64 rng(options.seed);
+        std::normal_distribution<float> initial(0.0f, 0.1f);
+        for (std::size_t item = 0; item < model.items.rows(); ++item) {
+            if (matrix.by_item.row_size(item) == 0) continue;
+            float* row = model.items.row(item);
+            for (std::size_t f = 0; f < options.factors; ++f) row[f] = initial(rng);
+        }
+
+        for (std::size_t iteration = 1; iteration <= options.iterations; ++iteration) {
+            const auto start = std::chrono::steady_clock::now();
+            solve_side(matrix.by_user, model.items, model.users, model.global_mean, options.lambda, model.threads);
+            solve_side(matrix.by_item, model.users, model.items, model.global_mean, options.lambda, model.threads);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (on_iteration) {
+                IterationReport report;
+                report.iteration = iteration;
+                report.seconds = elapsed.count();
+                // Two passes over the training ratings per iteration (user sweep, item sweep), per thread.
+                report.ratings_per_second_per_core = elapsed.count() > 0.0
+                    ? 2.0 * static_cast<double>(model.training_ratings) / elapsed.count() / static_cast<double>(model.threads)
+                    : 0.0;
+                report.train_rmse = training_rmse(model, matrix.by_user);
+                on_iteration(report);
+            }
+        }
+        return model;
+    }
+
+    double rmse(const FactorModel& model, const std::vector<movie_parser::models::MovieRating>& ratings,
+        const shared::utils::IdRowMap& row_of_movie, std::size_t* evaluated) {
+        SquaredError error(model, row_of_movie);
+        for (const auto& rating : ratings) error.add(rating);
+        return error.rmse(evaluated);
+    }
+
+    double rmse(const FactorModel& model, const std::vector<movie_parser::models::MovieRating>& ratings,
+        std::span<const std::uint32_t> rows, const shared::utils::IdRowMap& row_of_movie,
+        std::size_t* evaluated) {
+        SquaredError error(model, row_of_movie);
+        for (const auto row : rows) error.add(ratings[row]);
+        return error.rmse(evaluated);
+    }
+
+    std::size_t FactorModel::memory_bytes() const {
+        return users.memory_bytes() + items.memory_bytes() + shared::utils::hash_map_bytes(user_rows);
+    }
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file factor_model.h
+ * @date 2025-09-30
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "MovieRating.h"
+#include "aligned_allocator.h"
+#include "id_row_map.h"
+#include "../indexes/rating_matrix.h"
+
+namespace movie_search::recommender {
+
+    /**
+     * @brief Row-major float matrix whose rows are padded to the SIMD width and 32-byte aligned.
+     */
+    class FactorMatrix {
+    public:
+        FactorMatrix() = default;
+        FactorMatrix(std::size_t rows, std::size_t factors);
+
+        std::size_t rows() const { return rows_; }
+        std::size_t factors() const { return factors_; }
+        std::size_t stride() const { return stride_; }   // padded row length
+        std::size_t memory_bytes() const { return data_.capacity() * sizeof(float); }
+
+        float* row(std::size_t r) { return data_.data() + r * stride_; }
+        const float* row(std::size_t r) const { return data_.data() + r * stride_; }
+
+    private:
+        std::size_t rows_ = 0;
+        std::size_t factors_ = 0;
+        std::size_t stride_ = 0;
+        shared::utils::aligned_vector<float> data_;
+    };
+
+    struct AlsOptions {
+        std::size_t factors = 32;
+        std::size_t iterations = 10;
+        float lambda = 0.1f;         // weighted-lambda regularisation (scaled by ratings per row)
+        std::size_t threads = 0;     // 0 = std::thread::hardware_concurrency()
+        std::uint64_t seed = 42;
+    };
+
+    // Statistics of one ALS iteration (a user sweep followed by an item sweep).
+    struct IterationReport {
+        std::size_t iteration = 0;
+        double seconds = 0.0;
+        double ratings_per_second_per_core = 0.0; // both sweeps: every training rating is solved twice
+        double train_rmse = 0.0;
+    };
+
+    /**
+     * @brief Latent-factor model: rating(u, i) ~ global_mean + users.row(u) . items.row(i)
+     *
+     * Items are movie rows of the catalog; users are mapped through user_rows.
+     */
+    struct FactorModel {
+        float global_mean = 0.0f;
+        float min_rating = 0.0f;
+        float max_rating = 0.0f;
+        FactorMatrix users;
+        FactorMatrix items;
+        std::unordered_map<int, std::uint32_t> user_rows;   // user id -> row in users
+        std::size_t threads = 1;
+        std::size_t training_ratings = 0;
+
+        std::size_t memory_bytes() const;
+
+        /**
+         * @brief Predicted rating, clamped to the training range
+         * @param user_id User id (unknown users fall back to the global mean)
+         * @param item Movie row of the catalog
+         */
+        float predict(int user_id, std::size_t item) const;
+
+        /**
+         * @brief Unclamped scores of many items for one user (one SIMD dot product per item)
+         * @param user_id User id (unknown users score the global mean everywhere)
+         * @param items Movie rows to score
+         * @param scores Receives one score per item
+         */
+        void score_items(int user_id, std::span<const std::uint32_t> items, std::span<float> scores) const;
+
+        bool knows_user(int user_id) const { return user_rows.contains(user_id); }
+    };
+
+    /**
+     * @brief Fit a factor model with alternating least squares.
+     *
+     * Each half-iteration solves a k x k system per user (resp. item) from the fixed factors of
+     * the other side. Rows are independent, so blocks of rows are handed to worker threads
+     * without any locking; every row is written by exactly one thread.
+     *
+     * @param matrix Training ratings in CSR/CSC form
+     * @param options Hyper-parameters
+     * @param on_iteration Called after every iteration with its statistics (may be empty)
+     * @return The fitted model
+     */
+    FactorModel train_als(const indexes::RatingMatrix& matrix, const AlsOptions& options,
+        const std::function<void(const IterationReport&)>& on_iteration = {});
+
+    /**
+     * @brief Root mean squared error of a model on every rating of a vector
+     * @param model Fitted model
+     * @param ratings Ratings to evaluate
+     * @param row_of_movie Movie id -> movie row; ratings of unknown movies are skipped
+     * @param evaluated Receives the number of ratings evaluated (optional)
+     * @return The RMSE, or 0 when nothing was evaluated
+     */
+    double rmse(const FactorModel& model, const std::vector<movie_parser::models::MovieRating>& ratings,
+        const shared::utils::IdRowMap& row_of_movie, std::size_t* evaluated = nullptr);
+
+    /**
+     * @brief Root mean squared error of a model on selected rows of a ratings vector
+     * @param rows Row numbers into ratings to evaluate (an empty span evaluates nothing)
+     */
+    double rmse(const FactorModel& model, const std::vector<movie_parser::models::MovieRating>& ratings,
+        std::span<const std::uint32_t> rows, const shared::utils::IdRowMap& row_of_movie,
+        std::size_t* evaluated = nullptr);
+
+}
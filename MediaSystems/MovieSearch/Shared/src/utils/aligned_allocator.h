@@ -0,0 +1,43 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file aligned_allocator.h
+ * @date 2025-09-30
+ */
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace shared::utils {
+
+    /**
+     * @brief Allocator that aligns every allocation to Alignment bytes (for aligned SIMD loads).
+     */
+    template <typename T, std::size_t Alignment>
+    struct AlignedAllocator {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ Alignment }));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t{ Alignment });
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    };
+
+    template <typename T, std::size_t Alignment = 32>
+    using aligned_vector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+}
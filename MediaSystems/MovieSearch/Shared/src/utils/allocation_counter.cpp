@@ -0,0 +1,109 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file allocation_counter.cpp
+ * @date 2025-09-22
+ */
+
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+
+namespace {
+    std::atomic<std::uint64_t> total_allocated{ 0 };
+    std::atomic<std::uint64_t> live{ 0 };
+    std::atomic<std::uint64_t> peak_live{ 0 };
+
+    // Size of a block as the C heap sees it; the same value is added on new and removed on delete.
+    std::size_t block_size(void* p) {
+#ifdef _WIN32
+        return _msize(p);
+#else
+        return malloc_usable_size(p);
+#endif
+    }
+
+    void* track(void* p, std::size_t bytes) {
+        if (!p) throw std::bad_alloc();
+        const auto now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        auto peak = peak_live.load(std::memory_order_relaxed);
+        while (now > peak && !peak_live.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+        return p;
+    }
+
+    void release(void* p) noexcept {
+        if (!p) return;
+        live.fetch_sub(block_size(p), std::memory_order_relaxed);
+        std::free(p);
+    }
+
+    // Over-aligned blocks (e.g. from std::pmr::new_delete_resource); Windows needs its own pair.
+    void* allocate_aligned(std::size_t size, std::align_val_t alignment) {
+        total_allocated.fetch_add(size, std::memory_order_relaxed);
+        const auto align = static_cast<std::size_t>(alignment);
+        size = size == 0 ? align : (size + align - 1) / align * align;
+#ifdef _WIN32
+        void* p = _aligned_malloc(size, align);
+        return track(p, p ? _aligned_msize(p, align, 0) : 0);
+#else
+        void* p = std::aligned_alloc(align, size);
+        return track(p, p ? block_size(p) : 0);
+#endif
+    }
+
+    void release_aligned(void* p, std::align_val_t alignment) noexcept {
+        if (!p) return;
+#ifdef _WIN32
+        live.fetch_sub(_aligned_msize(p, static_cast<std::size_t>(alignment), 0), std::memory_order_relaxed);
+        _aligned_free(p);
+#else
+        (void)alignment;
+        release(p);
+#endif
+    }
+}
+
+// Replacing the plain and aligned forms is enough: the default array and nothrow forms forward to them.
+void* operator new(std::size_t size) {
+    total_allocated.fetch_add(size, std::memory_order_relaxed);
+    void* p = std::malloc(size == 0 ? 1 : size);
+    return track(p, p ? block_size(p) : 0);
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    release(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept {
+    release_aligned(p, alignment);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+    release_aligned(p, alignment);
+}
+
+namespace shared::utils {
+
+    std::uint64_t allocated_bytes() {
+        return total_allocated.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t live_bytes() {
+        return live.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t peak_live_bytes() {
+        return peak_live.load(std::memory_order_relaxed);
+    }
+
+}
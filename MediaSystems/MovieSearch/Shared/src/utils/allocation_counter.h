@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file allocation_counter.h
+ * @date 2025-09-22
+ */
+
+#include <cstdint>
+
+namespace shared::utils {
+
+    /**
+     * @brief Total number of bytes requested through the global operator new since start-up.
+     *
+     * The counter is maintained by the replacement operator new in allocation_counter.cpp;
+     * take the difference of two readings to get the bytes allocated by a piece of work.
+     * @return Bytes allocated so far
+     */
+    std::uint64_t allocated_bytes();
+
+    /**
+     * @brief Bytes currently held by operator new allocations (malloc's usable size of each block,
+     *        so allocator rounding is included)
+     */
+    std::uint64_t live_bytes();
+
+    /**
+     * @brief Highest live_bytes() since start-up
+     */
+    std::uint64_t peak_live_bytes();
+
+}
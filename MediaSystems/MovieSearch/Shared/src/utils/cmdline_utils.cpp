@@ -33,4 +33,18 @@ namespace shared::utils {
         return vals;
     }
 
+    std::optional<std::string> collect_single_value(const std::vector<std::string>& tokens, std::size_t& i,
+        const std::string& name, std::vector<std::string>& errors) {
+        auto vals = collect_value_tokens(tokens, i);
+        if (vals.empty()) {
+            errors.push_back("Missing value for --" + name);
+            return std::nullopt;
+        }
+        if (vals.size() > 1) {
+            errors.push_back("Too many values for --" + name + " (expected one)");
+            return std::nullopt;
+        }
+        return vals.front();
+    }
+
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
  * @date 2025-09-16
  */
 
+#include <optional>
 #include <string>
 #include <vector>
 #include <utility>
@@ -41,4 +42,15 @@ namespace shared::utils {
      */
     std::vector<std::string> collect_value_tokens(const std::vector<std::string>& tokens, std::size_t& i);
 
+    /**
+     * @brief Collect exactly one value token for an option
+     * @param tokens Vector of tokens
+     * @param i Reference to current index (will be modified)
+     * @param name Option name, used in the error message
+     * @param errors Receives "Missing value" / "Too many values" errors
+     * @return The value, or std::nullopt when there was not exactly one
+     */
+    std::optional<std::string> collect_single_value(const std::vector<std::string>& tokens, std::size_t& i,
+        const std::string& name, std::vector<std::string>& errors);
+
 }
\ No newline at end of file
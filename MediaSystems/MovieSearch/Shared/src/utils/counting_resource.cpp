@@ -0,0 +1,25 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file counting_resource.cpp
+ * @date 2025-10-04
+ */
+
+#include "counting_resource.h"
+
+namespace shared::utils {
+
+    void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+        void* p = upstream_->allocate(bytes, alignment);
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        const auto in_use = in_use_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        auto peak = peak_.load(std::memory_order_relaxed);
+        while (in_use > peak && !peak_.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) {}
+        return p;
+    }
+
+    void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+        upstream_->deallocate(p, bytes, alignment);
+        in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+}
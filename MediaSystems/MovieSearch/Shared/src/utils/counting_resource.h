@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file counting_resource.h
+ * @date 2025-10-04
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace shared::utils {
+
+    /**
+     * @brief Memory resource that forwards to an upstream resource and counts what passes through.
+     *
+     * Counters are atomic, so they may be read while another thread allocates (e.g. a loader).
+     */
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : upstream_(upstream) {}
+
+        std::size_t bytes_in_use() const { return in_use_.load(std::memory_order_relaxed); }
+        std::size_t peak_bytes() const { return peak_.load(std::memory_order_relaxed); }
+        std::uint64_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::pmr::memory_resource* upstream_;
+        std::atomic<std::size_t> in_use_{ 0 };
+        std::atomic<std::size_t> peak_{ 0 };
+        std::atomic<std::uint64_t> allocations_{ 0 };
+    };
+
+    /**
+     * @brief Monotonic arena whose blocks are taken through a CountingResource, so its footprint
+     *        (including the unused tail of the last block) can be reported.
+     */
+    class CountedArena {
+    public:
+        /**
+         * @param initial_size Size of the first block
+         */
+        explicit CountedArena(std::size_t initial_size) : arena_(initial_size, &blocks_) {}
+
+        std::pmr::memory_resource* resource() { return &arena_; }
+        const CountingResource& blocks() const { return blocks_; }
+
+    private:
+        CountingResource blocks_;                       // declared first: outlives the arena
+        std::pmr::monotonic_buffer_resource arena_;
+    };
+
+}
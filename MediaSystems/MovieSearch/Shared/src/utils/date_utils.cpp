@@ -0,0 +1,72 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file date_utils.cpp
+ * @date 2025-10-02
+ */
+
+#include "date_utils.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+
+namespace shared::utils {
+    namespace {
+        bool parse_number(const std::string& text, std::size_t begin, std::size_t length, int& value) {
+            if (begin + length > text.size()) return false;
+            const auto* first = text.data() + begin;
+            const auto [end, error] = std::from_chars(first, first + length, value);
+            return error == std::errc{} && end == first + length;
+        }
+
+        int to_day(const std::chrono::year_month_day& date) {
+            return static_cast<int>(std::chrono::sys_days{ date }.time_since_epoch().count());
+        }
+    }
+
+    int day_of_timestamp(long timestamp) {
+        // Floor division so timestamps before 1970 land on the right day.
+        constexpr long seconds_per_day = 86400;
+        return static_cast<int>(timestamp >= 0 ? timestamp / seconds_per_day : (timestamp - seconds_per_day + 1) / seconds_per_day);
+    }
+
+    int month_of_day(int day) {
+        const std::chrono::year_month_day date{ std::chrono::sys_days{ std::chrono::days{ day } } };
+        return static_cast<int>(date.year()) * 12 + static_cast<int>(static_cast<unsigned>(date.month())) - 1;
+    }
+
+    int first_day_of_month(int month) {
+        const auto year = month >= 0 ? month / 12 : (month - 11) / 12;
+        const auto month_of_year = static_cast<unsigned>(month - year * 12 + 1);
+        return to_day(std::chrono::year{ year } / std::chrono::month{ month_of_year } / 1);
+    }
+
+    std::optional<DayRange> parse_date_range(const std::string& text) {
+        int year = 0, month = 0, day = 0;
+        if (!parse_number(text, 0, 4, year)) return std::nullopt;
+
+        if (text.size() == 4) {
+            return DayRange{ to_day(std::chrono::year{ year } / 1 / 1), to_day(std::chrono::year{ year } / 12 / 31) };
+        }
+        if (text.size() < 7 || text[4] != '-' || !parse_number(text, 5, 2, month) || month < 1 || month > 12) return std::nullopt;
+
+        const auto year_month = std::chrono::year{ year } / std::chrono::month{ static_cast<unsigned>(month) };
+        if (text.size() == 7) {
+            return DayRange{ to_day(year_month / 1), to_day(year_month / std::chrono::last) };
+        }
+        if (text.size() != 10 || text[7] != '-' || !parse_number(text, 8, 2, day)) return std::nullopt;
+
+        const std::chrono::year_month_day date = year_month / std::chrono::day{ static_cast<unsigned>(day) };
+        if (!date.ok()) return std::nullopt;
+        return DayRange{ to_day(date), to_day(date) };
+    }
+
+    std::string format_day(int day) {
+        const std::chrono::year_month_day date{ std::chrono::sys_days{ std::chrono::days{ day } } };
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", static_cast<int>(date.year()),
+            static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+        return buffer;
+    }
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file date_utils.h
+ * @date 2025-10-02
+ */
+
+#include <optional>
+#include <string>
+
+namespace shared::utils {
+
+    // Inclusive range of days since 1970-01-01 (UTC).
+    struct DayRange {
+        int first;
+        int last;
+    };
+
+    /**
+     * @brief Day number (days since 1970-01-01 UTC) of a Unix timestamp
+     */
+    int day_of_timestamp(long timestamp);
+
+    /**
+     * @brief Absolute month number (year * 12 + month - 1) of a day number
+     */
+    int month_of_day(int day);
+
+    /**
+     * @brief Day number of the first day of an absolute month number
+     */
+    int first_day_of_month(int month);
+
+    /**
+     * @brief Parse "YYYY", "YYYY-MM" or "YYYY-MM-DD" into the days it covers
+     * @param text Date text
+     * @return The covered days, or std::nullopt if the text is not a valid date
+     */
+    std::optional<DayRange> parse_date_range(const std::string& text);
+
+    /**
+     * @brief Format a day number as "YYYY-MM-DD"
+     */
+    std::string format_day(int day);
+
+}
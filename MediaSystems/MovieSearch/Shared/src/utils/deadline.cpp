@@ -0,0 +1,26 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file deadline.cpp
+ * @date 2025-10-04
+ */
+
+#include "deadline.h"
+
+namespace shared::utils {
+
+    QueryDeadline::QueryDeadline(std::chrono::milliseconds budget) {
+        if (budget.count() > 0) deadline_ = clock::now() + budget;
+    }
+
+    bool QueryDeadline::expired() const {
+        const auto state = state_.load(std::memory_order_relaxed);
+        if (state != running_state) return true;
+        if (deadline_ == clock::time_point::max() || clock::now() < deadline_) return false;
+
+        // Only a running query becomes timed out; a concurrent cancel() wins
+        auto expected = running_state;
+        state_.compare_exchange_strong(expected, timed_out_state, std::memory_order_relaxed);
+        return true;
+    }
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file deadline.h
+ * @date 2025-10-04
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace shared::utils {
+
+    /**
+     * @brief Time budget and cancellation flag of one query, checked cooperatively by long loops.
+     *
+     * Loops call expired() every few hundred steps and stop early (with incomplete results) once it
+     * returns true. Both the timeout and cancel() are sticky and may be observed from any thread.
+     */
+    class QueryDeadline {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        // Steps a loop may run between two expired() checks.
+        static constexpr std::uint32_t check_interval = 256;
+
+        // No time limit; only cancel() stops the query.
+        QueryDeadline() = default;
+
+        /**
+         * @param budget Time from now until the query expires (zero or less: no time limit)
+         */
+        explicit QueryDeadline(std::chrono::milliseconds budget);
+
+        // Ask every loop checking this deadline to stop.
+        void cancel() { state_.store(cancelled_state, std::memory_order_relaxed); }
+
+        /**
+         * @brief Whether the query should stop (cancelled, or past its deadline)
+         */
+        bool expired() const;
+
+        /**
+         * @brief Whether a loop saw the deadline pass, or the query was cancelled
+         *
+         * Unlike expired() this does not read the clock: a query that finished within its budget
+         * stays complete however late its results are collected.
+         */
+        bool stopped() const { return state_.load(std::memory_order_relaxed) != running_state; }
+
+        bool timed_out() const { return state_.load(std::memory_order_relaxed) == timed_out_state; }
+        bool cancelled() const { return state_.load(std::memory_order_relaxed) == cancelled_state; }
+
+    private:
+        static constexpr int running_state = 0;
+        static constexpr int timed_out_state = 1;
+        static constexpr int cancelled_state = 2;
+
+        clock::time_point deadline_ = clock::time_point::max();
+        mutable std::atomic<int> state_{ running_state };
+    };
+
+    /**
+     * @brief Check a deadline on every check_interval-th step of a loop
+     * @param deadline Deadline of the query (nullptr: never expires)
+     * @param step Loop counter
+     */
+    inline bool out_of_time(const QueryDeadline* deadline, std::uint64_t step) {
+        return deadline && step % QueryDeadline::check_interval == 0 && deadline->expired();
+    }
+
+}
@@ -20,6 +20,8 @@ template <typename Container, typename MemberType, typename MemberPointerType>
  * @param MemberPointer The pointer to the member of the elements in the container.
  * @return An iterator to the first element whose specified member matches the target value,
  *         or the end of the container if no such element is found.
+ *
+ * This is a linear scan; for repeated id lookups build a shared::utils::IdRowMap (id_row_map.h).
  */
 auto findByMember(const Container& container, const MemberType& target, MemberPointerType MemberPointer) {
     return std::find_if(container.begin(), container.end(), [&](const auto& element) {
@@ -0,0 +1,32 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file hash_utils.h
+ * @date 2025-10-04
+ */
+
+#include <cstdint>
+
+namespace shared::utils {
+
+    // Weyl increment of SplitMix64 (2^64 / golden ratio).
+    inline constexpr std::uint64_t splitmix64_increment = 0x9E3779B97F4A7C15ull;
+
+    /**
+     * @brief SplitMix64 finaliser: a bijection of 64-bit values in which every input bit affects
+     *        every output bit
+     */
+    constexpr std::uint64_t mix64(std::uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief 64-bit hash of an integer key (one SplitMix64 step from the key); 0 does not map to 0
+     */
+    constexpr std::uint64_t hash64(std::uint64_t key) {
+        return mix64(key + splitmix64_increment);
+    }
+
+}
@@ -0,0 +1,90 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file hyperloglog.cpp
+ * @date 2025-10-04
+ */
+
+#include "hyperloglog.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace shared::utils {
+
+    namespace
+    {
+        // Past this many pairs the sparse list takes more bytes than the dense registers.
+        constexpr std::size_t sparse_limit = HyperLogLog::register_count / 2;
+
+        std::size_t entry_index(std::uint16_t entry) { return entry >> 8; }
+        std::uint8_t entry_rank(std::uint16_t entry) { return static_cast<std::uint8_t>(entry & 0xFF); }
+    }
+
+    void HyperLogLog::add_hash(std::uint64_t hash) {
+        const auto index = static_cast<std::size_t>(hash >> (64 - precision));
+        // Rank of the first set bit after the index bits; a guard bit caps it at 64 - precision + 1
+        const auto rest = (hash << precision) | (std::uint64_t{ 1 } << (precision - 1));
+        update(index, static_cast<std::uint8_t>(std::countl_zero(rest) + 1));
+    }
+
+    void HyperLogLog::update(std::size_t index, std::uint8_t rank) {
+        if (dense()) {
+            registers_[index] = std::max(registers_[index], rank);
+            return;
+        }
+        const auto entry = static_cast<std::uint16_t>(index << 8 | rank);
+        const auto it = std::lower_bound(sparse_.begin(), sparse_.end(), static_cast<std::uint16_t>(index << 8));
+        if (it != sparse_.end() && entry_index(*it) == index) {
+            *it = std::max(*it, entry);
+            return;
+        }
+        sparse_.insert(it, entry);
+        if (sparse_.size() > sparse_limit) densify();
+    }
+
+    void HyperLogLog::densify() {
+        registers_.assign(register_count, 0);
+        for (const auto entry : sparse_) registers_[entry_index(entry)] = entry_rank(entry);
+        sparse_ = {};
+    }
+
+    void HyperLogLog::merge(const HyperLogLog& other) {
+        if (other.dense()) {
+            if (!dense()) densify();
+            for (std::size_t i = 0; i < register_count; ++i) registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+        else {
+            for (const auto entry : other.sparse_) update(entry_index(entry), entry_rank(entry));
+        }
+    }
+
+    double HyperLogLog::estimate() const {
+        constexpr double m = static_cast<double>(register_count);
+        constexpr double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+        double inverse_sum = 0.0;
+        std::size_t zeros = 0;
+        if (dense()) {
+            for (const auto rank : registers_) {
+                inverse_sum += std::ldexp(1.0, -static_cast<int>(rank));
+                zeros += rank == 0;
+            }
+        }
+        else {
+            zeros = register_count - sparse_.size();
+            inverse_sum = static_cast<double>(zeros);
+            for (const auto entry : sparse_) inverse_sum += std::ldexp(1.0, -static_cast<int>(entry_rank(entry)));
+        }
+        const double raw = alpha * m * m / inverse_sum;
+
+        // Small range: linear counting over the empty registers is more accurate
+        if (raw <= 2.5 * m && zeros) return m * std::log(m / static_cast<double>(zeros));
+        return raw;
+    }
+
+    std::size_t HyperLogLog::memory_bytes() const {
+        return registers_.capacity() + sparse_.capacity() * sizeof(std::uint16_t);
+    }
+
+}
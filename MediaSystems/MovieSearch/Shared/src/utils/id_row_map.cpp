@@ -0,0 +1,43 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file id_row_map.cpp
+ * @date 2025-10-04
+ */
+
+#include "id_row_map.h"
+
+#include <algorithm>
+
+namespace shared::utils {
+
+    IdRowMap::IdRowMap(std::span<const int> ids) : size_(ids.size()) {
+        if (ids.empty()) return;
+
+        const auto [min, max] = std::minmax_element(ids.begin(), ids.end());
+        min_id_ = *min;
+        const auto span = static_cast<std::uint64_t>(static_cast<std::int64_t>(*max) - min_id_) + 1;
+        dense_ = span <= dense_limit(ids.size());
+
+        if (dense_) {
+            table_.assign(static_cast<std::size_t>(span), npos);
+            for (std::size_t row = 0; row < ids.size(); ++row) {
+                auto& slot = table_[static_cast<std::size_t>(static_cast<std::int64_t>(ids[row]) - min_id_)];
+                if (slot == npos) slot = static_cast<std::uint32_t>(row);
+            }
+            return;
+        }
+
+        sparse_.reserve(ids.size());
+        for (std::size_t row = 0; row < ids.size(); ++row) {
+            sparse_.emplace(ids[row], static_cast<std::uint32_t>(row));
+        }
+    }
+
+    std::size_t IdRowMap::memory_bytes() const {
+        // Hash nodes hold the pair plus a next pointer; buckets are one pointer each.
+        return table_.capacity() * sizeof(std::uint32_t)
+            + sparse_.size() * (sizeof(std::pair<const int, std::uint32_t>) + sizeof(void*))
+            + sparse_.bucket_count() * sizeof(void*);
+    }
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file id_row_map.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace shared::utils {
+
+    /**
+     * @brief Maps record ids (e.g. movie ids) to their row in a vector.
+     *
+     * When the ids are dense enough (their span is at most eight times the number of rows, plus
+     * some slack) the map is a direct-address table indexed by id - min id, so a lookup is one
+     * bounds check and one load. Sparse id spaces fall back to a hash map. The first row of an
+     * id wins.
+     */
+    class IdRowMap {
+    public:
+        static constexpr std::uint32_t npos = UINT32_MAX;
+
+        IdRowMap() = default;
+
+        /**
+         * @brief Build the map
+         * @param ids Id of every row, in row order
+         */
+        explicit IdRowMap(std::span<const int> ids);
+
+        /**
+         * @brief Build the map from a member of every record
+         * @param records Records in row order
+         * @param id Pointer to the id member of a record
+         */
+        template <typename Records, typename Member>
+        IdRowMap(const Records& records, Member id) : IdRowMap(std::span<const int>(ids_of(records, id))) {}
+
+        /**
+         * @brief Row of an id
+         * @return The row, or npos if the id is unknown
+         */
+        std::uint32_t find(int id) const {
+            if (dense_) {
+                const auto slot = static_cast<std::uint64_t>(static_cast<std::int64_t>(id) - min_id_);
+                return slot < table_.size() ? table_[slot] : npos;
+            }
+            const auto it = sparse_.find(id);
+            return it == sparse_.end() ? npos : it->second;
+        }
+
+        bool contains(int id) const { return find(id) != npos; }
+
+        /**
+         * @brief Largest id span (max - min + 1) served by a direct-address table for a number of rows
+         */
+        static constexpr std::uint64_t dense_limit(std::size_t rows) {
+            return 8 * static_cast<std::uint64_t>(rows) + 1024;
+        }
+        bool dense() const { return dense_; }
+        std::size_t size() const { return size_; }
+        std::size_t memory_bytes() const;
+
+    private:
+        template <typename Records, typename Member>
+        static std::vector<int> ids_of(const Records& records, Member id) {
+            std::vector<int> ids;
+            ids.reserve(records.size());
+            for (const auto& record : records) ids.push_back(static_cast<int>(record.*id));
+            return ids;
+        }
+
+        bool dense_ = true;
+        std::size_t size_ = 0;
+        std::int64_t min_id_ = 0;
+        std::vector<std::uint32_t> table_;                     // id - min_id_ -> row, npos for holes
+        std::unordered_map<int, std::uint32_t> sparse_;        // fallback for sparse id spaces
+    };
+
+    /**
+     * @brief Group records by the row of their id with a stable counting sort.
+     *
+     * Afterwards the records of row r are [offsets[r], offsets[r + 1]), in their original order.
+     * Records whose id is unknown are moved behind offsets[row_count].
+     *
+     * @param records Records to reorder in place
+     * @param id Pointer to the id member of a record
+     * @param rows Id -> row map
+     * @param row_count Number of rows
+     * @return The offsets, row_count + 1 entries
+     */
+    template <typename Record, typename Member>
+    std::vector<std::uint32_t> group_by_row(std::vector<Record>& records, Member Record::* id,
+        const IdRowMap& rows, std::size_t row_count) {
+        std::vector<std::uint32_t> offsets(row_count + 2, 0);
+        std::vector<std::uint32_t> row_of_record(records.size());
+        for (std::size_t record = 0; record < records.size(); ++record) {
+            auto row = rows.find(static_cast<int>(records[record].*id));
+            if (row == IdRowMap::npos || row >= row_count) row = static_cast<std::uint32_t>(row_count);
+            row_of_record[record] = row;
+            ++offsets[row + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<std::uint32_t> order(records.size());
+        auto next = offsets;
+        for (std::size_t record = 0; record < records.size(); ++record) {
+            order[next[row_of_record[record]]++] = static_cast<std::uint32_t>(record);
+        }
+
+        std::vector<Record> grouped;
+        grouped.reserve(records.size());
+        for (const auto record : order) grouped.push_back(std::move(records[record]));
+        records = std::move(grouped);
+
+        offsets.pop_back();
+        return offsets;
+    }
+
+}
@@ -0,0 +1,183 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file instrumentation.cpp
+ * @date 2025-09-22
+ */
+
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+namespace shared::utils {
+
+    namespace
+    {
+        double to_microseconds(std::uint64_t nanoseconds) {
+            return static_cast<double>(nanoseconds) / 1000.0;
+        }
+    }
+
+    std::size_t LatencyHistogram::bucket_index(std::uint64_t value) {
+        if (value < sub_bucket_count) return static_cast<std::size_t>(value);
+
+        const int msb = std::bit_width(value) - 1;
+        const int shift = msb - sub_bucket_bits;
+        const auto sub_bucket = static_cast<std::size_t>(value >> shift) - sub_bucket_count;
+        return static_cast<std::size_t>(shift + 1) * sub_bucket_count + sub_bucket;
+    }
+
+    std::uint64_t LatencyHistogram::bucket_upper_bound(std::size_t index) {
+        if (index < sub_bucket_count) return index;
+
+        const std::size_t group = index / sub_bucket_count;
+        const std::size_t sub_bucket = index % sub_bucket_count;
+        const std::uint64_t lower = static_cast<std::uint64_t>(sub_bucket_count + sub_bucket) << (group - 1);
+        return lower + ((std::uint64_t{ 1 } << (group - 1)) - 1);
+    }
+
+    void LatencyHistogram::record(std::uint64_t value_ns) {
+        ++counts_[bucket_index(value_ns)];
+        ++count_;
+        sum_ += value_ns;
+        min_ = std::min(min_, value_ns);
+        max_ = std::max(max_, value_ns);
+    }
+
+    std::uint64_t LatencyHistogram::percentile(double percentile) const {
+        if (count_ == 0) return 0;
+
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        auto rank = static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(count_) + 0.5);
+        rank = std::clamp<std::uint64_t>(rank, 1, count_);
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(bucket_upper_bound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    QueryCounters& QueryCounters::operator+=(const QueryCounters& other) {
+        rows_scanned += other.rows_scanned;
+        tag_rows_scanned += other.tag_rows_scanned;
+        predicates_evaluated += other.predicates_evaluated;
+        matches += other.matches;
+        bytes_allocated += other.bytes_allocated;
+        return *this;
+    }
+
+    AdmissionCounters& AdmissionCounters::operator+=(const AdmissionCounters& other) {
+        rejected += other.rejected;
+        timed_out += other.timed_out;
+        cancelled += other.cancelled;
+        return *this;
+    }
+
+    void Instrumentation::record(const std::string& stage, std::uint64_t nanoseconds) {
+        auto it = std::find_if(stages_.begin(), stages_.end(),
+            [&](const auto& entry) { return entry.first == stage; });
+        if (it == stages_.end()) {
+            stages_.emplace_back(stage, LatencyHistogram{});
+            it = std::prev(stages_.end());
+        }
+        it->second.record(nanoseconds);
+    }
+
+    void Instrumentation::add_counters(const QueryCounters& counters) {
+        totals_ += counters;
+        ++queries_;
+    }
+
+    void Instrumentation::add_admission(const AdmissionCounters& counters) {
+        admission_ += counters;
+    }
+
+    void Instrumentation::print_stats(std::ostream& out) const {
+        if (stages_.empty()) {
+            out << "No queries recorded yet.\n";
+            return;
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+
+        out << "Stage latencies (microseconds):\n";
+        out << "  " << std::left << std::setw(14) << "stage" << std::right
+            << std::setw(8) << "count"
+            << std::setw(12) << "p50"
+            << std::setw(12) << "p90"
+            << std::setw(12) << "p99"
+            << std::setw(12) << "p99.9"
+            << std::setw(12) << "max" << "\n";
+
+        out << std::fixed << std::setprecision(1);
+        for (const auto& [stage, histogram] : stages_) {
+            out << "  " << std::left << std::setw(14) << stage << std::right
+                << std::setw(8) << histogram.count()
+                << std::setw(12) << to_microseconds(histogram.percentile(50.0))
+                << std::setw(12) << to_microseconds(histogram.percentile(90.0))
+                << std::setw(12) << to_microseconds(histogram.percentile(99.0))
+                << std::setw(12) << to_microseconds(histogram.percentile(99.9))
+                << std::setw(12) << to_microseconds(histogram.max()) << "\n";
+        }
+
+        out << "Counters over " << queries_ << " queries:\n"
+            << "  rows scanned         : " << totals_.rows_scanned << "\n"
+            << "  tag rows scanned     : " << totals_.tag_rows_scanned << "\n"
+            << "  predicates evaluated : " << totals_.predicates_evaluated << "\n"
+            << "  matches              : " << totals_.matches << "\n"
+            << "  bytes allocated      : " << totals_.bytes_allocated << "\n"
+            << "Admission control:\n"
+            << "  rejected             : " << admission_.rejected << "\n"
+            << "  timed out            : " << admission_.timed_out << "\n"
+            << "  cancelled            : " << admission_.cancelled << "\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    ScopedTimer::ScopedTimer(Instrumentation& registry, std::string stage, QueryTrace* trace)
+        : registry_(&registry), stage_(std::move(stage)), trace_(trace), start_(std::chrono::steady_clock::now()) {
+    }
+
+    ScopedTimer::ScopedTimer(QueryTrace& trace, std::string stage)
+        : registry_(nullptr), stage_(std::move(stage)), trace_(&trace), start_(std::chrono::steady_clock::now()) {
+    }
+
+    ScopedTimer::~ScopedTimer() {
+        const auto nanoseconds = nanoseconds_since(start_);
+        if (registry_) registry_->record(stage_, nanoseconds);
+        if (trace_) {
+            trace_->stages.push_back({ stage_, nanoseconds });
+        }
+    }
+
+    void print_trace(std::ostream& out, const QueryTrace& trace) {
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+
+        out << "Trace:" << std::fixed << std::setprecision(1);
+        for (const auto& sample : trace.stages) {
+            out << " " << sample.stage << "=" << to_microseconds(sample.nanoseconds) << "us";
+        }
+        out << "\n       rows_scanned=" << trace.counters.rows_scanned
+            << " tag_rows_scanned=" << trace.counters.tag_rows_scanned
+            << " predicates=" << trace.counters.predicates_evaluated
+            << " matches=" << trace.counters.matches
+            << " bytes_allocated=" << trace.counters.bytes_allocated << "\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    std::uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start) {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+}
@@ -0,0 +1,170 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file instrumentation.h
+ * @date 2025-09-22
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shared::utils {
+
+    /**
+     * @brief HDR-style log-linear histogram for nanosecond latencies.
+     *
+     * Values below 32 are stored exactly; above that every power of two is split
+     * into 32 linear sub-buckets, which bounds the relative error to ~3% while
+     * the whole histogram stays a fixed 15KB array without any allocation.
+     */
+    class LatencyHistogram {
+    public:
+        /**
+         * @brief Record a single latency sample
+         * @param value_ns Latency in nanoseconds
+         */
+        void record(std::uint64_t value_ns);
+
+        /**
+         * @brief Value at the given percentile (highest equivalent value of its bucket)
+         * @param percentile Percentile in the range [0, 100]
+         * @return Latency in nanoseconds, 0 if no samples were recorded
+         */
+        std::uint64_t percentile(double percentile) const;
+
+        std::uint64_t count() const { return count_; }
+        std::uint64_t min() const { return count_ ? min_ : 0; }
+        std::uint64_t max() const { return max_; }
+        double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    private:
+        static constexpr int sub_bucket_bits = 5;
+        static constexpr std::size_t sub_bucket_count = std::size_t{ 1 } << sub_bucket_bits;
+        static constexpr std::size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+        static std::size_t bucket_index(std::uint64_t value);
+        static std::uint64_t bucket_upper_bound(std::size_t index);
+
+        std::array<std::uint64_t, bucket_count> counts_{};
+        std::uint64_t count_ = 0;
+        std::uint64_t sum_ = 0;
+        std::uint64_t min_ = UINT64_MAX;
+        std::uint64_t max_ = 0;
+    };
+
+    // Work counters gathered while answering a query.
+    struct QueryCounters {
+        std::uint64_t rows_scanned = 0;         // movie rows (or postings) visited
+        std::uint64_t tag_rows_scanned = 0;     // tag rows compared against --tag keywords
+        std::uint64_t predicates_evaluated = 0;
+        std::uint64_t matches = 0;
+        std::uint64_t bytes_allocated = 0;
+
+        QueryCounters& operator+=(const QueryCounters& other);
+    };
+
+    // Commands turned away or stopped early by admission control.
+    struct AdmissionCounters {
+        std::uint64_t rejected = 0;     // shed because every worker and queue slot was taken
+        std::uint64_t timed_out = 0;    // stopped at their deadline
+        std::uint64_t cancelled = 0;    // stopped by the cancel command
+
+        AdmissionCounters& operator+=(const AdmissionCounters& other);
+    };
+
+    // Timing of a single stage within one query.
+    struct StageSample {
+        std::string stage;
+        std::uint64_t nanoseconds = 0;
+    };
+
+    // Per-query breakdown, printed when tracing is enabled.
+    struct QueryTrace {
+        std::vector<StageSample> stages;
+        QueryCounters counters;
+    };
+
+    /**
+     * @brief Registry of per-stage latency histograms and accumulated counters.
+     *
+     * Stages are kept in first-seen order so the report follows the pipeline.
+     */
+    class Instrumentation {
+    public:
+        /**
+         * @brief Record the duration of a stage
+         * @param stage Stage name (e.g. "search")
+         * @param nanoseconds Measured duration
+         */
+        void record(const std::string& stage, std::uint64_t nanoseconds);
+
+        /**
+         * @brief Add the counters of a finished query to the totals
+         * @param counters Counters of the query
+         */
+        void add_counters(const QueryCounters& counters);
+
+        /**
+         * @brief Add rejected, timed-out or cancelled commands to the totals
+         * @param counters Commands to add
+         */
+        void add_admission(const AdmissionCounters& counters);
+
+        /**
+         * @brief Print count, percentiles and max per stage plus counter totals
+         * @param out Output stream to write to
+         */
+        void print_stats(std::ostream& out) const;
+
+        const std::vector<std::pair<std::string, LatencyHistogram>>& stages() const { return stages_; }
+        const QueryCounters& totals() const { return totals_; }
+        const AdmissionCounters& admission() const { return admission_; }
+        std::uint64_t queries() const { return queries_; }
+
+    private:
+        std::vector<std::pair<std::string, LatencyHistogram>> stages_;
+        QueryCounters totals_;
+        AdmissionCounters admission_;
+        std::uint64_t queries_ = 0;
+    };
+
+    /**
+     * @brief RAII timer on the monotonic clock; records into the registry (and trace) on destruction.
+     *
+     * The trace-only form is for stages timed on a worker thread: the registry is not thread-safe,
+     * so their samples are recorded from the trace later on the command thread.
+     */
+    class ScopedTimer {
+    public:
+        ScopedTimer(Instrumentation& registry, std::string stage, QueryTrace* trace = nullptr);
+        ScopedTimer(QueryTrace& trace, std::string stage);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Instrumentation* registry_;
+        std::string stage_;
+        QueryTrace* trace_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief Print a per-query breakdown (stage durations and counters) on one block
+     * @param out Output stream to write to
+     * @param trace Trace of the query
+     */
+    void print_trace(std::ostream& out, const QueryTrace& trace);
+
+    /**
+     * @brief Nanoseconds on the monotonic clock since start (for stages that span threads)
+     */
+    std::uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start);
+
+}
@@ -0,0 +1,51 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file memory_usage.cpp
+ * @date 2025-10-04
+ */
+
+#include "memory_usage.h"
+
+#include <charconv>
+#include <fstream>
+#include <string_view>
+
+namespace shared::utils {
+
+    namespace
+    {
+        // "VmRSS:     12345 kB" -> bytes
+        std::optional<std::uint64_t> kilobytes_field(std::string_view line, std::string_view name) {
+            if (!line.starts_with(name)) return std::nullopt;
+            line.remove_prefix(name.size());
+            const auto first = line.find_first_not_of(" \t");
+            if (first == std::string_view::npos) return std::nullopt;
+            std::uint64_t kilobytes = 0;
+            const auto [end, error] = std::from_chars(line.data() + first, line.data() + line.size(), kilobytes);
+            if (error != std::errc()) return std::nullopt;
+            return kilobytes * 1024;
+        }
+    }
+
+    std::optional<ProcessMemory> process_memory() {
+        std::ifstream status("/proc/self/status");
+        if (!status) return std::nullopt;
+
+        ProcessMemory memory;
+        bool found = false;
+        std::string line;
+        while (std::getline(status, line)) {
+            if (const auto rss = kilobytes_field(line, "VmRSS:")) {
+                memory.rss_bytes = *rss;
+                found = true;
+            }
+            else if (const auto peak = kilobytes_field(line, "VmHWM:")) {
+                memory.peak_rss_bytes = *peak;
+                found = true;
+            }
+        }
+        if (!found) return std::nullopt;
+        return memory;
+    }
+
+}
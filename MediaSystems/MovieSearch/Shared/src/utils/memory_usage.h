@@ -0,0 +1,70 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file memory_usage.h
+ * @date 2025-10-04
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace shared::utils {
+
+    // Size accounting helpers for the memory_bytes() hooks of models and indexes: they count what a
+    // container holds outside its own object (so a member's sizeof is not counted twice).
+
+    /**
+     * @brief Heap bytes of a string; 0 while it fits the small-string buffer
+     */
+    template <typename Char, typename Traits, typename Alloc>
+    std::size_t string_bytes(const std::basic_string<Char, Traits, Alloc>& text) {
+        static const auto inline_capacity = std::basic_string<Char, Traits, Alloc>().capacity();
+        return text.capacity() > inline_capacity ? (text.capacity() + 1) * sizeof(Char) : 0;
+    }
+
+    /**
+     * @brief Heap bytes of a vector: its capacity, plus the heap bytes of string or vector elements
+     */
+    template <typename T, typename Alloc>
+    std::size_t vector_bytes(const std::vector<T, Alloc>& values) {
+        std::size_t bytes = values.capacity() * sizeof(T);
+        if constexpr (requires(const T& value) { string_bytes(value); }) {
+            for (const auto& value : values) bytes += string_bytes(value);
+        }
+        else if constexpr (requires(const T& value) { vector_bytes(value); }) {
+            for (const auto& value : values) bytes += vector_bytes(value);
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Approximate heap bytes of a node-based hash map (bucket array, one node per entry with
+     *        its next pointer and cached hash, and the heap bytes of string keys)
+     */
+    template <typename Map>
+    std::size_t hash_map_bytes(const Map& map) {
+        constexpr std::size_t node = sizeof(typename Map::value_type) + sizeof(void*) + sizeof(std::size_t);
+        std::size_t bytes = map.bucket_count() * sizeof(void*) + map.size() * node;
+        if constexpr (requires(const typename Map::key_type& key) { string_bytes(key); }) {
+            for (const auto& entry : map) bytes += string_bytes(entry.first);
+        }
+        return bytes;
+    }
+
+    // Resident set of the process, as the kernel reports it.
+    struct ProcessMemory {
+        std::uint64_t rss_bytes = 0;        // VmRSS: resident now
+        std::uint64_t peak_rss_bytes = 0;   // VmHWM: highest resident set so far
+    };
+
+    /**
+     * @brief Read VmRSS and VmHWM from /proc/self/status
+     * @return The sizes, std::nullopt where /proc is not available (e.g. Windows)
+     */
+    std::optional<ProcessMemory> process_memory();
+
+}
@@ -0,0 +1,324 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file simd.cpp
+ * @date 2025-09-30
+ */
+
+#include "simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHARED_UTILS_HAS_SSE2 1
+#endif
+
+// AVX2 kernels are compiled for the target attribute only and run after a runtime CPU check,
+// so the rest of the build keeps its baseline instruction set.
+#if defined(SHARED_UTILS_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SHARED_UTILS_HAS_AVX2 1
+#define SHARED_UTILS_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(SHARED_UTILS_HAS_SSE2) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#define SHARED_UTILS_HAS_AVX2 1
+#define SHARED_UTILS_TARGET_AVX2
+#endif
+
+namespace shared::utils {
+
+    namespace
+    {
+        using PopcountKernel = std::size_t (*)(const std::uint64_t*, const std::uint64_t*, std::size_t);
+
+        std::size_t popcount_and_portable(const std::uint64_t* a, const std::uint64_t* b, std::size_t words) {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < words; ++i) count += static_cast<std::size_t>(std::popcount(a[i] & b[i]));
+            return count;
+        }
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        // Same loop compiled for POPCNT; four counters keep the popcnt units busy.
+        __attribute__((target("popcnt")))
+        std::size_t popcount_and_popcnt(const std::uint64_t* a, const std::uint64_t* b, std::size_t words) {
+            std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+            std::size_t i = 0;
+            for (; i + 4 <= words; i += 4) {
+                c0 += static_cast<std::size_t>(__builtin_popcountll(a[i] & b[i]));
+                c1 += static_cast<std::size_t>(__builtin_popcountll(a[i + 1] & b[i + 1]));
+                c2 += static_cast<std::size_t>(__builtin_popcountll(a[i + 2] & b[i + 2]));
+                c3 += static_cast<std::size_t>(__builtin_popcountll(a[i + 3] & b[i + 3]));
+            }
+            for (; i < words; ++i) c0 += static_cast<std::size_t>(__builtin_popcountll(a[i] & b[i]));
+            return c0 + c1 + c2 + c3;
+        }
+#endif
+
+        PopcountKernel popcount_kernel() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            if (__builtin_cpu_supports("popcnt")) return popcount_and_popcnt;
+#endif
+            // MSVC's std::popcount already checks for POPCNT at runtime.
+            return popcount_and_portable;
+        }
+    }
+
+    std::size_t popcount_and(const std::uint64_t* a, const std::uint64_t* b, std::size_t words) {
+        static const PopcountKernel kernel = popcount_kernel();
+        return kernel(a, b, words);
+    }
+
+    float dot(const float* a, const float* b, std::size_t n) {
+#ifdef SHARED_UTILS_HAS_SSE2
+        // Two accumulators hide the latency of the dependent adds.
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 2 * simd_width <= n; i += 2 * simd_width) {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_load_ps(a + i), _mm_load_ps(b + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_load_ps(a + i + simd_width), _mm_load_ps(b + i + simd_width)));
+        }
+        if (i < n) {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_load_ps(a + i), _mm_load_ps(b + i)));
+        }
+        sum0 = _mm_add_ps(sum0, sum1);
+        // Horizontal sum of the four lanes.
+        __m128 shuffled = _mm_shuffle_ps(sum0, sum0, _MM_SHUFFLE(2, 3, 0, 1));
+        sum0 = _mm_add_ps(sum0, shuffled);
+        shuffled = _mm_movehl_ps(shuffled, sum0);
+        return _mm_cvtss_f32(_mm_add_ss(sum0, shuffled));
+#else
+        float sum = 0.0f;
+        for (std::size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+        return sum;
+#endif
+    }
+
+    void axpy(float alpha, const float* x, float* y, std::size_t n) {
+#ifdef SHARED_UTILS_HAS_SSE2
+        const __m128 scale = _mm_set1_ps(alpha);
+        for (std::size_t i = 0; i < n; i += simd_width) {
+            _mm_store_ps(y + i, _mm_add_ps(_mm_load_ps(y + i), _mm_mul_ps(scale, _mm_load_ps(x + i))));
+        }
+#else
+        for (std::size_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+#endif
+    }
+
+    namespace
+    {
+        // Kernels take the text, the (non-empty) delimiter and, for find, the start position.
+        using FindKernel = std::size_t (*)(std::string_view, std::string_view, std::size_t);
+        using SplitKernel = std::size_t (*)(std::string_view, std::string_view, std::span<std::string_view>);
+
+        std::size_t find_scalar(std::string_view text, std::string_view delimiter, std::size_t start) {
+            return text.find(delimiter, start);
+        }
+
+        // Appends the fields of text[field_start..] to fields[count..], searching for delimiters from search_from.
+        std::size_t split_tail(std::string_view text, std::string_view delimiter, std::size_t field_start, std::size_t search_from,
+            std::span<std::string_view> fields, std::size_t count) {
+            std::size_t pos;
+            while ((pos = text.find(delimiter, search_from)) != std::string_view::npos) {
+                if (count == fields.size()) return count + 1;
+                fields[count++] = text.substr(field_start, pos - field_start);
+                field_start = search_from = pos + delimiter.size();
+            }
+            if (count == fields.size()) return count + 1;
+            fields[count++] = text.substr(field_start);
+            return count;
+        }
+
+        std::size_t split_scalar(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields) {
+            return split_tail(text, delimiter, 0, 0, fields, 0);
+        }
+
+        // Whether a candidate whose first and last bytes matched is the whole delimiter.
+        inline bool delimiter_at(const char* candidate, std::string_view delimiter) {
+            return delimiter.size() <= 2 || std::memcmp(candidate + 1, delimiter.data() + 1, delimiter.size() - 2) == 0;
+        }
+
+        /*
+         * Both SIMD kernels compare the first delimiter byte against block [i, i + W) and the last
+         * byte against [i + n - 1, i + n - 1 + W); bit p of the AND of both masks marks a candidate
+         * at i + p. Blocks never read past the text; the remaining tail is scanned scalar.
+         */
+#ifdef SHARED_UTILS_HAS_SSE2
+        inline unsigned candidates_sse2(const char* block, std::size_t length, __m128i first, __m128i last) {
+            const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+            const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + length - 1));
+            return static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        }
+
+        std::size_t find_sse2(std::string_view text, std::string_view delimiter, std::size_t start) {
+            const __m128i first = _mm_set1_epi8(delimiter.front());
+            const __m128i last = _mm_set1_epi8(delimiter.back());
+            auto i = start;
+            for (; i + delimiter.size() - 1 + 16 <= text.size(); i += 16) {
+                for (auto mask = candidates_sse2(text.data() + i, delimiter.size(), first, last); mask != 0; mask &= mask - 1) {
+                    const auto pos = i + static_cast<std::size_t>(std::countr_zero(mask));
+                    if (delimiter_at(text.data() + pos, delimiter)) return pos;
+                }
+            }
+            return text.find(delimiter, i);
+        }
+
+        // Continues a split at block position i with count fields found and the current field at field_start.
+        std::size_t split_sse2_from(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields,
+            std::size_t count, std::size_t field_start, std::size_t i) {
+            const __m128i first = _mm_set1_epi8(delimiter.front());
+            const __m128i last = _mm_set1_epi8(delimiter.back());
+            for (; i + delimiter.size() - 1 + 16 <= text.size(); i += 16) {
+                for (auto mask = candidates_sse2(text.data() + i, delimiter.size(), first, last); mask != 0; mask &= mask - 1) {
+                    const auto pos = i + static_cast<std::size_t>(std::countr_zero(mask));
+                    if (pos < field_start || !delimiter_at(text.data() + pos, delimiter)) continue;
+                    if (count == fields.size()) return count + 1;
+                    fields[count++] = text.substr(field_start, pos - field_start);
+                    field_start = pos + delimiter.size();
+                }
+            }
+            return split_tail(text, delimiter, field_start, std::max(i, field_start), fields, count);
+        }
+
+        std::size_t split_sse2(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields) {
+            return split_sse2_from(text, delimiter, fields, 0, 0, 0);
+        }
+#endif
+
+#ifdef SHARED_UTILS_HAS_AVX2
+        SHARED_UTILS_TARGET_AVX2
+        inline unsigned candidates_avx2(const char* block, std::size_t length, __m256i first, __m256i last) {
+            const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + length - 1));
+            return static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        }
+
+        SHARED_UTILS_TARGET_AVX2
+        std::size_t find_avx2(std::string_view text, std::string_view delimiter, std::size_t start) {
+            const __m256i first = _mm256_set1_epi8(delimiter.front());
+            const __m256i last = _mm256_set1_epi8(delimiter.back());
+            auto i = start;
+            for (; i + delimiter.size() - 1 + 32 <= text.size(); i += 32) {
+                for (auto mask = candidates_avx2(text.data() + i, delimiter.size(), first, last); mask != 0; mask &= mask - 1) {
+                    const auto pos = i + static_cast<std::size_t>(std::countr_zero(mask));
+                    if (delimiter_at(text.data() + pos, delimiter)) return pos;
+                }
+            }
+            return find_sse2(text, delimiter, i);
+        }
+
+        SHARED_UTILS_TARGET_AVX2
+        std::size_t split_avx2(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields) {
+            const __m256i first = _mm256_set1_epi8(delimiter.front());
+            const __m256i last = _mm256_set1_epi8(delimiter.back());
+            std::size_t count = 0;
+            std::size_t field_start = 0;
+            std::size_t i = 0;
+            for (; i + delimiter.size() - 1 + 32 <= text.size(); i += 32) {
+                for (auto mask = candidates_avx2(text.data() + i, delimiter.size(), first, last); mask != 0; mask &= mask - 1) {
+                    const auto pos = i + static_cast<std::size_t>(std::countr_zero(mask));
+                    if (pos < field_start || !delimiter_at(text.data() + pos, delimiter)) continue;
+                    if (count == fields.size()) return count + 1;
+                    fields[count++] = text.substr(field_start, pos - field_start);
+                    field_start = pos + delimiter.size();
+                }
+            }
+            // Lines shorter than a 32-byte block (ratings.dat) still get a 16-byte pass.
+            return split_sse2_from(text, delimiter, fields, count, field_start, i);
+        }
+
+        bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int registers[4];
+            __cpuid(registers, 0);
+            if (registers[0] < 7) return false;
+            __cpuid(registers, 1);
+            const bool os_saves_ymm = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(registers, 7, 0);
+            return os_saves_ymm && (registers[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        FindKernel find_kernel(SimdLevel level) {
+            switch (std::min(level, detected_simd_level())) {
+#ifdef SHARED_UTILS_HAS_AVX2
+            case SimdLevel::avx2: return find_avx2;
+#endif
+#ifdef SHARED_UTILS_HAS_SSE2
+            case SimdLevel::sse2: return find_sse2;
+#endif
+            default: return find_scalar;
+            }
+        }
+
+        SplitKernel split_kernel(SimdLevel level) {
+            switch (std::min(level, detected_simd_level())) {
+#ifdef SHARED_UTILS_HAS_AVX2
+            case SimdLevel::avx2: return split_avx2;
+#endif
+#ifdef SHARED_UTILS_HAS_SSE2
+            case SimdLevel::sse2: return split_sse2;
+#endif
+            default: return split_scalar;
+            }
+        }
+
+        std::size_t scan_fields_with(SplitKernel kernel, std::string_view text, std::string_view delimiter, std::span<std::string_view> fields) {
+            if (!delimiter.empty()) return kernel(text, delimiter, fields);
+            if (fields.empty()) return 1;
+            fields[0] = text;
+            return 1;
+        }
+    }
+
+    SimdLevel detected_simd_level() {
+        static const SimdLevel level = [] {
+#ifdef SHARED_UTILS_HAS_AVX2
+            if (cpu_has_avx2()) return SimdLevel::avx2;
+#endif
+#ifdef SHARED_UTILS_HAS_SSE2
+            return SimdLevel::sse2;
+#else
+            return SimdLevel::scalar;
+#endif
+        }();
+        return level;
+    }
+
+    const char* simd_level_name(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::avx2: return "avx2";
+        case SimdLevel::sse2: return "sse2";
+        default: return "scalar";
+        }
+    }
+
+    std::size_t find_delimiter(std::string_view text, std::string_view delimiter, std::size_t start) {
+        static const FindKernel kernel = find_kernel(SimdLevel::avx2);
+        if (delimiter.empty() || start >= text.size()) return text.find(delimiter, start);
+        return kernel(text, delimiter, start);
+    }
+
+    std::size_t find_delimiter(std::string_view text, std::string_view delimiter, std::size_t start, SimdLevel level) {
+        if (delimiter.empty() || start >= text.size()) return text.find(delimiter, start);
+        return find_kernel(level)(text, delimiter, start);
+    }
+
+    std::size_t scan_fields(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields) {
+        static const SplitKernel kernel = split_kernel(SimdLevel::avx2);
+        return scan_fields_with(kernel, text, delimiter, fields);
+    }
+
+    std::size_t scan_fields(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields, SimdLevel level) {
+        return scan_fields_with(split_kernel(level), text, delimiter, fields);
+    }
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file simd.h
+ * @date 2025-09-30
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace shared::utils {
+
+    // Float lanes processed per SIMD step; padded vectors have a multiple of this length.
+    constexpr std::size_t simd_width = 4;
+
+    /**
+     * @brief Round a length up to a multiple of simd_width
+     */
+    constexpr std::size_t simd_padded(std::size_t n) {
+        return (n + simd_width - 1) / simd_width * simd_width;
+    }
+
+    /**
+     * @brief Dot product of two padded float vectors (SSE on x86, scalar elsewhere)
+     * @param a 16-byte aligned vector
+     * @param b 16-byte aligned vector
+     * @param n Length, a multiple of simd_width
+     * @return Sum of a[i] * b[i]
+     */
+    float dot(const float* a, const float* b, std::size_t n);
+
+    /**
+     * @brief y += alpha * x over padded float vectors
+     * @param alpha Scale factor
+     * @param x 16-byte aligned vector
+     * @param y 16-byte aligned vector, updated in place
+     * @param n Length, a multiple of simd_width
+     */
+    void axpy(float alpha, const float* x, float* y, std::size_t n);
+
+    /**
+     * @brief Number of bits set in a[i] & b[i] over two bitmaps, with the POPCNT instruction when the
+     *        CPU has it (checked once at runtime) and a portable bit count otherwise
+     * @param a Bitmap words
+     * @param b Bitmap words
+     * @param words Number of words in both
+     * @return The popcount of the intersection
+     */
+    std::size_t popcount_and(const std::uint64_t* a, const std::uint64_t* b, std::size_t words);
+
+    // Instruction sets of the byte scanners, in increasing order.
+    enum class SimdLevel { scalar, sse2, avx2 };
+
+    // Best level supported by this CPU (and build), detected once at runtime.
+    SimdLevel detected_simd_level();
+
+    const char* simd_level_name(SimdLevel level);
+
+    /**
+     * @brief Find a (multi-byte) delimiter by comparing its first and last byte against 16 (SSE2)
+     *        or 32 (AVX2) text positions at once; candidate positions are verified with memcmp.
+     *        The kernel is picked from detected_simd_level(); short tails are scanned scalar.
+     * @param text Text to scan
+     * @param delimiter Delimiter to find
+     * @param start First position to consider
+     * @return Position of the first occurrence at or after start, or std::string_view::npos
+     */
+    std::size_t find_delimiter(std::string_view text, std::string_view delimiter, std::size_t start = 0);
+
+    // Same with an explicit level (capped at the detected one), to compare kernels.
+    std::size_t find_delimiter(std::string_view text, std::string_view delimiter, std::size_t start, SimdLevel level);
+
+    /**
+     * @brief Split text at a delimiter into caller-provided field slots in one SIMD pass over the text
+     * @param text Text to split (the fields view into it)
+     * @param delimiter Delimiter string
+     * @param fields Output slots
+     * @return Number of fields in text; fields.size() + 1 means there were more than fit
+     */
+    std::size_t scan_fields(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields);
+
+    std::size_t scan_fields(std::string_view text, std::string_view delimiter, std::span<std::string_view> fields, SimdLevel level);
+
+}
@@ -6,12 +6,223 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace shared::utils {
+
+    enum class SortDirection { ascending, descending };
+
+    /**
+     * @brief One sort key: a projection (member pointer or callable) and a direction fixed at
+     *        compile time, so the comparison has no direction branch.
+     */
+    template <SortDirection Direction, typename Projection>
+    struct SortKey {
+        static constexpr SortDirection direction = Direction;
+        Projection projection;
+
+        template <typename T>
+        decltype(auto) operator()(const T& value) const { return std::invoke(projection, value); }
+
+        // True if a goes before b by this key alone.
+        template <typename T>
+        bool before(const T& a, const T& b) const {
+            if constexpr (Direction == SortDirection::ascending) return (*this)(a) < (*this)(b);
+            else return (*this)(b) < (*this)(a);
+        }
+    };
+
+    template <typename Projection>
+    constexpr SortKey<SortDirection::ascending, Projection> ascending(Projection projection) { return { projection }; }
+
+    template <typename Projection>
+    constexpr SortKey<SortDirection::descending, Projection> descending(Projection projection) { return { projection }; }
+
+    /**
+     * @brief Lexicographic order over several keys: the first key on which two values differ decides
+     */
+    template <typename... Keys>
+    struct KeyOrder {
+        std::tuple<Keys...> keys;
+
+        template <typename T>
+        bool operator()(const T& a, const T& b) const { return compare<0>(a, b); }
+
+    private:
+        template <std::size_t I, typename T>
+        bool compare(const T& a, const T& b) const {
+            if constexpr (I == sizeof...(Keys)) {
+                return false;
+            }
+            else {
+                const auto& key = std::get<I>(keys);
+                if (key.before(a, b)) return true;
+                if (key.before(b, a)) return false;
+                return compare<I + 1>(a, b);
+            }
+        }
+    };
+
+    template <typename... Keys>
+    constexpr KeyOrder<Keys...> key_order(Keys... keys) { return { std::tuple<Keys...>(keys...) }; }
+
+    // Below this many elements sort_by uses a comparison sort even for integer keys.
+    inline constexpr std::size_t radix_sort_threshold = 256;
+    // From this many elements on the comparison sort is split over threads.
+    inline constexpr std::size_t parallel_sort_threshold = std::size_t{ 1 } << 16;
+
+    /**
+     * @brief Stable merge sort over threads: each thread stable-sorts one run, then neighbouring
+     *        runs are merged pairwise, the merges of a round in parallel
+     * @param threads Worker threads, 0 = std::thread::hardware_concurrency(); runs are at least
+     *        parallel_sort_threshold / 4 elements
+     */
+    template <std::random_access_iterator It, typename Compare>
+    void parallel_stable_sort(It first, It last, Compare compare, std::size_t threads = 0) {
+        const auto size = static_cast<std::size_t>(last - first);
+        if (!threads) threads = std::thread::hardware_concurrency();
+        threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(size / (parallel_sort_threshold / 4), 1));
+        if (threads == 1) {
+            std::stable_sort(first, last, compare);
+            return;
+        }
+
+        std::vector<It> bounds(threads + 1);
+        for (std::size_t run = 0; run <= threads; ++run) bounds[run] = first + static_cast<std::ptrdiff_t>(size * run / threads);
+
+        std::vector<std::thread> pool;
+        for (std::size_t run = 1; run < threads; ++run) {
+            pool.emplace_back([&, run] { std::stable_sort(bounds[run], bounds[run + 1], compare); });
+        }
+        std::stable_sort(bounds[0], bounds[1], compare);
+        for (auto& thread : pool) thread.join();
+
+        for (std::size_t width = 1; width < threads; width *= 2) {
+            pool.clear();
+            for (std::size_t run = 0; run + width < threads; run += 2 * width) {
+                const auto end = std::min(run + 2 * width, threads);
+                pool.emplace_back([&, run, width, end] { std::inplace_merge(bounds[run], bounds[run + width], bounds[end], compare); });
+            }
+            for (auto& thread : pool) thread.join();
+        }
+    }
+
+    namespace detail {
+        template <typename Key, typename T>
+        using key_value_t = std::remove_cvref_t<std::invoke_result_t<const Key&, const T&>>;
+
+        // Keys a radix pass can order: integers other than bool.
+        template <typename Key, typename T>
+        concept radix_key = std::integral<key_value_t<Key, T>> && !std::same_as<key_value_t<Key, T>, bool>;
+
+        // Unsigned code whose ascending order is the key order in the key's direction.
+        template <SortDirection Direction, std::integral Value>
+        auto radix_code(Value value) {
+            using Code = std::make_unsigned_t<Value>;
+            auto code = static_cast<Code>(value);
+            if constexpr (std::is_signed_v<Value>) code ^= static_cast<Code>(Code{ 1 } << (sizeof(Value) * 8 - 1));
+            if constexpr (Direction == SortDirection::descending) code = static_cast<Code>(~code);
+            return code;
+        }
+
+        // Stable LSD radix passes (8 bits each) of one key over a permutation of the elements;
+        // a pass whose byte is the same for every element is skipped.
+        template <std::random_access_iterator It, typename Key>
+        void radix_passes(It first, const Key& key, std::vector<std::uint32_t>& order, std::vector<std::uint32_t>& scratch) {
+            using Value = key_value_t<Key, std::iter_value_t<It>>;
+            using Code = decltype(radix_code<Key::direction>(Value{}));
+
+            std::vector<Code> codes(order.size());
+            std::vector<Code> next_codes(order.size());
+            for (std::size_t i = 0; i < order.size(); ++i) codes[i] = radix_code<Key::direction>(static_cast<Value>(key(first[order[i]])));
+
+            for (std::size_t shift = 0; shift < sizeof(Code) * 8; shift += 8) {
+                std::array<std::size_t, 256> counts{};
+                for (const auto code : codes) ++counts[(code >> shift) & 0xFF];
+                if (std::find(counts.begin(), counts.end(), order.size()) != counts.end()) continue;
+
+                std::size_t position = 0;
+                for (auto& count : counts) position += std::exchange(count, position);
+                for (std::size_t i = 0; i < order.size(); ++i) {
+                    const auto target = counts[(codes[i] >> shift) & 0xFF]++;
+                    scratch[target] = order[i];
+                    next_codes[target] = codes[i];
+                }
+                order.swap(scratch);
+                codes.swap(next_codes);
+            }
+        }
+
+        template <std::random_access_iterator It, typename... Keys>
+        void radix_sort(It first, It last, const Keys&... keys) {
+            const auto size = static_cast<std::size_t>(last - first);
+            std::vector<std::uint32_t> order(size);
+            std::vector<std::uint32_t> scratch(size);
+            for (std::size_t i = 0; i < size; ++i) order[i] = static_cast<std::uint32_t>(i);
+
+            // Stable passes from the last key to the first leave the first key most significant
+            const std::tuple<const Keys&...> tuple(keys...);
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (radix_passes(first, std::get<sizeof...(Keys) - 1 - I>(tuple), order, scratch), ...);
+            }(std::index_sequence_for<Keys...>{});
+
+            std::vector<std::iter_value_t<It>> sorted;
+            sorted.reserve(size);
+            for (const auto i : order) sorted.push_back(std::move(first[i]));
+            std::move(sorted.begin(), sorted.end(), first);
+        }
+    }
+
+    /**
+     * @brief Stable sort of a random-access range by one or more keys, e.g.
+     *        sort_by(movies, descending(&Movie::rating), descending(&Movie::votes), ascending(&Movie::title))
+     *
+     * If every key is an integer (and the range has at least radix_sort_threshold elements), the
+     * elements are ordered with LSD radix passes over a permutation, last key first, and moved
+     * into place once. Otherwise it is a stable comparison sort over KeyOrder, split over threads
+     * from parallel_sort_threshold elements on. Equal elements keep their order in both cases.
+     */
+    template <std::ranges::random_access_range Range, typename... Keys>
+    void sort_by(Range&& range, Keys... keys) {
+        static_assert(sizeof...(Keys) > 0, "sort_by needs at least one key");
+        using Value = std::ranges::range_value_t<Range>;
+        const auto first = std::ranges::begin(range);
+        const auto last = std::ranges::end(range);
+        const auto size = static_cast<std::size_t>(last - first);
+        if (size < 2) return;
+
+        if constexpr ((detail::radix_key<Keys, Value> && ...)) {
+            if (size >= radix_sort_threshold && size <= std::numeric_limits<std::uint32_t>::max()) {
+                detail::radix_sort(first, last, keys...);
+                return;
+            }
+        }
+        const auto order = key_order(keys...);
+        if (size >= parallel_sort_threshold) parallel_stable_sort(first, last, order);
+        else std::stable_sort(first, last, order);
+    }
+
+}
+
 template <typename Container, typename MemberPointerType>
 /**
  * Sorts the elements of a container based on a specified member of the elements.
  *
  * Uses the provided member pointer to access the member of each contained element
- * for comparison. The function can sort the container in ascending or descending order.
+ * for comparison. The function can sort the container in ascending or descending order;
+ * the direction is picked once, outside the comparison (see shared::utils::sort_by).
  *
  * @param container The container holding the elements to be sorted. Must support
  *                  begin() and end() functions, and its elements must support the
@@ -23,13 +234,6 @@ template <typename Container, typename MemberPointerType>
  *                  descending order.
  */
 void sortByMember(Container& container, MemberPointerType memberPtr, bool ascending = true) {
-    std::sort(container.begin(), container.end(),
-        [&](const auto& a, const auto& b) -> bool {
-            if (ascending) {
-                return a.*memberPtr < b.*memberPtr;
-            }
-            else {
-                return a.*memberPtr > b.*memberPtr;
-            }
-        });
-}
\ No newline at end of file
+    if (ascending) shared::utils::sort_by(container, shared::utils::ascending(memberPtr));
+    else shared::utils::sort_by(container, shared::utils::descending(memberPtr));
+}
@@ -5,6 +5,8 @@
  */
 
 #include "string_utils.h"
+#include "simd.h"
+#include "text_fold.h"
 
 #include <algorithm>
 #include <cctype>
@@ -39,7 +41,7 @@ namespace shared::utils {
     std::vector<std::string> split(const std::string& s, const std::string& delimiter) {
         std::vector<std::string> tokens;
         size_t pos = 0, start = 0;
-        while ((pos = s.find(delimiter, start)) != std::string::npos) {
+        while ((pos = find_delimiter(s, delimiter, start)) != std::string::npos) {
             tokens.push_back(s.substr(start, pos - start));
             start = pos + delimiter.length();
         }
@@ -47,37 +49,92 @@ namespace shared::utils {
         return tokens;
     }
 
-    bool case_insensitive_contains_word(const std::string& text, const std::string& word) {
-        if (word.empty()) return false;
-
-        // Split text into tokens by spaces (or smarter delimiters later)
-        auto tokens = shared::utils::split(text, " ");
-        std::string lowerWord;
-        lowerWord.reserve(word.size());
+    void split_view(std::string_view s, std::string_view delimiter, std::vector<std::string_view>& tokens) {
+        tokens.clear();
+        size_t pos = 0, start = 0;
+        while ((pos = find_delimiter(s, delimiter, start)) != std::string_view::npos) {
+            tokens.push_back(s.substr(start, pos - start));
+            start = pos + delimiter.length();
+        }
+        tokens.push_back(s.substr(start));
+    }
 
-        for (char c : word) lowerWord.push_back(std::tolower(static_cast<unsigned char>(c)));
+    std::size_t split_fields(std::string_view s, std::string_view delimiter, std::span<std::string_view> fields) {
+        return scan_fields(s, delimiter, fields);
+    }
 
-        for (auto& token : tokens) {
-            std::string lowerToken;
-            lowerToken.reserve(token.size());
-            for (char c : token) lowerToken.push_back(std::tolower(static_cast<unsigned char>(c)));
+    bool case_insensitive_contains_word(std::string_view text, std::string_view word) {
+        if (word.empty()) return false;
 
-            if (lowerToken == lowerWord) {
+        // Compare every space-separated token in place after case and accent folding (text_fold.h)
+        size_t start = 0;
+        while (start <= text.size()) {
+            auto end = text.find(' ', start);
+            if (end == std::string_view::npos) end = text.size();
+            if (end > start && folded_equal(text.substr(start, end - start), word)) {
                 return true;
             }
+            start = end + 1;
         }
         return false;
     }
 
-    std::string join(const std::vector<std::string>& vec, const std::string& delimiter) {
-        std::string result;
-        for (size_t i = 0; i < vec.size(); ++i) {
-            result += vec[i];
-            if (i + 1 < vec.size()) {
-                result += delimiter;
+    bool positions_form_phrase(std::span<const std::vector<std::uint32_t>> positions, std::size_t slop) {
+        if (positions.empty()) return false;
+        const auto extra = positions.size() - 1;
+        // From every start, take the earliest next occurrence of each word: that gives the shortest match for the start
+        for (const auto first : positions.front()) {
+            auto last = first;
+            for (std::size_t word = 1; word < positions.size(); ++word) {
+                const auto next = std::upper_bound(positions[word].begin(), positions[word].end(), last);
+                if (next == positions[word].end()) return false; // later starts cannot do better
+                last = *next;
             }
+            if (last - first - extra <= slop) return true;
         }
-        return result;
+        return false;
+    }
+
+    bool contains_phrase(std::string_view text, std::span<const std::string> words, std::size_t slop) {
+        std::vector<std::vector<std::uint32_t>> positions(words.size());
+        std::uint32_t position = 0;
+        size_t start = 0;
+        while (start < text.size()) {
+            auto end = text.find(' ', start);
+            if (end == std::string_view::npos) end = text.size();
+            if (end > start) {
+                const auto token = text.substr(start, end - start);
+                for (std::size_t word = 0; word < words.size(); ++word) {
+                    if (folded_equal(token, words[word])) positions[word].push_back(position);
+                }
+                ++position;
+            }
+            start = end + 1;
+        }
+        return positions_form_phrase(positions, slop);
+    }
+
+    namespace
+    {
+        template <typename Strings>
+        std::string join_strings(const Strings& vec, const std::string& delimiter) {
+            std::string result;
+            for (size_t i = 0; i < vec.size(); ++i) {
+                result += vec[i];
+                if (i + 1 < vec.size()) {
+                    result += delimiter;
+                }
+            }
+            return result;
+        }
+    }
+
+    std::string join(const std::vector<std::string>& vec, const std::string& delimiter) {
+        return join_strings(vec, delimiter);
+    }
+
+    std::string join(const std::pmr::vector<std::pmr::string>& vec, const std::string& delimiter) {
+        return join_strings(vec, delimiter);
     }
 
 }
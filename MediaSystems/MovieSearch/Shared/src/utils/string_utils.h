@@ -5,7 +5,12 @@
  * @date 2025-09-16
  */
 
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace shared::utils {
@@ -48,12 +53,47 @@ namespace shared::utils {
     std::vector<std::string> split(const std::string& s, const std::string& delimiter = "::");
 
 	/**
-	 * @brief Check if a word is present in text, ignoring case
+	 * @brief Split a string by a delimiter without copying
+	 * @param s Input string (the tokens view into it)
+	 * @param delimiter Delimiter string
+	 * @param tokens Output, cleared first so a buffer can be reused between lines
+	 */
+    void split_view(std::string_view s, std::string_view delimiter, std::vector<std::string_view>& tokens);
+
+	/**
+	 * @brief Split a string into a fixed number of fields without copying or allocating.
+	 *        The line is scanned once with SSE2/AVX2 block compares (scan_fields in simd.h).
+	 * @param s Input string (the fields view into it)
+	 * @param delimiter Delimiter string
+	 * @param fields Output slots
+	 * @return Number of fields in s; fields.size() + 1 means there were more than fit
+	 */
+    std::size_t split_fields(std::string_view s, std::string_view delimiter, std::span<std::string_view> fields);
+
+	/**
+	 * @brief Check if a word is one of the space-separated words of text, ignoring case and accents
 	 * @param text Input text
 	 * @param word Word to search for
 	 * @return True if the word is found, false otherwise
 	 */
-    bool case_insensitive_contains_word(const std::string& text, const std::string& word);
+    bool case_insensitive_contains_word(std::string_view text, std::string_view word);
+
+	/**
+	 * @brief Check if phrase words occur in order with at most slop other words in between (in total)
+	 * @param positions Ascending word positions of every phrase word, in phrase order
+	 * @param slop Number of extra words allowed inside the phrase (0: adjacent)
+	 * @return True if some occurrence of the first word starts a match
+	 */
+    bool positions_form_phrase(std::span<const std::vector<std::uint32_t>> positions, std::size_t slop);
+
+	/**
+	 * @brief Check if the space-separated words of text contain a phrase, ignoring case and accents
+	 * @param text Input text
+	 * @param words Phrase words, in order
+	 * @param slop Number of extra words allowed inside the phrase
+	 * @return True if the phrase is found
+	 */
+    bool contains_phrase(std::string_view text, std::span<const std::string> words, std::size_t slop);
 
 	/**
 	 * @brief Join a vector of strings into a single string
@@ -62,5 +102,6 @@ namespace shared::utils {
 	 * @return Concatenated string with delimiters
 	 */
     std::string join(const std::vector<std::string>& vec, const std::string& delimiter = "|");
+    std::string join(const std::pmr::vector<std::pmr::string>& vec, const std::string& delimiter = "|");
 
 }
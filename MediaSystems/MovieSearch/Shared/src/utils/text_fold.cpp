@@ -0,0 +1,214 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file text_fold.cpp
+ * @date 2025-10-04
+ */
+
+#include "text_fold.h"
+
+#include <cstdint>
+#include <iterator>
+
+namespace shared::utils {
+
+    namespace
+    {
+        // Folded form of U+00C0..U+024F (Latin-1 Supplement letters, Latin Extended-A/B); nullptr keeps the character.
+        constexpr const char* latin_folds[] = {
+            "a", "a", "a", "a", "a", "a", "ae", "c",  // U+00C0
+            "e", "e", "e", "e", "i", "i", "i", "i",  // U+00C8
+            "d", "n", "o", "o", "o", "o", "o", nullptr,  // U+00D0
+            "o", "u", "u", "u", "u", "y", "th", "ss",  // U+00D8
+            "a", "a", "a", "a", "a", "a", "ae", "c",  // U+00E0
+            "e", "e", "e", "e", "i", "i", "i", "i",  // U+00E8
+            "d", "n", "o", "o", "o", "o", "o", nullptr,  // U+00F0
+            "o", "u", "u", "u", "u", "y", "th", "y",  // U+00F8
+            "a", "a", "a", "a", "a", "a", "c", "c",  // U+0100
+            "c", "c", "c", "c", "c", "c", "d", "d",  // U+0108
+            "d", "d", "e", "e", "e", "e", "e", "e",  // U+0110
+            "e", "e", "e", "e", "g", "g", "g", "g",  // U+0118
+            "g", "g", "g", "g", "h", "h", "h", "h",  // U+0120
+            "i", "i", "i", "i", "i", "i", "i", "i",  // U+0128
+            "i", "i", "ij", "ij", "j", "j", "k", "k",  // U+0130
+            "k", "l", "l", "l", "l", "l", "l", "l",  // U+0138
+            "l", "l", "l", "n", "n", "n", "n", "n",  // U+0140
+            "n", "n", "n", "n", "o", "o", "o", "o",  // U+0148
+            "o", "o", "oe", "oe", "r", "r", "r", "r",  // U+0150
+            "r", "r", "s", "s", "s", "s", "s", "s",  // U+0158
+            "s", "s", "t", "t", "t", "t", "t", "t",  // U+0160
+            "u", "u", "u", "u", "u", "u", "u", "u",  // U+0168
+            "u", "u", "u", "u", "w", "w", "y", "y",  // U+0170
+            "y", "z", "z", "z", "z", "z", "z", "s",  // U+0178
+            "b", "b", "\xc6\x83", nullptr, "\xc6\x85", nullptr, "\xc9\x94", "c",  // U+0180
+            "c", "\xc9\x96", "\xc9\x97", "\xc6\x8c", nullptr, nullptr, "\xc7\x9d", "\xc9\x99",  // U+0188
+            "\xc9\x9b", "f", "f", "\xc9\xa0", "\xc9\xa3", nullptr, "\xc9\xa9", "\xc9\xa8",  // U+0190
+            "k", "k", "l", nullptr, "\xc9\xaf", "\xc9\xb2", "n", "\xc9\xb5",  // U+0198
+            "o", "o", "\xc6\xa3", nullptr, "p", "p", "\xca\x80", "\xc6\xa8",  // U+01A0
+            nullptr, "\xca\x83", nullptr, nullptr, "t", "t", "\xca\x88", "u",  // U+01A8
+            "u", "\xca\x8a", "\xca\x8b", "y", "y", "z", "z", "\xca\x92",  // U+01B0
+            "\xc6\xb9", nullptr, nullptr, nullptr, "\xc6\xbd", nullptr, nullptr, nullptr,  // U+01B8
+            nullptr, nullptr, nullptr, nullptr, "dz", "dz", "dz", "lj",  // U+01C0
+            "lj", "lj", "nj", "nj", "nj", "a", "a", "i",  // U+01C8
+            "i", "o", "o", "u", "u", "u", "u", "u",  // U+01D0
+            "u", "u", "u", "u", "u", nullptr, "a", "a",  // U+01D8
+            "a", "a", "ae", "ae", "g", "g", "g", "g",  // U+01E0
+            "k", "k", "o", "o", "o", "o", "\xc7\xaf", nullptr,  // U+01E8
+            "j", "dz", "dz", "dz", "g", "g", "\xc6\x95", "\xc6\xbf",  // U+01F0
+            "n", "n", "a", "a", "ae", "ae", "o", "o",  // U+01F8
+            "a", "a", "a", "a", "e", "e", "e", "e",  // U+0200
+            "i", "i", "i", "i", "o", "o", "o", "o",  // U+0208
+            "r", "r", "r", "r", "u", "u", "u", "u",  // U+0210
+            "s", "s", "t", "t", "\xc8\x9d", nullptr, "h", "h",  // U+0218
+            "n", nullptr, "\xc8\xa3", nullptr, "z", "z", "a", "a",  // U+0220
+            "e", "e", "o", "o", "o", "o", "o", "o",  // U+0228
+            "o", "o", "y", "y", nullptr, nullptr, nullptr, nullptr,  // U+0230
+            "db", "qp", "\xe2\xb1\xa5", "c", "c", "l", "\xe2\xb1\xa6", nullptr,  // U+0238
+            nullptr, "\xc9\x82", nullptr, "b", "\xca\x89", "\xca\x8c", "e", "e",  // U+0240
+            "j", "j", "\xc9\x8b", nullptr, "r", "r", "y", "y",  // U+0248
+        };
+
+        // Folded form of U+0370..U+045F (Greek and Coptic, Cyrillic); nullptr keeps the character.
+        constexpr const char* greek_cyrillic_folds[] = {
+            "\xcd\xb1", nullptr, "\xcd\xb3", nullptr, "\xca\xb9", nullptr, "\xcd\xb7", nullptr,  // U+0370
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, ";", "\xcf\xb3",  // U+0378
+            nullptr, nullptr, nullptr, nullptr, nullptr, "\xc2\xa8", "\xce\xb1", "\xc2\xb7",  // U+0380
+            "\xce\xb5", "\xce\xb7", "\xce\xb9", nullptr, "\xce\xbf", nullptr, "\xcf\x85", "\xcf\x89",  // U+0388
+            "\xce\xb9", "\xce\xb1", "\xce\xb2", "\xce\xb3", "\xce\xb4", "\xce\xb5", "\xce\xb6", "\xce\xb7",  // U+0390
+            "\xce\xb8", "\xce\xb9", "\xce\xba", "\xce\xbb", "\xce\xbc", "\xce\xbd", "\xce\xbe", "\xce\xbf",  // U+0398
+            "\xcf\x80", "\xcf\x81", nullptr, "\xcf\x83", "\xcf\x84", "\xcf\x85", "\xcf\x86", "\xcf\x87",  // U+03A0
+            "\xcf\x88", "\xcf\x89", "\xce\xb9", "\xcf\x85", "\xce\xb1", "\xce\xb5", "\xce\xb7", "\xce\xb9",  // U+03A8
+            "\xcf\x85", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,  // U+03B0
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,  // U+03B8
+            nullptr, nullptr, "\xcf\x83", nullptr, nullptr, nullptr, nullptr, nullptr,  // U+03C0
+            nullptr, nullptr, "\xce\xb9", "\xcf\x85", "\xce\xbf", "\xcf\x85", "\xcf\x89", "\xcf\x97",  // U+03C8
+            nullptr, nullptr, nullptr, "\xcf\x92", "\xcf\x92", nullptr, nullptr, nullptr,  // U+03D0
+            "\xcf\x99", nullptr, "\xcf\x9b", nullptr, "\xcf\x9d", nullptr, "\xcf\x9f", nullptr,  // U+03D8
+            "\xcf\xa1", nullptr, "\xcf\xa3", nullptr, "\xcf\xa5", nullptr, "\xcf\xa7", nullptr,  // U+03E0
+            "\xcf\xa9", nullptr, "\xcf\xab", nullptr, "\xcf\xad", nullptr, "\xcf\xaf", nullptr,  // U+03E8
+            nullptr, nullptr, nullptr, nullptr, "\xce\xb8", nullptr, nullptr, "\xcf\xb8",  // U+03F0
+            nullptr, "\xcf\xb2", "\xcf\xbb", nullptr, nullptr, "\xcd\xbb", "\xcd\xbc", "\xcd\xbd",  // U+03F8
+            "\xd0\xb5", "\xd0\xb5", "\xd1\x92", "\xd0\xb3", "\xd1\x94", "\xd1\x95", "\xd1\x96", "\xd1\x96",  // U+0400
+            "\xd1\x98", "\xd1\x99", "\xd1\x9a", "\xd1\x9b", "\xd0\xba", "\xd0\xb8", "\xd1\x83", "\xd1\x9f",  // U+0408
+            "\xd0\xb0", "\xd0\xb1", "\xd0\xb2", "\xd0\xb3", "\xd0\xb4", "\xd0\xb5", "\xd0\xb6", "\xd0\xb7",  // U+0410
+            "\xd0\xb8", "\xd0\xb9", "\xd0\xba", "\xd0\xbb", "\xd0\xbc", "\xd0\xbd", "\xd0\xbe", "\xd0\xbf",  // U+0418
+            "\xd1\x80", "\xd1\x81", "\xd1\x82", "\xd1\x83", "\xd1\x84", "\xd1\x85", "\xd1\x86", "\xd1\x87",  // U+0420
+            "\xd1\x88", "\xd1\x89", "\xd1\x8a", "\xd1\x8b", "\xd1\x8c", "\xd1\x8d", "\xd1\x8e", "\xd1\x8f",  // U+0428
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,  // U+0430
+            nullptr, "\xd0\xb9", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,  // U+0438
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,  // U+0440
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,  // U+0448
+            "\xd0\xb5", "\xd0\xb5", nullptr, "\xd0\xb3", nullptr, nullptr, nullptr, "\xd1\x96",  // U+0450
+            nullptr, nullptr, nullptr, nullptr, "\xd0\xba", "\xd0\xb8", "\xd1\x83", nullptr,  // U+0458
+        };
+
+        constexpr std::uint32_t latin_first = 0x00C0;
+        constexpr std::uint32_t greek_cyrillic_first = 0x0370;
+        static_assert(std::size(latin_folds) == 0x0250 - latin_first);
+        static_assert(std::size(greek_cyrillic_folds) == 0x0460 - greek_cyrillic_first);
+
+        // One lowercase character per ASCII byte.
+        constexpr std::array<char, 128> make_ascii_folds() {
+            std::array<char, 128> folds{};
+            for (std::size_t c = 0; c < folds.size(); ++c) {
+                folds[c] = static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+            }
+            return folds;
+        }
+        constexpr auto ascii_folds = make_ascii_folds();
+
+        bool is_continuation(unsigned char byte) { return (byte & 0xC0) == 0x80; }
+
+        // Length of the UTF-8 sequence at pos, or 1 when it is malformed.
+        std::size_t sequence_length(std::string_view text, std::size_t pos) {
+            const auto lead = static_cast<unsigned char>(text[pos]);
+            const std::size_t length = lead >= 0xF0 && lead <= 0xF4 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 && lead <= 0xDF ? 2 : 1;
+            if (length == 1 || pos + length > text.size()) return 1;
+            for (std::size_t i = 1; i < length; ++i) {
+                if (!is_continuation(static_cast<unsigned char>(text[pos + i]))) return 1;
+            }
+            return length;
+        }
+
+        // Pulls folded bytes of a text one at a time.
+        struct FoldCursor {
+            explicit FoldCursor(std::string_view text) : text(text) {}
+
+            std::string_view text;
+            std::size_t pos = 0;
+            std::string_view piece;
+            std::size_t offset = 0;
+
+            bool next(char& c) {
+                while (offset == piece.size()) {
+                    if (pos >= text.size()) return false;
+                    piece = fold_next(text, pos);
+                    offset = 0;
+                }
+                c = piece[offset++];
+                return true;
+            }
+        };
+    }
+
+    std::string_view fold_next(std::string_view text, std::size_t& pos) {
+        const auto lead = static_cast<unsigned char>(text[pos]);
+        if (lead < 0x80) {
+            ++pos;
+            return std::string_view(&ascii_folds[lead], 1);
+        }
+
+        const auto start = pos;
+        const auto length = sequence_length(text, pos);
+        pos += length;
+        if (length != 2) return text.substr(start, length);
+
+        const auto code_point = (static_cast<std::uint32_t>(lead & 0x1F) << 6) | (static_cast<unsigned char>(text[start + 1]) & 0x3F);
+        const char* folded = nullptr;
+        if (code_point >= 0x0300 && code_point < 0x0370) return {};   // combining diacritical mark
+        if (code_point >= latin_first && code_point < latin_first + std::size(latin_folds)) {
+            folded = latin_folds[code_point - latin_first];
+        }
+        else if (code_point >= greek_cyrillic_first && code_point < greek_cyrillic_first + std::size(greek_cyrillic_folds)) {
+            folded = greek_cyrillic_folds[code_point - greek_cyrillic_first];
+        }
+        return folded ? std::string_view(folded) : text.substr(start, length);
+    }
+
+    void append_folded(std::string_view text, std::string& out) {
+        for (std::size_t pos = 0; pos < text.size();) out += fold_next(text, pos);
+    }
+
+    std::string fold_text(std::string_view text) {
+        std::string folded;
+        folded.reserve(text.size());
+        append_folded(text, folded);
+        return folded;
+    }
+
+    bool folded_equal(std::string_view a, std::string_view b) {
+        FoldCursor left(a);
+        FoldCursor right(b);
+        char x = 0;
+        char y = 0;
+        while (true) {
+            const bool has_left = left.next(x);
+            const bool has_right = right.next(y);
+            if (!has_left || !has_right) return has_left == has_right;
+            if (x != y) return false;
+        }
+    }
+
+    FoldedWord::FoldedWord(std::string_view word) {
+        for (std::size_t pos = 0; pos < word.size();) {
+            const auto piece = fold_next(word, pos);
+            if (overflow_.empty() && size_ + piece.size() <= buffer_.size()) {
+                piece.copy(buffer_.data() + size_, piece.size());
+                size_ += piece.size();
+                continue;
+            }
+            if (overflow_.empty()) overflow_.assign(buffer_.data(), size_);
+            overflow_ += piece;
+        }
+    }
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file text_fold.h
+ * @date 2025-10-04
+ */
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace shared::utils {
+
+    /**
+     * @brief Folded form of the UTF-8 character at pos; advances pos past it.
+     *
+     * Folding lowercases and strips diacritics with lookup tables: ASCII, Latin-1 Supplement and
+     * Latin Extended-A/B ("É" -> "e", "ß" -> "ss", "Æ" -> "ae"), Greek and Cyrillic ("Ά" -> "α",
+     * "Ё" -> "е"). Combining marks (U+0300..U+036F) fold to nothing. Other characters, and bytes
+     * that are not valid UTF-8, are returned unchanged.
+     *
+     * @param text UTF-8 text
+     * @param pos Position of a character in text, moved to the next one
+     * @return View into a static table or into text
+     */
+    std::string_view fold_next(std::string_view text, std::size_t& pos);
+
+    /**
+     * @brief Append the folded form of text to out
+     */
+    void append_folded(std::string_view text, std::string& out);
+
+    /**
+     * @brief Folded copy of text
+     */
+    std::string fold_text(std::string_view text);
+
+    /**
+     * @brief Compare two texts after folding, without building folded copies
+     * @return True if fold_text(a) == fold_text(b)
+     */
+    bool folded_equal(std::string_view a, std::string_view b);
+
+    /**
+     * @brief The folded form of a short query word, kept on the stack.
+     *
+     * Words up to inline_capacity folded bytes never allocate; longer ones fall back to a string.
+     */
+    class FoldedWord {
+    public:
+        static constexpr std::size_t inline_capacity = 64;
+
+        explicit FoldedWord(std::string_view word);
+
+        std::string_view view() const { return overflow_.empty() ? std::string_view(buffer_.data(), size_) : std::string_view(overflow_); }
+
+    private:
+        std::array<char, inline_capacity> buffer_;
+        std::size_t size_ = 0;
+        std::string overflow_;
+    };
+
+}
@@ -0,0 +1,79 @@
+/**
+ * author Yme Brugts (s4536622)
+ * @file thread_pool.cpp
+ * @date 2025-10-04
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace shared::utils {
+
+    namespace
+    {
+        bool finished(const std::shared_future<void>& task) {
+            return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+    }
+
+    ThreadPool::ThreadPool(std::size_t threads) {
+        if (!threads) threads = std::max(std::thread::hardware_concurrency(), 1u);
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) workers_.emplace_back([this] { run(); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    std::shared_future<void> ThreadPool::submit(std::function<void()> work, std::vector<std::shared_future<void>> after) {
+        // The prerequisites are finished when this runs; get() hands on their failure
+        std::packaged_task<void()> task([work = std::move(work), after] {
+            for (const auto& prerequisite : after) prerequisite.get();
+            work();
+        });
+        auto future = task.get_future().share();
+        {
+            std::lock_guard lock(mutex_);
+            if (std::all_of(after.begin(), after.end(), finished)) queue_.push_back(std::move(task));
+            else parked_.push_back({ std::move(task), std::move(after) });
+        }
+        wake_.notify_one();
+        return future;
+    }
+
+    void ThreadPool::release_ready() {
+        const auto ready = std::stable_partition(parked_.begin(), parked_.end(), [](const Parked& parked) {
+            return !std::all_of(parked.after.begin(), parked.after.end(), finished);
+        });
+        for (auto it = ready; it != parked_.end(); ++it) queue_.push_back(std::move(it->task));
+        parked_.erase(ready, parked_.end());
+    }
+
+    void ThreadPool::run() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return !queue_.empty() || (stopping_ && parked_.empty()); });
+            if (queue_.empty()) return;
+
+            auto task = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+
+            // A finished task may be the last prerequisite of parked ones
+            const auto queued = queue_.size();
+            release_ready();
+            if (queue_.size() > queued || (stopping_ && parked_.empty())) wake_.notify_all();
+        }
+    }
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+/**
+ * author Yme Brugts (s4536622)
+ * @file thread_pool.h
+ * @date 2025-10-04
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace shared::utils {
+
+    /**
+     * @brief Fixed set of worker threads running submitted tasks, optionally after other tasks.
+     *
+     * A task submitted with prerequisites is parked until all of them have finished and only then
+     * queued, so a worker never blocks on an input that is still being built. If a prerequisite
+     * threw, the task does not run and its future rethrows that exception. Prerequisites must be
+     * futures returned by the same pool.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @param threads Worker threads (0 = std::thread::hardware_concurrency())
+         */
+        explicit ThreadPool(std::size_t threads = 0);
+
+        // Runs every submitted task (parked ones included), then joins the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Run work on a worker once every task in after has finished
+         * @param work The task
+         * @param after Prerequisites (futures of earlier submits)
+         * @return Future of the task; get() rethrows what the task (or a prerequisite) threw
+         */
+        std::shared_future<void> submit(std::function<void()> work, std::vector<std::shared_future<void>> after = {});
+
+        std::size_t size() const { return workers_.size(); }
+
+    private:
+        struct Parked {
+            std::packaged_task<void()> task;
+            std::vector<std::shared_future<void>> after;
+        };
+
+        void run();
+        void release_ready();   // queue the parked tasks whose prerequisites finished (mutex_ held)
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<std::packaged_task<void()>> queue_;
+        std::vector<Parked> parked_;
+        bool stopping_ = false;
+        std::vector<std::thread> workers_;
+    };
+
+}